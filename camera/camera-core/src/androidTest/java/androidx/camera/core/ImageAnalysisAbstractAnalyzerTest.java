@@ -50,7 +50,6 @@ import org.junit.Test;
 import org.junit.runner.RunWith;
 import org.mockito.ArgumentCaptor;
 
-import java.nio.ByteBuffer;
 import java.util.concurrent.ExecutionException;
 import java.util.concurrent.Executor;
 
@@ -218,10 +217,6 @@ public class ImageAnalysisAbstractAnalyzerTest {
         assertThat(imageProxyArgumentCaptor.getValue().getImageInfo()
                 .getSensorToBufferTransformMatrix()).isEqualTo(target);
 
-        assertThat(mImageAnalysisAbstractAnalyzer.getRGBConverterBuffer()).isNull();
-        assertThat(mImageAnalysisAbstractAnalyzer.getYRotatedBuffer()).isNotNull();
-        assertThat(mImageAnalysisAbstractAnalyzer.getURotatedBuffer()).isNotNull();
-        assertThat(mImageAnalysisAbstractAnalyzer.getVRotatedBuffer()).isNotNull();
     }
 
     @SdkSuppress(maxSdkVersion = 22, minSdkVersion = 21)
@@ -249,10 +244,6 @@ public class ImageAnalysisAbstractAnalyzerTest {
         assertThat(imageProxyArgumentCaptor.getValue().getImageInfo()
                 .getSensorToBufferTransformMatrix()).isEqualTo(original);
 
-        assertThat(mImageAnalysisAbstractAnalyzer.getRGBConverterBuffer()).isNull();
-        assertThat(mImageAnalysisAbstractAnalyzer.getYRotatedBuffer()).isNotNull();
-        assertThat(mImageAnalysisAbstractAnalyzer.getURotatedBuffer()).isNotNull();
-        assertThat(mImageAnalysisAbstractAnalyzer.getVRotatedBuffer()).isNotNull();
     }
 
     @Test
@@ -285,10 +276,6 @@ public class ImageAnalysisAbstractAnalyzerTest {
         assertThat(imageProxyArgumentCaptor.getValue().getCropRect())
                 .isEqualTo(new Rect(0, 0, HEIGHT, WIDTH));
 
-        assertThat(mImageAnalysisAbstractAnalyzer.getRGBConverterBuffer()).isNotNull();
-        assertThat(mImageAnalysisAbstractAnalyzer.getYRotatedBuffer()).isNull();
-        assertThat(mImageAnalysisAbstractAnalyzer.getURotatedBuffer()).isNull();
-        assertThat(mImageAnalysisAbstractAnalyzer.getVRotatedBuffer()).isNull();
     }
 
     @SdkSuppress(minSdkVersion = 23)
@@ -383,10 +370,6 @@ public class ImageAnalysisAbstractAnalyzerTest {
                 mImageAnalysisAbstractAnalyzer.analyzeImage(mImageProxy);
         result.get();
 
-        assertThat(mImageAnalysisAbstractAnalyzer.getRGBConverterBuffer()).isNull();
-        assertThat(mImageAnalysisAbstractAnalyzer.getYRotatedBuffer()).isNull();
-        assertThat(mImageAnalysisAbstractAnalyzer.getURotatedBuffer()).isNull();
-        assertThat(mImageAnalysisAbstractAnalyzer.getVRotatedBuffer()).isNull();
     }
 
     @Test
@@ -404,10 +387,6 @@ public class ImageAnalysisAbstractAnalyzerTest {
                 mImageAnalysisAbstractAnalyzer.analyzeImage(mImageProxy);
         result.get();
 
-        assertThat(mImageAnalysisAbstractAnalyzer.getRGBConverterBuffer()).isNull();
-        assertThat(mImageAnalysisAbstractAnalyzer.getYRotatedBuffer()).isNull();
-        assertThat(mImageAnalysisAbstractAnalyzer.getURotatedBuffer()).isNull();
-        assertThat(mImageAnalysisAbstractAnalyzer.getVRotatedBuffer()).isNull();
     }
 
     @Test
@@ -546,25 +525,5 @@ public class ImageAnalysisAbstractAnalyzerTest {
         void setRelativeRotation(int relativeRotation) {
             mImageAnalysisNonBlockingAnalyzer.setRelativeRotation(relativeRotation);
         }
-
-        @Nullable
-        ByteBuffer getRGBConverterBuffer() {
-            return mImageAnalysisNonBlockingAnalyzer.mRGBConvertedBuffer;
-        }
-
-        @Nullable
-        ByteBuffer getYRotatedBuffer() {
-            return mImageAnalysisNonBlockingAnalyzer.mYRotatedBuffer;
-        }
-
-        @Nullable
-        ByteBuffer getURotatedBuffer() {
-            return mImageAnalysisNonBlockingAnalyzer.mURotatedBuffer;
-        }
-
-        @Nullable
-        ByteBuffer getVRotatedBuffer() {
-            return mImageAnalysisNonBlockingAnalyzer.mVRotatedBuffer;
-        }
     }
 }
@@ -52,6 +52,7 @@ import java.io.ByteArrayOutputStream;
 import java.io.IOException;
 import java.nio.ByteBuffer;
 import java.nio.IntBuffer;
+import java.util.Locale;
 
 /**
  * Unit test for {@link ImageProcessingUtil}.
@@ -72,15 +73,31 @@ public class ImageProcessingUtilTest {
 
     private static final int PADDING_BYTES = 16;
 
-    private ByteBuffer mRgbConvertedBuffer;
-    private ByteBuffer mYRotatedBuffer;
-    private ByteBuffer mURotatedBuffer;
-    private ByteBuffer mVRotatedBuffer;
+    // Size of the frames whose content is checked after rotation. The width is not a multiple of
+    // the 64 pixel wide tiles used to rotate by 90 and 270 degrees, nor the height of the 128 row
+    // tall ones, so that partial tiles are rotated as well.
+    private static final int TILED_WIDTH = 200;
+    private static final int TILED_HEIGHT = 132;
+
+    // Size of the frames large enough to be processed in parallel bands of rows, and number of
+    // rows of the strips small enough to be processed in a single band.
+    private static final int LARGE_WIDTH = 1920;
+    private static final int LARGE_HEIGHT = 1080;
+    private static final int SINGLE_BAND_ROWS = 360;
+
     private static final int[] YUV_WHITE_STUDIO_SWING_BT601 = {/*y=*/235, /*u=*/128, /*v=*/128};
     private static final int[] YUV_BLACK_STUDIO_SWING_BT601 = {/*y=*/16, /*u=*/128, /*v=*/128};
     private static final int[] YUV_BLUE_STUDIO_SWING_BT601 = {/*y=*/16, /*u=*/240, /*v=*/128};
     private static final int[] YUV_RED_STUDIO_SWING_BT601 = {/*y=*/16, /*u=*/128, /*v=*/240};
 
+    // Layouts of the U and V planes of the destination of a YUV rotation
+    private enum ChromaLayout {
+        I420,
+        NV12,
+        NV21,
+        PIXEL_STRIDE_3
+    }
+
     private FakeImageProxy mYUVImageProxy;
     private SafeCloseImageReaderProxy mRGBImageReaderProxy;
     private SafeCloseImageReaderProxy mRotatedRGBImageReaderProxy;
@@ -124,10 +141,6 @@ public class ImageProcessingUtilTest {
                         ImageFormat.JPEG,
                         MAX_IMAGES));
 
-        mRgbConvertedBuffer = ByteBuffer.allocateDirect(WIDTH * HEIGHT * 4);
-        mYRotatedBuffer = ByteBuffer.allocateDirect(WIDTH * HEIGHT);
-        mURotatedBuffer = ByteBuffer.allocateDirect(WIDTH * HEIGHT / 2);
-        mVRotatedBuffer = ByteBuffer.allocateDirect(WIDTH * HEIGHT / 2);
     }
 
     @After
@@ -244,7 +257,6 @@ public class ImageProcessingUtilTest {
         ImageProxy rgbImageProxy = ImageProcessingUtil.convertYUVToRGB(
                 mYUVImageProxy,
                 mRGBImageReaderProxy,
-                mRgbConvertedBuffer,
                 /*rotation=*/0,
                 /*onePixelShiftRequested=*/false);
 
@@ -269,7 +281,6 @@ public class ImageProcessingUtilTest {
         ImageProxy rgbImageProxy = ImageProcessingUtil.convertYUVToRGB(
                 mYUVImageProxy,
                 mRGBImageReaderProxy,
-                mRgbConvertedBuffer,
                 /*rotation=*/0,
                 /*onePixelShiftRequested=*/false);
 
@@ -294,7 +305,6 @@ public class ImageProcessingUtilTest {
         ImageProxy rgbImageProxy = ImageProcessingUtil.convertYUVToRGB(
                 mYUVImageProxy,
                 mRGBImageReaderProxy,
-                mRgbConvertedBuffer,
                 /*rotation=*/0,
                 /*onePixelShiftRequested=*/false);
 
@@ -345,7 +355,6 @@ public class ImageProcessingUtilTest {
         ImageProxy rgbImageProxy = ImageProcessingUtil.convertYUVToRGB(
                 mYUVImageProxy,
                 mRGBImageReaderProxy,
-                mRgbConvertedBuffer,
                 /*rotation=*/0,
                 /*onePixelShiftRequested=*/false);
 
@@ -374,7 +383,6 @@ public class ImageProcessingUtilTest {
         ImageProxy rgbImageProxy = ImageProcessingUtil.convertYUVToRGB(
                 mYUVImageProxy,
                 mRotatedRGBImageReaderProxy,
-                mRgbConvertedBuffer,
                 /*rotation=*/90,
                 /*onePixelShiftRequested=*/false);
 
@@ -386,6 +394,22 @@ public class ImageProcessingUtilTest {
         rgbImageProxy.close();
     }
 
+    @Test
+    public void rotateRGB_matchesConvertedThenRotatedImage() {
+        for (int rotation : new int[]{90, 180, 270}) {
+            assertRotatedRGBMatchesReference(TILED_WIDTH, TILED_HEIGHT, rotation,
+                    /*onePixelShiftRequested=*/false);
+        }
+    }
+
+    @Test
+    public void rotateRGB_withOnePixelShift_matchesConvertedThenRotatedImage() {
+        for (int rotation : new int[]{90, 180, 270}) {
+            assertRotatedRGBMatchesReference(TILED_WIDTH, TILED_HEIGHT, rotation,
+                    /*onePixelShiftRequested=*/true);
+        }
+    }
+
     @SdkSuppress(minSdkVersion = 23)
     @Test
     public void rotateYUV_imageRotated() {
@@ -405,9 +429,6 @@ public class ImageProcessingUtilTest {
                 ImageWriter.newInstance(
                         mRotatedYUVImageReaderProxy.getSurface(),
                         mRotatedYUVImageReaderProxy.getMaxImages()),
-                mYRotatedBuffer,
-                mURotatedBuffer,
-                mVRotatedBuffer,
                 /*rotation=*/90);
 
         // Assert.
@@ -419,6 +440,42 @@ public class ImageProcessingUtilTest {
         yuvImageProxy.close();
     }
 
+    @Test
+    public void rotateYUV_matchesRotatedPlanesForEachDestinationLayout() {
+        for (int rotation : new int[]{90, 180, 270}) {
+            for (ChromaLayout layout : ChromaLayout.values()) {
+                assertRotatedYUVMatchesReference(TILED_WIDTH, TILED_HEIGHT, rotation, layout);
+            }
+        }
+    }
+
+    @Test
+    public void rotateYUV_largeFrame_matchesRotatedPlanes() {
+        // Frames this large are rotated in bands of rows on several threads.
+        for (int rotation : new int[]{90, 180, 270}) {
+            assertRotatedYUVMatchesReference(LARGE_WIDTH, LARGE_HEIGHT, rotation,
+                    ChromaLayout.I420);
+            assertRotatedYUVMatchesReference(LARGE_WIDTH, LARGE_HEIGHT, rotation,
+                    ChromaLayout.NV21);
+        }
+    }
+
+    @Test
+    public void convertYUVToRGB_largeFrame_matchesConversionInSingleBands() {
+        // Frames this large are converted in bands of rows on several threads, while the strips
+        // of the reference are small enough to be converted in a single band.
+        ImageProxy.PlaneProxy[] planes = createPatternYUV420ImagePlanes(LARGE_WIDTH, LARGE_HEIGHT);
+        int[] converted = convertYUVToRGBPixelsInStrips(planes, LARGE_WIDTH, LARGE_HEIGHT);
+        for (int rotation : new int[]{0, 90, 180, 270}) {
+            assertPixelsEqual(
+                    rotatePixels(converted, LARGE_WIDTH, LARGE_HEIGHT, rotation),
+                    convertYUVToRGBPixels(planes, LARGE_WIDTH, LARGE_HEIGHT, rotation,
+                            /*onePixelShiftRequested=*/false),
+                    rotation % 180 == 0 ? LARGE_WIDTH : LARGE_HEIGHT,
+                    "rotation " + rotation);
+        }
+    }
+
     @Test
     public void yuvToRGBUsesBT601FullSwing() {
         // Check that studio swing YUV colors do not scale to full range RGB colors
@@ -489,7 +546,6 @@ public class ImageProcessingUtilTest {
         try (ImageProxy rgbImageProxy = ImageProcessingUtil.convertYUVToRGB(
                 yuvImageProxy,
                 mRGBImageReaderProxy,
-                mRgbConvertedBuffer,
                 /*rotation=*/0,
                 /*onePixelShiftRequested=*/false)) {
             assertRGBImageProxyColor(rgbImageProxy, referenceColorRgb);
@@ -594,6 +650,281 @@ public class ImageProcessingUtilTest {
         }
     }
 
+    /**
+     * Asserts that converting and rotating an image in a single pass gives the same pixels as
+     * converting it without rotation, which libyuv does in a single call, then rotating the
+     * converted pixels as {@code ARGBRotate} does.
+     */
+    private static void assertRotatedRGBMatchesReference(int width, int height, int rotation,
+            boolean onePixelShiftRequested) {
+        ImageProxy.PlaneProxy[] planes = createPatternYUV420ImagePlanes(width, height);
+        int[] expected = rotatePixels(
+                convertYUVToRGBPixels(planes, width, height, 0, onePixelShiftRequested),
+                width, height, rotation);
+        int[] actual = convertYUVToRGBPixels(planes, width, height, rotation,
+                onePixelShiftRequested);
+        assertPixelsEqual(expected, actual, rotation % 180 == 0 ? width : height,
+                "rotation " + rotation + ", one pixel shift " + onePixelShiftRequested);
+    }
+
+    /**
+     * Asserts that rotating the planes of an image with nativeRotateYUV, into destination planes
+     * of the given chroma layout, gives the source planes rotated as libyuv I420Rotate does.
+     */
+    private static void assertRotatedYUVMatchesReference(int width, int height, int rotation,
+            @NonNull ChromaLayout layout) {
+        ImageProxy.PlaneProxy[] srcPlanes = createPatternYUV420ImagePlanes(width, height);
+        boolean swapSize = rotation % 180 != 0;
+        int dstWidth = swapSize ? height : width;
+        int dstHeight = swapSize ? width : height;
+        ImageProxy.PlaneProxy[] dstPlanes =
+                createYUV420DestinationPlanes(dstWidth, dstHeight, layout);
+        int result = ImageProcessingUtil.nativeRotateYUV(
+                srcPlanes[0].getBuffer(),
+                srcPlanes[0].getRowStride(),
+                srcPlanes[1].getBuffer(),
+                srcPlanes[1].getRowStride(),
+                srcPlanes[2].getBuffer(),
+                srcPlanes[2].getRowStride(),
+                srcPlanes[1].getPixelStride(),
+                dstPlanes[0].getBuffer(),
+                dstPlanes[0].getRowStride(),
+                dstPlanes[0].getPixelStride(),
+                dstPlanes[1].getBuffer(),
+                dstPlanes[1].getRowStride(),
+                dstPlanes[1].getPixelStride(),
+                dstPlanes[2].getBuffer(),
+                dstPlanes[2].getRowStride(),
+                dstPlanes[2].getPixelStride(),
+                width,
+                height,
+                rotation);
+        assertThat(result).isEqualTo(0);
+
+        for (int i = 0; i < 3; i++) {
+            int shift = i == 0 ? 0 : 1;
+            int planeWidth = (width + shift) >> shift;
+            int planeHeight = (height + shift) >> shift;
+            int rotatedWidth = (dstWidth + shift) >> shift;
+            int rotatedHeight = (dstHeight + shift) >> shift;
+            assertPixelsEqual(
+                    rotatePixels(readPlane(srcPlanes[i], planeWidth, planeHeight), planeWidth,
+                            planeHeight, rotation),
+                    readPlane(dstPlanes[i], rotatedWidth, rotatedHeight),
+                    rotatedWidth,
+                    "plane " + i + ", rotation " + rotation + ", " + layout);
+        }
+    }
+
+    /**
+     * Converts an image without rotation in strips of {@link #SINGLE_BAND_ROWS} rows, each of
+     * which is converted as a single band.
+     */
+    @NonNull
+    private static int[] convertYUVToRGBPixelsInStrips(@NonNull ImageProxy.PlaneProxy[] planes,
+            int width, int height) {
+        int[] pixels = new int[width * height];
+        for (int y = 0; y < height; y += SINGLE_BAND_ROWS) {
+            int rows = Math.min(SINGLE_BAND_ROWS, height - y);
+            ImageProxy.PlaneProxy[] strip = new ImageProxy.PlaneProxy[3];
+            for (int i = 0; i < 3; i++) {
+                int stripY = i == 0 ? y : y / 2;
+                ByteBuffer buffer = planes[i].getBuffer().duplicate();
+                buffer.position(stripY * planes[i].getRowStride());
+                strip[i] = createPlane(buffer.slice(), planes[i].getRowStride(),
+                        planes[i].getPixelStride());
+            }
+            int[] stripPixels = convertYUVToRGBPixels(strip, width, rows, 0,
+                    /*onePixelShiftRequested=*/false);
+            System.arraycopy(stripPixels, 0, pixels, y * width, stripPixels.length);
+        }
+        return pixels;
+    }
+
+    @NonNull
+    private static int[] convertYUVToRGBPixels(@NonNull ImageProxy.PlaneProxy[] planes, int width,
+            int height, int rotation, boolean onePixelShiftRequested) {
+        FakeImageProxy yuvImageProxy = new FakeImageProxy(new FakeImageInfo());
+        yuvImageProxy.setWidth(width);
+        yuvImageProxy.setHeight(height);
+        yuvImageProxy.setFormat(ImageFormat.YUV_420_888);
+        yuvImageProxy.setPlanes(planes);
+
+        boolean swapSize = rotation % 180 != 0;
+        SafeCloseImageReaderProxy rgbImageReaderProxy = new SafeCloseImageReaderProxy(
+                ImageReaderProxys.createIsolatedReader(
+                        swapSize ? height : width,
+                        swapSize ? width : height,
+                        PixelFormat.RGBA_8888,
+                        MAX_IMAGES));
+        try (ImageProxy rgbImageProxy = ImageProcessingUtil.convertYUVToRGB(
+                yuvImageProxy,
+                rgbImageReaderProxy,
+                rotation,
+                onePixelShiftRequested)) {
+            assertThat(rgbImageProxy).isNotNull();
+            return readPixels(rgbImageProxy);
+        } finally {
+            rgbImageReaderProxy.safeClose();
+        }
+    }
+
+    /**
+     * Creates planar YUV 420 planes, with padded rows, whose samples vary along both axes so that
+     * any misplaced pixel or chroma sample changes the converted image.
+     */
+    @NonNull
+    private static ImageProxy.PlaneProxy[] createPatternYUV420ImagePlanes(int width, int height) {
+        int chromaWidth = (width + 1) / 2;
+        int chromaHeight = (height + 1) / 2;
+        return new ImageProxy.PlaneProxy[]{
+                createPatternPlane(width, height, 7, 13, 0),
+                createPatternPlane(chromaWidth, chromaHeight, 3, 5, 64),
+                createPatternPlane(chromaWidth, chromaHeight, 11, 2, 128)};
+    }
+
+    @NonNull
+    private static ImageProxy.PlaneProxy createPatternPlane(int width, int height, int stepX,
+            int stepY, int offset) {
+        int rowStride = width + PADDING_BYTES;
+        ByteBuffer buffer = ByteBuffer.allocateDirect(rowStride * height);
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                buffer.put(y * rowStride + x, (byte) (x * stepX + y * stepY + offset));
+            }
+        }
+        return createPlane(buffer, rowStride, 1);
+    }
+
+    /** Creates empty YUV 420 planes, with padded rows, whose chroma planes have the layout. */
+    @NonNull
+    private static ImageProxy.PlaneProxy[] createYUV420DestinationPlanes(int width, int height,
+            @NonNull ChromaLayout layout) {
+        int chromaWidth = (width + 1) / 2;
+        int chromaHeight = (height + 1) / 2;
+        ImageProxy.PlaneProxy planeY = createPlane(
+                ByteBuffer.allocateDirect((width + PADDING_BYTES) * height),
+                width + PADDING_BYTES, 1);
+        switch (layout) {
+            case NV12:
+            case NV21: {
+                int rowStride = chromaWidth * 2 + PADDING_BYTES;
+                ByteBuffer buffer = ByteBuffer.allocateDirect(rowStride * chromaHeight);
+                ByteBuffer first = buffer.duplicate();
+                buffer.position(1);
+                ByteBuffer second = buffer.slice();
+                ImageProxy.PlaneProxy planeFirst = createPlane(first, rowStride, 2);
+                ImageProxy.PlaneProxy planeSecond = createPlane(second, rowStride, 2);
+                return layout == ChromaLayout.NV12
+                        ? new ImageProxy.PlaneProxy[]{planeY, planeFirst, planeSecond}
+                        : new ImageProxy.PlaneProxy[]{planeY, planeSecond, planeFirst};
+            }
+            default: {
+                int pixelStride = layout == ChromaLayout.I420 ? 1 : 3;
+                int rowStride = chromaWidth * pixelStride + PADDING_BYTES;
+                return new ImageProxy.PlaneProxy[]{
+                        planeY,
+                        createPlane(ByteBuffer.allocateDirect(rowStride * chromaHeight),
+                                rowStride, pixelStride),
+                        createPlane(ByteBuffer.allocateDirect(rowStride * chromaHeight),
+                                rowStride, pixelStride)};
+            }
+        }
+    }
+
+    @NonNull
+    private static ImageProxy.PlaneProxy createPlane(@NonNull ByteBuffer buffer, int rowStride,
+            int pixelStride) {
+        return new ImageProxy.PlaneProxy() {
+            @Override
+            public int getRowStride() {
+                return rowStride;
+            }
+
+            @Override
+            public int getPixelStride() {
+                return pixelStride;
+            }
+
+            @Override
+            @NonNull
+            public ByteBuffer getBuffer() {
+                return buffer;
+            }
+        };
+    }
+
+    /** Returns the samples of a width x height plane, without its padding. */
+    @NonNull
+    private static int[] readPlane(@NonNull ImageProxy.PlaneProxy plane, int width, int height) {
+        ByteBuffer buffer = plane.getBuffer();
+        int[] samples = new int[width * height];
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                samples[y * width + x] =
+                        buffer.get(y * plane.getRowStride() + x * plane.getPixelStride()) & 0xFF;
+            }
+        }
+        return samples;
+    }
+
+    /** Returns the pixels of an RGBA image, without the padding of its rows. */
+    @NonNull
+    private static int[] readPixels(@NonNull ImageProxy rgbImageProxy) {
+        ImageProxy.PlaneProxy plane = rgbImageProxy.getPlanes()[0];
+        ByteBuffer buffer = plane.getBuffer();
+        int width = rgbImageProxy.getWidth();
+        int height = rgbImageProxy.getHeight();
+        int[] pixels = new int[width * height];
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                pixels[y * width + x] =
+                        buffer.getInt(y * plane.getRowStride() + x * plane.getPixelStride());
+            }
+        }
+        return pixels;
+    }
+
+    /** Rotates the pixels of a width x height image clockwise, as libyuv does. */
+    @NonNull
+    private static int[] rotatePixels(@NonNull int[] pixels, int width, int height,
+            int rotation) {
+        int[] rotated = new int[pixels.length];
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                int pixel = pixels[y * width + x];
+                switch (rotation) {
+                    case 90:
+                        rotated[x * height + (height - 1 - y)] = pixel;
+                        break;
+                    case 180:
+                        rotated[(height - 1 - y) * width + (width - 1 - x)] = pixel;
+                        break;
+                    case 270:
+                        rotated[(width - 1 - x) * height + y] = pixel;
+                        break;
+                    default:
+                        rotated[y * width + x] = pixel;
+                        break;
+                }
+            }
+        }
+        return rotated;
+    }
+
+    private static void assertPixelsEqual(@NonNull int[] expected, @NonNull int[] actual,
+            int width, @NonNull String description) {
+        assertThat(actual.length).isEqualTo(expected.length);
+        for (int i = 0; i < expected.length; i++) {
+            if (expected[i] != actual[i]) {
+                assertWithMessage(String.format(Locale.US,
+                        "Pixel at col %d, row %d differs (%s)", i % width, i / width, description)
+                ).that(String.format("#%08X", actual[i]))
+                        .isEqualTo(String.format("#%08X", expected[i]));
+            }
+        }
+    }
+
     private static int yuvBt601FullSwingToRGB(
             @IntRange(from = 0, to = 255) int y,
             @IntRange(from = 0, to = 255) int u,
@@ -37,7 +37,6 @@ import androidx.testutils.assertThrows
 import com.google.common.truth.Truth
 import com.google.common.truth.Truth.assertThat
 import java.io.ByteArrayOutputStream
-import java.nio.ByteBuffer
 import org.junit.Test
 import org.junit.runner.RunWith
 
@@ -170,7 +169,6 @@ class ImageUtilDeviceTest {
                     HEIGHT,
                     PixelFormat.RGBA_8888,
                     2)),
-            ByteBuffer.allocateDirect(WIDTH * HEIGHT * 4),
             0,
             false)
         assertThat(fakeRgbaImageProxy).isNotNull()
@@ -0,0 +1,98 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Host micro-benchmark comparing weave_pixels with the scalar loop on the chroma planes of a 4K
+// frame, for planar, NV12 and NV21 sources. The row width is not a multiple of the vector width
+// so that the scalar tails run too. weave_pixels must produce the same output as the scalar loop,
+// the benchmark fails otherwise. Build with the host configuration of CMakeLists.txt.
+
+#include "../weave_pixels.h"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+constexpr int kWidth = 1920 + 7;
+constexpr int kHeight = 1080;
+constexpr int kIterations = 100;
+
+template<typename Function>
+static double measure(Function function) {
+    auto start = std::chrono::steady_clock::now();
+    for (int n = 0; n < kIterations; n++) {
+        function();
+    }
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / kIterations;
+}
+
+// Weaves every row of the planes with the given function and compares both outputs.
+template<typename Function>
+static bool run(const char* name, const uint8_t* src_u, const uint8_t* src_v, int src_stride,
+                int src_pixel_stride_uv, Function kernel) {
+    std::vector<uint8_t> scalar(kWidth * 2 * kHeight);
+    std::vector<uint8_t> woven(kWidth * 2 * kHeight);
+    double scalar_time = measure([&]() {
+        for (int y = 0; y < kHeight; y++) {
+            weave_pixels_scalar(src_u + y * src_stride, src_v + y * src_stride,
+                                src_pixel_stride_uv, scalar.data() + y * kWidth * 2, kWidth);
+        }
+    });
+    double kernel_time = measure([&]() {
+        for (int y = 0; y < kHeight; y++) {
+            kernel(src_u + y * src_stride, src_v + y * src_stride, src_pixel_stride_uv,
+                   woven.data() + y * kWidth * 2, kWidth);
+        }
+    });
+    const double samples = double(kWidth) * kHeight;
+    printf("%-8s scalar %8.1f us (%5.2f ns/px)   kernel %8.1f us (%5.2f ns/px)   %.2fx\n",
+           name, scalar_time, scalar_time * 1000.0 / samples, kernel_time,
+           kernel_time * 1000.0 / samples, scalar_time / kernel_time);
+    if (scalar != woven) {
+        printf("%s output mismatch\n", name);
+        return false;
+    }
+    return true;
+}
+
+int main() {
+    std::mt19937 random(42);
+    std::uniform_int_distribution<int> bytes(0, 255);
+
+    std::vector<uint8_t> planar_u(kWidth * kHeight);
+    std::vector<uint8_t> planar_v(kWidth * kHeight);
+    std::vector<uint8_t> interleaved(kWidth * 2 * kHeight);
+    for (uint8_t& sample : planar_u) sample = bytes(random);
+    for (uint8_t& sample : planar_v) sample = bytes(random);
+    for (uint8_t& sample : interleaved) sample = bytes(random);
+
+    bool success = run("planar", planar_u.data(), planar_v.data(), kWidth, 1, weave_pixels);
+    success &= run("nv12", interleaved.data(), interleaved.data() + 1, kWidth * 2, 2,
+                   weave_pixels);
+    success &= run("nv21", interleaved.data() + 1, interleaved.data(), kWidth * 2, 2,
+                   weave_pixels);
+
+    // Weaving NV12 samples into themselves is free.
+    double in_place_time = measure([&]() {
+        for (int y = 0; y < kHeight; y++) {
+            uint8_t* row = interleaved.data() + y * kWidth * 2;
+            weave_pixels(row, row + 1, 2, row, kWidth);
+        }
+    });
+    printf("%-8s kernel %8.1f us\n", "in place", in_place_time);
+    return success ? 0 : 1;
+}
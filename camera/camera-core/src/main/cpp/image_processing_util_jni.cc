@@ -20,7 +20,10 @@
 #include <android/native_window.h>
 #include <android/native_window_jni.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cinttypes>
+#include <functional>
 #include <cstdlib>
 
 #include <android/bitmap.h>
@@ -28,31 +31,13 @@
 #include "libyuv/convert_argb.h"
 #include "libyuv/rotate_argb.h"
 #include "libyuv/convert.h"
+#include "libyuv/planar_functions.h"
+#include "libyuv/rotate.h"
 
-#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, "YuvToRgbJni", __VA_ARGS__)
-
-#define align_buffer_64(var, size)                                           \
-  uint8_t* var##_mem = (uint8_t*)(malloc((size) + 63));         /* NOLINT */ \
-  uint8_t* var = (uint8_t*)(((intptr_t)(var##_mem) + 63) & ~63) /* NOLINT */
+#include "weave_pixels.h"
+#include "worker_pool.h"
 
-#define free_aligned_buffer_64(var) \
-  free(var##_mem);                  \
-  var = 0
-
-static void weave_pixels(const uint8_t* src_u,
-                        const uint8_t* src_v,
-                        int src_pixel_stride_uv,
-                        uint8_t* dst_uv,
-                        int width) {
-    int i;
-    for (i = 0; i < width; ++i) {
-        dst_uv[0] = *src_u;
-        dst_uv[1] = *src_v;
-        dst_uv += 2;
-        src_u += src_pixel_stride_uv;
-        src_v += src_pixel_stride_uv;
-    }
-}
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, "YuvToRgbJni", __VA_ARGS__)
 
 static libyuv::RotationMode get_rotation_mode(int rotation) {
     libyuv::RotationMode mode = libyuv::kRotate0;
@@ -103,6 +88,364 @@ static int Android420ToABGR(const uint8_t* src_y,
                                   height);
 }
 
+// Frames with fewer pixels are converted on the calling thread, waking the workers up would cost
+// more than it saves.
+#define PARALLEL_MIN_PIXELS (1280 * 720)
+
+// Helper function to split the rows of a frame in bands of a multiple of row_alignment rows and
+// run band(y, rows) for each of them on the worker pool. Small frames are processed as a single
+// band on the calling thread. Returns the first non zero result of band.
+static int run_in_bands(int width,
+                        int height,
+                        int row_alignment,
+                        const std::function<int(int, int)>& band) {
+    WorkerPool& pool = WorkerPool::get();
+    int units = (height + row_alignment - 1) / row_alignment;
+    int band_count = width * height >= PARALLEL_MIN_PIXELS
+            ? std::min(pool.concurrency(), units) : 1;
+    if (band_count <= 1) {
+        return band(0, height);
+    }
+
+    int band_rows = (units + band_count - 1) / band_count * row_alignment;
+    band_count = (height + band_rows - 1) / band_rows;
+    std::atomic<int> result(0);
+    pool.parallel_for(band_count, [&](int i) {
+        int y = i * band_rows;
+        int band_result = band(y, std::min(band_rows, height - y));
+        if (band_result != 0) {
+            int expected = 0;
+            result.compare_exchange_strong(expected, band_result);
+        }
+    });
+    return result.load();
+}
+
+// Helper function returning the offset, in a rotated plane of the given stride, of the rotation of
+// the rows [y, y + rows) of a plane of height rows.
+static ptrdiff_t rotated_band_offset(int y,
+                                     int rows,
+                                     int height,
+                                     int rotated_stride,
+                                     libyuv::RotationMode mode) {
+    switch (mode) {
+        case libyuv::kRotate90:
+            return height - y - rows;
+        case libyuv::kRotate180:
+            return static_cast<ptrdiff_t>(height - y - rows) * rotated_stride;
+        case libyuv::kRotate270:
+            return y;
+        default:
+            return static_cast<ptrdiff_t>(y) * rotated_stride;
+    }
+}
+
+// Size, in bytes, of the tiles used to convert and rotate in a single pass, small enough for the
+// converted tile to stay in the L1 cache until it is rotated.
+#define ROTATE_TILE_BYTES (32 * 1024)
+// Width, in pixels, of the tiles used for 90 and 270 degree rotations. Tiles are taller than wide
+// so that each row of the rotated tile spans several cache lines of the destination.
+#define ROTATE_TILE_WIDTH 64
+
+// Helper function to convert the region of width x height pixels starting at (x, y) of an
+// Android420 frame of frame_height rows to ABGR. Only last_row_width pixels of the last row of the
+// frame are converted, the pixels past it are left untouched. x and y must be even.
+static int Android420RegionToABGR(const uint8_t* src_y,
+                                  int src_stride_y,
+                                  const uint8_t* src_u,
+                                  int src_stride_u,
+                                  const uint8_t* src_v,
+                                  int src_stride_v,
+                                  int src_pixel_stride_uv,
+                                  uint8_t* dst_abgr,
+                                  int dst_stride_abgr,
+                                  int x,
+                                  int y,
+                                  int width,
+                                  int height,
+                                  int frame_height,
+                                  int last_row_width) {
+    bool has_last_row = y + height == frame_height;
+    int rows = has_last_row ? height - 1 : height;
+    int result = 0;
+    if (rows > 0) {
+        result = Android420ToABGR(src_y + y * src_stride_y + x,
+                                  src_stride_y,
+                                  src_u + (y / 2) * src_stride_u + (x / 2) * src_pixel_stride_uv,
+                                  src_stride_u,
+                                  src_v + (y / 2) * src_stride_v + (x / 2) * src_pixel_stride_uv,
+                                  src_stride_v,
+                                  src_pixel_stride_uv,
+                                  dst_abgr,
+                                  dst_stride_abgr,
+                                  /* is_full_swing = */true,
+                                  width,
+                                  rows);
+    }
+    int last_row_pixels = std::min(width, last_row_width - x);
+    if (result == 0 && has_last_row && last_row_pixels > 0) {
+        int last_y = frame_height - 1;
+        result = Android420ToABGR(
+                src_y + last_y * src_stride_y + x,
+                src_stride_y,
+                src_u + (last_y / 2) * src_stride_u + (x / 2) * src_pixel_stride_uv,
+                src_stride_u,
+                src_v + (last_y / 2) * src_stride_v + (x / 2) * src_pixel_stride_uv,
+                src_stride_v,
+                src_pixel_stride_uv,
+                dst_abgr + rows * dst_stride_abgr,
+                dst_stride_abgr,
+                /* is_full_swing = */true,
+                last_row_pixels,
+                1);
+    }
+    return result;
+}
+
+// Maps the pixel (x, y) of a width x height frame to its position in the rotated frame.
+static void rotate_point(int x, int y, int width, int height, libyuv::RotationMode mode,
+                         int* rotated_x, int* rotated_y) {
+    switch (mode) {
+        case libyuv::kRotate90:
+            *rotated_x = height - 1 - y;
+            *rotated_y = x;
+            break;
+        case libyuv::kRotate180:
+            *rotated_x = width - 1 - x;
+            *rotated_y = height - 1 - y;
+            break;
+        case libyuv::kRotate270:
+            *rotated_x = y;
+            *rotated_y = width - 1 - x;
+            break;
+        default:
+            *rotated_x = x;
+            *rotated_y = y;
+            break;
+    }
+}
+
+// Returns the position, in the rotated frame, of the top left corner of the rotation of the
+// width x height tile at (x, y) of a frame_width x frame_height frame.
+static void rotated_tile_origin(int x, int y, int width, int height, int frame_width,
+                                int frame_height, libyuv::RotationMode mode, int* rotated_x,
+                                int* rotated_y) {
+    switch (mode) {
+        case libyuv::kRotate90:
+            rotate_point(x, y + height - 1, frame_width, frame_height, mode, rotated_x, rotated_y);
+            break;
+        case libyuv::kRotate180:
+            rotate_point(x + width - 1, y + height - 1, frame_width, frame_height, mode, rotated_x,
+                         rotated_y);
+            break;
+        case libyuv::kRotate270:
+            rotate_point(x + width - 1, y, frame_width, frame_height, mode, rotated_x, rotated_y);
+            break;
+        default:
+            rotate_point(x, y, frame_width, frame_height, mode, rotated_x, rotated_y);
+            break;
+    }
+}
+
+// Helper function to convert Android420 to ABGR and rotate it in a single pass. The frame is
+// converted in tiles small enough to stay in cache which are rotated straight into dst_abgr, so
+// the converted frame is never written to an intermediate buffer. Only last_row_width pixels of
+// the last row are converted, see Android420RegionToABGR. Large frames are split in bands of
+// source rows converted in parallel, each band being rotated into its own part of dst_abgr.
+static int Android420ToABGRRotate(const uint8_t* src_y,
+                                  int src_stride_y,
+                                  const uint8_t* src_u,
+                                  int src_stride_u,
+                                  const uint8_t* src_v,
+                                  int src_stride_v,
+                                  int src_pixel_stride_uv,
+                                  uint8_t* dst_abgr,
+                                  int dst_stride_abgr,
+                                  int width,
+                                  int height,
+                                  int last_row_width,
+                                  libyuv::RotationMode mode) {
+    if (mode == libyuv::kRotate0) {
+        // Bands start on even rows to share no chroma row.
+        return run_in_bands(width, height, 2, [&](int band_y, int band_rows) {
+            return Android420RegionToABGR(src_y, src_stride_y, src_u, src_stride_u, src_v,
+                                          src_stride_v, src_pixel_stride_uv,
+                                          dst_abgr + band_y * dst_stride_abgr, dst_stride_abgr, 0,
+                                          band_y, width, band_rows, height, last_row_width);
+        });
+    }
+
+    // Rotating by 180 degrees keeps rows contiguous, so it uses wide tiles of a pair of rows which
+    // are converted with fewer calls. 90 and 270 degree rotations turn rows into columns and use
+    // narrow tiles instead.
+    int max_tile_width = ROTATE_TILE_WIDTH;
+    int max_tile_height = ROTATE_TILE_BYTES / (ROTATE_TILE_WIDTH * 4);
+    if (mode == libyuv::kRotate180) {
+        max_tile_width = ROTATE_TILE_BYTES / (2 * 4);
+        max_tile_height = 2;
+    }
+
+    // Bands are made of whole rows of tiles, which are rotated to disjoint parts of dst_abgr.
+    return run_in_bands(width, height, max_tile_height, [&](int band_y, int band_rows) {
+        alignas(64) uint8_t tile[ROTATE_TILE_BYTES];
+        for (int tile_y = band_y; tile_y < band_y + band_rows; tile_y += max_tile_height) {
+            int tile_height = std::min(max_tile_height, band_y + band_rows - tile_y);
+            for (int tile_x = 0; tile_x < width; tile_x += max_tile_width) {
+                int tile_width = std::min(max_tile_width, width - tile_x);
+                int result = Android420RegionToABGR(src_y, src_stride_y, src_u, src_stride_u, src_v,
+                                                    src_stride_v, src_pixel_stride_uv, tile,
+                                                    tile_width * 4, tile_x, tile_y, tile_width,
+                                                    tile_height, height, last_row_width);
+                if (result != 0) {
+                    return result;
+                }
+
+                int rotated_x;
+                int rotated_y;
+                rotated_tile_origin(tile_x, tile_y, tile_width, tile_height, width, height, mode,
+                                    &rotated_x, &rotated_y);
+                result = libyuv::ARGBRotate(tile,
+                                            tile_width * 4,
+                                            dst_abgr + rotated_y * dst_stride_abgr + rotated_x * 4,
+                                            dst_stride_abgr,
+                                            tile_width,
+                                            tile_height,
+                                            mode);
+                if (result != 0) {
+                    return result;
+                }
+            }
+        }
+        return 0;
+    });
+}
+
+// Size, in pixels, of the square tiles used to rotate the U and V planes.
+#define ROTATE_UV_TILE_SIZE 64
+
+// Helper function to rotate the rows [y, y + rows) of the U and V planes of a width x height
+// chroma frame straight into the U and V planes of the destination. Source and destination planes
+// can each be planar, interleaved as NV12 or NV21 or use any other pixel stride. The planes are
+// rotated in tiles: interleaved sources are split and interleaved destinations are weaved one
+// tile at a time, so that no full plane intermediate buffer is needed. y must be a multiple of
+// ROTATE_UV_TILE_SIZE.
+static int RotateUVRows(const uint8_t* src_u,
+                        int src_stride_u,
+                        const uint8_t* src_v,
+                        int src_stride_v,
+                        int src_pixel_stride_uv,
+                        uint8_t* dst_u,
+                        int dst_stride_u,
+                        uint8_t* dst_v,
+                        int dst_stride_v,
+                        int dst_pixel_stride_uv,
+                        int width,
+                        int height,
+                        int y,
+                        int rows,
+                        libyuv::RotationMode mode) {
+    bool src_interleaved = uv_interleaved(src_u, src_v, src_pixel_stride_uv)
+            && src_stride_u == src_stride_v;
+    bool dst_interleaved = uv_interleaved(dst_u, dst_v, dst_pixel_stride_uv)
+            && dst_stride_u == dst_stride_v;
+    bool flip_wh = (mode == libyuv::kRotate90 || mode == libyuv::kRotate270);
+
+    alignas(64) uint8_t tile_u[ROTATE_UV_TILE_SIZE * ROTATE_UV_TILE_SIZE];
+    alignas(64) uint8_t tile_v[ROTATE_UV_TILE_SIZE * ROTATE_UV_TILE_SIZE];
+    alignas(64) uint8_t rotated_tile_u[ROTATE_UV_TILE_SIZE * ROTATE_UV_TILE_SIZE];
+    alignas(64) uint8_t rotated_tile_v[ROTATE_UV_TILE_SIZE * ROTATE_UV_TILE_SIZE];
+    for (int tile_y = y; tile_y < y + rows; tile_y += ROTATE_UV_TILE_SIZE) {
+        int tile_height = std::min(ROTATE_UV_TILE_SIZE, y + rows - tile_y);
+        for (int tile_x = 0; tile_x < width; tile_x += ROTATE_UV_TILE_SIZE) {
+            int tile_width = std::min(ROTATE_UV_TILE_SIZE, width - tile_x);
+
+            // Planar U and V tiles, read in place from planar sources.
+            const uint8_t* u = src_u + tile_y * src_stride_u + tile_x * src_pixel_stride_uv;
+            const uint8_t* v = src_v + tile_y * src_stride_v + tile_x * src_pixel_stride_uv;
+            int tile_stride_u = src_stride_u;
+            int tile_stride_v = src_stride_v;
+            if (src_pixel_stride_uv != 1) {
+                if (src_interleaved && src_v > src_u) {
+                    libyuv::SplitUVPlane(u, src_stride_u, tile_u, ROTATE_UV_TILE_SIZE, tile_v,
+                                         ROTATE_UV_TILE_SIZE, tile_width, tile_height);
+                } else if (src_interleaved) {
+                    libyuv::SplitUVPlane(v, src_stride_v, tile_v, ROTATE_UV_TILE_SIZE, tile_u,
+                                         ROTATE_UV_TILE_SIZE, tile_width, tile_height);
+                } else {
+                    for (int i = 0; i < tile_height; i++) {
+                        for (int j = 0; j < tile_width; j++) {
+                            tile_u[i * ROTATE_UV_TILE_SIZE + j] =
+                                    u[i * src_stride_u + j * src_pixel_stride_uv];
+                            tile_v[i * ROTATE_UV_TILE_SIZE + j] =
+                                    v[i * src_stride_v + j * src_pixel_stride_uv];
+                        }
+                    }
+                }
+                u = tile_u;
+                v = tile_v;
+                tile_stride_u = ROTATE_UV_TILE_SIZE;
+                tile_stride_v = ROTATE_UV_TILE_SIZE;
+            }
+
+            int rotated_x;
+            int rotated_y;
+            rotated_tile_origin(tile_x, tile_y, tile_width, tile_height, width, height, mode,
+                                &rotated_x, &rotated_y);
+
+            if (dst_pixel_stride_uv == 1) {
+                // I420
+                int result = libyuv::RotatePlane(
+                        u, tile_stride_u, dst_u + rotated_y * dst_stride_u + rotated_x,
+                        dst_stride_u, tile_width, tile_height, mode);
+                if (result == 0) {
+                    result = libyuv::RotatePlane(
+                            v, tile_stride_v, dst_v + rotated_y * dst_stride_v + rotated_x,
+                            dst_stride_v, tile_width, tile_height, mode);
+                }
+                if (result != 0) {
+                    return result;
+                }
+                continue;
+            }
+
+            int result = libyuv::RotatePlane(u, tile_stride_u, rotated_tile_u,
+                                             ROTATE_UV_TILE_SIZE, tile_width, tile_height, mode);
+            if (result == 0) {
+                result = libyuv::RotatePlane(v, tile_stride_v, rotated_tile_v,
+                                             ROTATE_UV_TILE_SIZE, tile_width, tile_height, mode);
+            }
+            if (result != 0) {
+                return result;
+            }
+
+            int rotated_width = flip_wh ? tile_height : tile_width;
+            int rotated_height = flip_wh ? tile_width : tile_height;
+            for (int i = 0; i < rotated_height; i++) {
+                const uint8_t* rotated_u = rotated_tile_u + i * ROTATE_UV_TILE_SIZE;
+                const uint8_t* rotated_v = rotated_tile_v + i * ROTATE_UV_TILE_SIZE;
+                uint8_t* dst_row_u = dst_u + (rotated_y + i) * dst_stride_u + rotated_x * 2;
+                uint8_t* dst_row_v = dst_v + (rotated_y + i) * dst_stride_v + rotated_x * 2;
+                if (dst_interleaved && dst_v > dst_u) {
+                    // NV12
+                    weave_pixels(rotated_u, rotated_v, 1, dst_row_u, rotated_width);
+                } else if (dst_interleaved) {
+                    // NV21
+                    weave_pixels(rotated_v, rotated_u, 1, dst_row_v, rotated_width);
+                } else {
+                    dst_row_u = dst_u + (rotated_y + i) * dst_stride_u
+                            + rotated_x * dst_pixel_stride_uv;
+                    dst_row_v = dst_v + (rotated_y + i) * dst_stride_v
+                            + rotated_x * dst_pixel_stride_uv;
+                    for (int j = 0; j < rotated_width; j++) {
+                        dst_row_u[j * dst_pixel_stride_uv] = rotated_u[j];
+                        dst_row_v[j * dst_pixel_stride_uv] = rotated_v[j];
+                    }
+                }
+            }
+        }
+    }
+    return 0;
+}
 
 extern "C" {
 JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeCopyBetweenByteBufferAndBitmap (
@@ -253,22 +596,16 @@ JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeWriteJpegToSu
         return -1;
     }
 
-    // Copy from source to destination.
-    jbyte *jpeg_ptr = env->GetByteArrayElements(jpeg_array, NULL);
-    if (jpeg_ptr == nullptr) {
-        ANativeWindow_release(window);
-        LOGE("Failed to get JPEG bytes array pointer.");
-        return -1;
-    }
+    // Copy from source to destination. The bytes are read straight into the window buffer,
+    // GetByteArrayElements would copy the whole array to a temporary buffer and back. The region
+    // is the whole array, as measured above, so the copy cannot go out of bounds.
     uint8_t *buffer_ptr = reinterpret_cast<uint8_t *>(buffer.bits);
-    memcpy(buffer_ptr, jpeg_ptr, array_size);
+    env->GetByteArrayRegion(jpeg_array, 0, array_size, reinterpret_cast<jbyte *>(buffer_ptr));
     // Set 0 for the padding bytes.
     memset(buffer_ptr + array_size, 0, PADDING_BYTES_FOR_CAMERA3_JPEG_BLOB);
 
     ANativeWindow_unlockAndPost(window);
     ANativeWindow_release(window);
-
-    env->ReleaseByteArrayElements(jpeg_array, jpeg_ptr, 0);
     return 0;
 }
 
@@ -284,7 +621,6 @@ JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeConvertAndroi
         jint src_pixel_stride_y,
         jint src_pixel_stride_uv,
         jobject surface,
-        jobject converted_buffer,
         jint width,
         jint height,
         jint start_offset_y,
@@ -311,14 +647,8 @@ JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeConvertAndroi
     }
 
     libyuv::RotationMode mode = get_rotation_mode(rotation);
-    bool has_rotation = rotation != 0;
-
     uint8_t* buffer_ptr = reinterpret_cast<uint8_t*>(buffer.bits);
-    uint8_t* converted_buffer_ptr = (has_rotation && converted_buffer != NULL)
-            ? static_cast<uint8_t*>(env->GetDirectBufferAddress(converted_buffer)) : nullptr;
-
-    uint8_t* dst_ptr = has_rotation ? converted_buffer_ptr : buffer_ptr;
-    int dst_stride_y = has_rotation ? (width * 4) : (buffer.stride * 4);
+    int dst_stride = buffer.stride * 4;
 
     int result = 0;
     // Apply workaround for one pixel shift issue by checking offset.
@@ -334,77 +664,51 @@ JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeConvertAndroi
             return -1;
         }
 
-        // Convert yuv to rgb except the last line.
-        result = Android420ToABGR(src_y_ptr + start_offset_y,
-                                  src_stride_y,
-                                  src_u_ptr + start_offset_u,
-                                  src_stride_u,
-                                  src_v_ptr + start_offset_v,
-                                  src_stride_v,
-                                  src_pixel_stride_uv,
-                                  dst_ptr,
-                                  dst_stride_y,
-                                  /* is_full_swing = */true,
-                                  width,
-                                  height - 1);
-        if (result == 0) {
-            // Convert the last row with (width - 1) pixels
-            // since the last pixel's yuv data is missing.
-            result = Android420ToABGR(
-                    src_y_ptr + start_offset_y + src_stride_y * (height - 1),
-                    src_stride_y - 1,
-                    src_u_ptr + start_offset_u + src_stride_u * (height - 2) / 2,
-                    src_stride_u - 1,
-                    src_v_ptr + start_offset_v + src_stride_v * (height - 2) / 2,
-                    src_stride_v - 1,
-                    src_pixel_stride_uv,
-                    dst_ptr + dst_stride_y * (height - 1),
-                    dst_stride_y,
-                    /* is_full_swing = */true,
-                    width - 1,
-                    1);
-        }
+        // Convert the last row with (width - 1) pixels since the last pixel's yuv data is missing.
+        result = Android420ToABGRRotate(src_y_ptr + start_offset_y,
+                                        src_stride_y,
+                                        src_u_ptr + start_offset_u,
+                                        src_stride_u,
+                                        src_v_ptr + start_offset_v,
+                                        src_stride_v,
+                                        src_pixel_stride_uv,
+                                        buffer_ptr,
+                                        dst_stride,
+                                        width,
+                                        height,
+                                        width - 1,
+                                        mode);
 
         if (result == 0) {
             // Set the 2x2 pixels on the right bottom by duplicating the 3rd pixel
-            // from the right to left in each row.
+            // from the right to left in each row. Positions are mapped to the rotated buffer.
             for (int i = 0; i < 2; i++) {
                 for (int j = 0; j < 2; j++) {
-                    int r_ind = dst_stride_y * (height - 1 - i) + width * 4 - (j * 4 + 1);
-                    int g_ind = dst_stride_y * (height - 1 - i) + width * 4 - (j * 4 + 2);
-                    int b_ind = dst_stride_y * (height - 1 - i) + width * 4 - (j * 4 + 3);
-                    int a_ind = dst_stride_y * (height - 1 - i) + width * 4 - (j * 4 + 4);
-                    dst_ptr[r_ind] = dst_ptr[r_ind - 8];
-                    dst_ptr[g_ind] = dst_ptr[g_ind - 8];
-                    dst_ptr[b_ind] = dst_ptr[b_ind - 8];
-                    dst_ptr[a_ind] = dst_ptr[a_ind - 8];
+                    int x = width - 1 - j;
+                    int y = height - 1 - i;
+                    int to_x, to_y, from_x, from_y;
+                    rotate_point(x, y, width, height, mode, &to_x, &to_y);
+                    rotate_point(x - 2, y, width, height, mode, &from_x, &from_y);
+                    memcpy(buffer_ptr + dst_stride * to_y + to_x * 4,
+                           buffer_ptr + dst_stride * from_y + from_x * 4,
+                           4);
                 }
             }
         }
     } else {
-        result = Android420ToABGR(src_y_ptr + start_offset_y,
-                                          src_stride_y,
-                                          src_u_ptr + start_offset_u,
-                                          src_stride_u,
-                                          src_v_ptr + start_offset_v,
-                                          src_stride_v,
-                                          src_pixel_stride_uv,
-                                          dst_ptr,
-                                          dst_stride_y,
-                                          /* is_full_swing = */true,
-                                          width,
-                                          height);
-    }
-
-    // TODO(b/203141655): avoid unnecessary memory copy by merging libyuv API for rotation.
-    if (result == 0 && has_rotation) {
-        result = libyuv::ARGBRotate(dst_ptr,
-                                    dst_stride_y,
-                                    buffer_ptr,
-                                    buffer.stride * 4,
-                                    width,
-                                    height,
-                                    mode);
+        result = Android420ToABGRRotate(src_y_ptr,
+                                        src_stride_y,
+                                        src_u_ptr,
+                                        src_stride_u,
+                                        src_v_ptr,
+                                        src_stride_v,
+                                        src_pixel_stride_uv,
+                                        buffer_ptr,
+                                        dst_stride,
+                                        width,
+                                        height,
+                                        width,
+                                        mode);
     }
 
     ANativeWindow_unlockAndPost(window);
@@ -446,8 +750,8 @@ Java_androidx_camera_core_ImageProcessingUtil_nativeConvertAndroid420ToBitmap(
 
     int dst_stride_y = bitmap_stride;
 
-    int result = Android420ToABGR(
-            src_y_ptr ,
+    int result = Android420ToABGRRotate(
+            src_y_ptr,
             src_stride_y,
             src_u_ptr,
             src_stride_u,
@@ -456,9 +760,10 @@ Java_androidx_camera_core_ImageProcessingUtil_nativeConvertAndroid420ToBitmap(
             src_pixel_stride_uv,
             reinterpret_cast<uint8_t *> (bitmapAddress),
             dst_stride_y,
-            /* is_full_swing = */true,
             width,
-            height);
+            height,
+            width,
+            libyuv::kRotate0);
 
     if (result != 0) {
         return -1;
@@ -492,9 +797,6 @@ JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeRotateYUV(
         jobject dst_v,
         jint dst_stride_v,
         jint dst_pixel_stride_v,
-        jobject rotated_buffer_y,
-        jobject rotated_buffer_u,
-        jobject rotated_buffer_v,
         jint width,
         jint height,
         jint rotation) {
@@ -513,138 +815,49 @@ JNIEXPORT jint Java_androidx_camera_core_ImageProcessingUtil_nativeRotateYUV(
     uint8_t *dst_v_ptr =
             static_cast<uint8_t *>(env->GetDirectBufferAddress(dst_v));
 
+    // The Y plane of YUV_420_888 images is never interleaved.
+    if (dst_pixel_stride_y != 1 || dst_pixel_stride_u != dst_pixel_stride_v) {
+        LOGE("Unsupported destination pixel strides.");
+        return -1;
+    }
+
     int halfwidth = (width + 1) >> 1;
     int halfheight = (height + 1) >> 1;
-
-    // TODO(b/203141655): avoid unnecessary memory copy by merging libyuv API for rotation.
-    uint8_t *rotated_y_ptr =
-            static_cast<uint8_t *>(env->GetDirectBufferAddress(rotated_buffer_y));
-    uint8_t *rotated_u_ptr =
-            static_cast<uint8_t *>(env->GetDirectBufferAddress(rotated_buffer_u));
-    uint8_t *rotated_v_ptr =
-            static_cast<uint8_t *>(env->GetDirectBufferAddress(rotated_buffer_v));
-
     libyuv::RotationMode mode = get_rotation_mode(rotation);
-    bool flip_wh = (mode == libyuv::kRotate90 || mode == libyuv::kRotate270);
-
-    int rotated_stride_y = flip_wh ? height : width;
-    int rotated_stride_u = flip_wh ? halfheight : halfwidth;
-    int rotated_stride_v = flip_wh ? halfheight : halfwidth;
 
-    int rotated_width = flip_wh ? height : width;
-    int rotated_height = flip_wh ? width : height;
-    int rotated_halfwidth = flip_wh ? halfheight : halfwidth;
-    int rotated_halfheight = flip_wh ? halfwidth : halfheight;
-
-    int result = 0;
-    const ptrdiff_t vu_off = src_v_ptr - src_u_ptr;
-
-    if (src_pixel_stride_uv == 1) {
-        // I420
-        result = libyuv::I420Rotate(src_y_ptr,
-                                    src_stride_y,
-                                    src_u_ptr,
-                                    src_stride_u,
-                                    src_v_ptr,
-                                    src_stride_v,
-                                    rotated_y_ptr,
-                                    rotated_stride_y,
-                                    rotated_u_ptr,
-                                    rotated_stride_u,
-                                    rotated_v_ptr,
-                                    rotated_stride_v,
-                                    width,
-                                    height,
-                                    mode);
-    } else if (src_pixel_stride_uv == 2 && vu_off == -1 &&
-               src_stride_u == src_stride_v) {
-        // NV21
-        result = libyuv::NV12ToI420Rotate(src_y_ptr,
-                                          src_stride_y,
-                                          src_v_ptr,
-                                          src_stride_v,
-                                          rotated_y_ptr,
-                                          rotated_stride_y,
-                                          rotated_v_ptr,
-                                          rotated_stride_v,
-                                          rotated_u_ptr,
-                                          rotated_stride_u,
-                                          width,
-                                          height,
-                                          mode);
-    } else if (src_pixel_stride_uv == 2 && vu_off == 1 && src_stride_u == src_stride_v) {
-        // NV12
-        result = libyuv::NV12ToI420Rotate(src_y_ptr,
-                                          src_stride_y,
-                                          src_u_ptr,
-                                          src_stride_u,
-                                          rotated_y_ptr,
-                                          rotated_stride_y,
-                                          rotated_u_ptr,
-                                          rotated_stride_u,
-                                          rotated_v_ptr,
-                                          rotated_stride_v,
-                                          width,
-                                          height,
-                                          mode);
-    } else {
-        // General case fallback creates NV12
-        align_buffer_64(plane_uv, halfwidth * 2 * halfheight);
-        uint8_t* dst_uv = plane_uv;
-        for (int y = 0; y < halfheight; y++) {
-            weave_pixels(src_u_ptr, src_v_ptr, src_pixel_stride_uv, dst_uv, halfwidth);
-            src_u_ptr += src_stride_u;
-            src_v_ptr += src_stride_v;
-            dst_uv += halfwidth * 2;
-        }
-
-        result = libyuv::NV12ToI420Rotate(src_y_ptr,
-                                          src_stride_y,
-                                          plane_uv,
-                                          halfwidth * 2,
-                                          rotated_y_ptr,
-                                          rotated_stride_y,
-                                          rotated_u_ptr,
-                                          rotated_stride_u,
-                                          rotated_v_ptr,
-                                          rotated_stride_v,
-                                          width,
-                                          height,
-                                          mode);
-        free_aligned_buffer_64(plane_uv);
-    }
-
-    if (result == 0) {
-        // Y
-        uint8_t *dst_y = rotated_y_ptr;
-        int rotated_pixel_stride_y = 1;
-        for (int i = 0; i < rotated_height; i++) {
-            for (int j = 0; j < rotated_width; j++) {
-                dst_y_ptr[i * dst_stride_y + j * dst_pixel_stride_y] =
-                        dst_y[i * rotated_stride_y + j * rotated_pixel_stride_y];
-            }
-        }
-
-        // U
-        uint8_t *dst_u = rotated_u_ptr;
-        int rotated_pixel_stride_u = 1;
-        for (int i = 0; i < rotated_halfheight; i++) {
-            for (int j = 0; j < rotated_halfwidth; j++) {
-                dst_u_ptr[i * dst_stride_u + j * dst_pixel_stride_u] =
-                        dst_u[i * rotated_stride_u + j * rotated_pixel_stride_u];
-            }
+    // Bands are made of whole rows of chroma tiles, the rotation of each band is written to its
+    // own part of the destination planes.
+    int band_alignment = 2 * ROTATE_UV_TILE_SIZE;
+    int result = run_in_bands(width, height, band_alignment, [&](int band_y, int band_rows) {
+        int band_result = libyuv::RotatePlane(
+                src_y_ptr + band_y * src_stride_y,
+                src_stride_y,
+                dst_y_ptr + rotated_band_offset(band_y, band_rows, height, dst_stride_y, mode),
+                dst_stride_y,
+                width,
+                band_rows,
+                mode);
+        if (band_result != 0) {
+            return band_result;
         }
 
-        // V
-        uint8_t *dst_v = rotated_v_ptr;
-        int rotated_pixel_stride_v = 1;
-        for (int i = 0; i < rotated_halfheight; i++) {
-            for (int j = 0; j < rotated_halfwidth; j++) {
-                dst_v_ptr[i * dst_stride_v + j * dst_pixel_stride_v] =
-                        dst_v[i * rotated_stride_v + j * rotated_pixel_stride_v];
-            }
-        }
-    }
+        int band_halfheight = std::min(halfheight, (band_y + band_rows + 1) >> 1) - (band_y >> 1);
+        return RotateUVRows(src_u_ptr,
+                            src_stride_u,
+                            src_v_ptr,
+                            src_stride_v,
+                            src_pixel_stride_uv,
+                            dst_u_ptr,
+                            dst_stride_u,
+                            dst_v_ptr,
+                            dst_stride_v,
+                            dst_pixel_stride_u,
+                            halfwidth,
+                            halfheight,
+                            band_y >> 1,
+                            band_halfheight,
+                            mode);
+    });
 
     return result;
 }
@@ -0,0 +1,113 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Host test of WorkerPool: every task of a parallel_for runs exactly once and before it returns,
+// across back to back jobs, from concurrent callers falling back to their own thread and from
+// tasks calling parallel_for themselves. Build with the host configuration of CMakeLists.txt and
+// run with ctest, ideally with -fsanitize=thread.
+
+#include "../worker_pool.h"
+
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+static std::atomic<int> sFailureCount(0);
+
+#define EXPECT(condition)                                                                   \
+    do {                                                                                    \
+        if (!(condition)) {                                                                 \
+            fprintf(stderr, "%s:%d: expected %s\n", __FILE__, __LINE__, #condition);        \
+            sFailureCount++;                                                                \
+        }                                                                                   \
+    } while (0)
+
+// Runs parallel_for and checks that each task ran once by the time it returned.
+static void run_and_check(WorkerPool& pool, int count) {
+    std::unique_ptr<std::atomic<int>[]> runs(new std::atomic<int>[count]);
+    for (int i = 0; i < count; i++) {
+        runs[i] = 0;
+    }
+    pool.parallel_for(count, [&](int i) {
+        runs[i].fetch_add(1, std::memory_order_relaxed);
+    });
+    for (int i = 0; i < count; i++) {
+        EXPECT(runs[i].load(std::memory_order_relaxed) == 1);
+    }
+}
+
+static void testRunsEachTaskOnce(WorkerPool& pool) {
+    for (int count : { 0, 1, 2, 3, 4, 7, 64, 1000 }) {
+        run_and_check(pool, count);
+    }
+}
+
+// Jobs following each other quickly, so that workers woken up for a job may only see the next
+// one, which they must run once and only once.
+static void testBackToBackJobs(WorkerPool& pool) {
+    for (int n = 0; n < 2000; n++) {
+        run_and_check(pool, 1 + n % 9);
+    }
+}
+
+// Callers which find the pool busy run their tasks on their own thread, without waiting.
+static void testConcurrentCallers(WorkerPool& pool) {
+    constexpr int kCallers = 4;
+    std::vector<std::thread> callers;
+    for (int c = 0; c < kCallers; c++) {
+        callers.emplace_back([&pool, c]() {
+            for (int n = 0; n < 500; n++) {
+                run_and_check(pool, 1 + (n + c) % 17);
+            }
+        });
+    }
+    for (std::thread& caller : callers) {
+        caller.join();
+    }
+}
+
+// A task calling parallel_for runs the nested tasks on its own thread instead of deadlocking.
+static void testNestedCalls(WorkerPool& pool) {
+    std::atomic<int> runs(0);
+    pool.parallel_for(8, [&](int) {
+        pool.parallel_for(8, [&](int) {
+            runs.fetch_add(1, std::memory_order_relaxed);
+        });
+    });
+    EXPECT(runs.load() == 64);
+}
+
+int main() {
+    // Pools of workers are never destroyed, see WorkerPool.
+    for (int worker_count : { 0, 1, 3 }) {
+        WorkerPool* pool = new WorkerPool(worker_count);
+        EXPECT(pool->concurrency() == worker_count + 1);
+        testRunsEachTaskOnce(*pool);
+        testBackToBackJobs(*pool);
+        testConcurrentCallers(*pool);
+        testNestedCalls(*pool);
+    }
+    testRunsEachTaskOnce(WorkerPool::get());
+    testConcurrentCallers(WorkerPool::get());
+
+    if (sFailureCount > 0) {
+        printf("%d failures\n", sFailureCount.load());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "weave_pixels.h"
+
+#include <cstring>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+void weave_pixels_scalar(const uint8_t* src_u,
+                         const uint8_t* src_v,
+                         int src_pixel_stride_uv,
+                         uint8_t* dst_uv,
+                         int width) {
+    int i;
+    for (i = 0; i < width; ++i) {
+        dst_uv[0] = *src_u;
+        dst_uv[1] = *src_v;
+        dst_uv += 2;
+        src_u += src_pixel_stride_uv;
+        src_v += src_pixel_stride_uv;
+    }
+}
+
+// Interleaves planar U and V rows, 16 samples at a time.
+static void weave_planar(const uint8_t* src_u, const uint8_t* src_v, uint8_t* dst_uv, int width) {
+    int i = 0;
+#if defined(__ARM_NEON)
+    for (; i + 16 <= width; i += 16) {
+        uint8x16x2_t uv;
+        uv.val[0] = vld1q_u8(src_u + i);
+        uv.val[1] = vld1q_u8(src_v + i);
+        vst2q_u8(dst_uv + i * 2, uv);
+    }
+#elif defined(__SSE2__)
+    for (; i + 16 <= width; i += 16) {
+        __m128i u = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_u + i));
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_v + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst_uv + i * 2), _mm_unpacklo_epi8(u, v));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst_uv + i * 2 + 16), _mm_unpackhi_epi8(u, v));
+    }
+#endif
+    weave_pixels_scalar(src_u + i, src_v + i, 1, dst_uv + i * 2, width - i);
+}
+
+// Swaps the samples of an NV21 row, starting with V, into an NV12 row, 16 pairs at a time.
+static void swap_interleaved(const uint8_t* src_vu, uint8_t* dst_uv, int width) {
+    int i = 0;
+#if defined(__ARM_NEON)
+    for (; i + 16 <= width; i += 16) {
+        vst1q_u8(dst_uv + i * 2, vrev16q_u8(vld1q_u8(src_vu + i * 2)));
+        vst1q_u8(dst_uv + i * 2 + 16, vrev16q_u8(vld1q_u8(src_vu + i * 2 + 16)));
+    }
+#elif defined(__SSE2__)
+    for (; i + 16 <= width; i += 16) {
+        for (int half = 0; half < 32; half += 16) {
+            __m128i vu = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_vu + i * 2 + half));
+            __m128i uv = _mm_or_si128(_mm_slli_epi16(vu, 8), _mm_srli_epi16(vu, 8));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst_uv + i * 2 + half), uv);
+        }
+    }
+#endif
+    weave_pixels_scalar(src_vu + i * 2 + 1, src_vu + i * 2, 2, dst_uv + i * 2, width - i);
+}
+
+void weave_pixels(const uint8_t* src_u,
+                  const uint8_t* src_v,
+                  int src_pixel_stride_uv,
+                  uint8_t* dst_uv,
+                  int width) {
+    if (src_pixel_stride_uv == 1) {
+        weave_planar(src_u, src_v, dst_uv, width);
+    } else if (uv_interleaved(src_u, src_v, src_pixel_stride_uv) && src_v == src_u + 1) {
+        // Already NV12, nothing to weave.
+        if (dst_uv != src_u) {
+            memcpy(dst_uv, src_u, static_cast<size_t>(width) * 2);
+        }
+    } else if (uv_interleaved(src_u, src_v, src_pixel_stride_uv)) {
+        swap_interleaved(src_v, dst_uv, width);
+    } else {
+        weave_pixels_scalar(src_u, src_v, src_pixel_stride_uv, dst_uv, width);
+    }
+}
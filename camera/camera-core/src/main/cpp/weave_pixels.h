@@ -0,0 +1,46 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CAMERA_CORE_WEAVE_PIXELS_H
+#define CAMERA_CORE_WEAVE_PIXELS_H
+
+#include <cstdint>
+
+// Returns true if the U and V samples, read every src_pixel_stride_uv bytes, are already
+// interleaved in memory, as NV12 when src_v follows src_u and as NV21 when it precedes it.
+inline bool uv_interleaved(const uint8_t* src_u, const uint8_t* src_v, int src_pixel_stride_uv) {
+    return src_pixel_stride_uv == 2 && (src_v == src_u + 1 || src_v == src_u - 1);
+}
+
+// Interleaves width U and V samples, read every src_pixel_stride_uv bytes, into dst_uv as NV12.
+// Planar samples (stride 1) are interleaved with NEON or SSE2 when the target supports them.
+// Samples already interleaved as NV12 are copied, or left untouched when dst_uv is src_u, and
+// samples interleaved as NV21 are swapped. Any other stride uses the scalar loop. dst_uv must not
+// overlap the samples otherwise.
+void weave_pixels(const uint8_t* src_u,
+                  const uint8_t* src_v,
+                  int src_pixel_stride_uv,
+                  uint8_t* dst_uv,
+                  int width);
+
+// Scalar loop handling any stride, exposed for benchmarking.
+void weave_pixels_scalar(const uint8_t* src_u,
+                         const uint8_t* src_v,
+                         int src_pixel_stride_uv,
+                         uint8_t* dst_uv,
+                         int width);
+
+#endif // CAMERA_CORE_WEAVE_PIXELS_H
@@ -0,0 +1,102 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "worker_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+// Conversions are memory bound, more workers than this do not make them faster.
+#define MAX_WORKERS 3
+
+struct WorkerPool::Job {
+    const std::function<void(int)>* task;
+    int count;
+    std::atomic<int> next{0};
+    // Number of threads running the job, guarded by mutex_.
+    int active = 0;
+
+    void run() {
+        int i;
+        while ((i = next.fetch_add(1, std::memory_order_relaxed)) < count) {
+            (*task)(i);
+        }
+    }
+};
+
+WorkerPool& WorkerPool::get() {
+    // Intentionally leaked: the detached workers may still use it while the process exits.
+    static WorkerPool* pool = new WorkerPool(
+            std::min(static_cast<int>(std::thread::hardware_concurrency()) - 1, MAX_WORKERS));
+    return *pool;
+}
+
+WorkerPool::WorkerPool(int worker_count) : worker_count_(std::max(worker_count, 0)) {
+    for (int i = 0; i < worker_count_; i++) {
+        std::thread(&WorkerPool::worker_loop, this).detach();
+    }
+}
+
+void WorkerPool::worker_loop() {
+    uint64_t seen_generation = 0;
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        work_condition_.wait(lock, [&] {
+            return job_ != nullptr && generation_ != seen_generation;
+        });
+        seen_generation = generation_;
+        Job* job = job_;
+        job->active++;
+        lock.unlock();
+
+        job->run();
+
+        lock.lock();
+        if (--job->active == 0) {
+            done_condition_.notify_all();
+        }
+    }
+}
+
+void WorkerPool::parallel_for(int count, const std::function<void(int)>& task) {
+    std::unique_lock<std::mutex> run_lock(run_mutex_, std::try_to_lock);
+    if (count <= 1 || worker_count_ == 0 || !run_lock.owns_lock()) {
+        for (int i = 0; i < count; i++) {
+            task(i);
+        }
+        return;
+    }
+
+    Job job;
+    job.task = &task;
+    job.count = count;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job.active = 1;
+        job_ = &job;
+        generation_++;
+    }
+    work_condition_.notify_all();
+
+    job.run();
+
+    // Every task has been claimed once run returns, wait for the workers still running one.
+    std::unique_lock<std::mutex> lock(mutex_);
+    job.active--;
+    done_condition_.wait(lock, [&] { return job.active == 0; });
+    job_ = nullptr;
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CAMERA_CORE_WORKER_POOL_H
+#define CAMERA_CORE_WORKER_POOL_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+// Small pool of persistent worker threads used to split image conversions across cores.
+class WorkerPool {
+public:
+    // Returns the process wide pool. Its workers are started on first use and are never stopped.
+    static WorkerPool& get();
+
+    // Starts a pool of worker_count workers. The workers are detached and use the pool until the
+    // process exits, so it must never be destroyed.
+    explicit WorkerPool(int worker_count);
+
+    // Number of threads running the tasks of parallel_for, including the calling thread.
+    int concurrency() const { return worker_count_ + 1; }
+
+    // Runs task(i) for each i in [0, count) on the workers and the calling thread, and returns
+    // once all of them are done. The tasks run on the calling thread only if the pool is already
+    // busy with another call, so concurrent callers never wait for each other.
+    void parallel_for(int count, const std::function<void(int)>& task);
+
+private:
+    struct Job;
+
+    void worker_loop();
+
+    const int worker_count_;
+    // Held for the duration of parallel_for to run one job at a time.
+    std::mutex run_mutex_;
+    std::mutex mutex_;
+    std::condition_variable work_condition_;
+    std::condition_variable done_condition_;
+    // Job being run, guarded by mutex_.
+    Job* job_ = nullptr;
+    // Incremented for each job, guarded by mutex_.
+    uint64_t generation_ = 0;
+};
+
+#endif // CAMERA_CORE_WORKER_POOL_H
@@ -43,7 +43,6 @@ import androidx.core.os.OperationCanceledException;
 
 import com.google.common.util.concurrent.ListenableFuture;
 
-import java.nio.ByteBuffer;
 import java.util.concurrent.Executor;
 
 /**
@@ -100,22 +99,6 @@ abstract class ImageAnalysisAbstractAnalyzer implements ImageReaderProxy.OnImage
     @GuardedBy("mAnalyzerLock")
     private Matrix mUpdatedSensorToBufferTransformMatrix = new Matrix();
 
-    @GuardedBy("mAnalyzerLock")
-    @Nullable
-    @VisibleForTesting ByteBuffer mRGBConvertedBuffer;
-
-    @GuardedBy("mAnalyzerLock")
-    @Nullable
-    @VisibleForTesting ByteBuffer mYRotatedBuffer;
-
-    @GuardedBy("mAnalyzerLock")
-    @Nullable
-    @VisibleForTesting ByteBuffer mURotatedBuffer;
-
-    @GuardedBy("mAnalyzerLock")
-    @Nullable
-    @VisibleForTesting ByteBuffer mVRotatedBuffer;
-
     // Lock that synchronizes the access to mSubscribedAnalyzer/mUserExecutor to prevent mismatch.
     private final Object mAnalyzerLock = new Object();
 
@@ -172,10 +155,6 @@ abstract class ImageAnalysisAbstractAnalyzer implements ImageReaderProxy.OnImage
         ImageAnalysis.Analyzer analyzer;
         SafeCloseImageReaderProxy processedImageReaderProxy;
         ImageWriter processedImageWriter;
-        ByteBuffer rgbConvertedBuffer;
-        ByteBuffer yRotatedBuffer;
-        ByteBuffer uRotatedBuffer;
-        ByteBuffer vRotatedBuffer;
         int currentBufferRotationDegrees = mOutputImageRotationEnabled ? mRelativeRotation : 0;
         boolean outputImageDirty;
 
@@ -194,17 +173,8 @@ abstract class ImageAnalysisAbstractAnalyzer implements ImageReaderProxy.OnImage
                 recreateImageReaderProxy(imageProxy, currentBufferRotationDegrees);
             }
 
-            // Cache memory buffer for image rotation
-            if (mOutputImageRotationEnabled) {
-                createHelperBuffer(imageProxy);
-            }
-
             processedImageReaderProxy = mProcessedImageReaderProxy;
             processedImageWriter = mProcessedImageWriter;
-            rgbConvertedBuffer = mRGBConvertedBuffer;
-            yRotatedBuffer = mYRotatedBuffer;
-            uRotatedBuffer = mURotatedBuffer;
-            vRotatedBuffer = mVRotatedBuffer;
         }
 
         ListenableFuture<Void> future;
@@ -218,7 +188,6 @@ abstract class ImageAnalysisAbstractAnalyzer implements ImageReaderProxy.OnImage
                             convertYUVToRGB(
                                     imageProxy,
                                     processedImageReaderProxy,
-                                    rgbConvertedBuffer,
                                     currentBufferRotationDegrees,
                                     mOnePixelShiftEnabled);
                 } else if (mOutputImageFormat == ImageAnalysis.OUTPUT_IMAGE_FORMAT_YUV_420_888) {
@@ -226,17 +195,11 @@ abstract class ImageAnalysisAbstractAnalyzer implements ImageReaderProxy.OnImage
                     if (mOnePixelShiftEnabled) {
                         applyPixelShiftForYUV(imageProxy);
                     }
-                    if (processedImageWriter != null
-                            && yRotatedBuffer != null
-                            && uRotatedBuffer != null
-                            && vRotatedBuffer != null) {
+                    if (processedImageWriter != null) {
                         processedImageProxy = rotateYUV(
                                 imageProxy,
                                 processedImageReaderProxy,
                                 processedImageWriter,
-                                yRotatedBuffer,
-                                uRotatedBuffer,
-                                vRotatedBuffer,
                                 currentBufferRotationDegrees);
                     }
                 }
@@ -385,34 +348,6 @@ abstract class ImageAnalysisAbstractAnalyzer implements ImageReaderProxy.OnImage
         clearCache();
     }
 
-    @GuardedBy("mAnalyzerLock")
-    private void createHelperBuffer(@NonNull ImageProxy imageProxy) {
-        if (mOutputImageFormat == ImageAnalysis.OUTPUT_IMAGE_FORMAT_YUV_420_888) {
-            if (mYRotatedBuffer == null) {
-                mYRotatedBuffer = ByteBuffer.allocateDirect(
-                        imageProxy.getWidth() * imageProxy.getHeight());
-            }
-            mYRotatedBuffer.position(0);
-
-            if (mURotatedBuffer == null) {
-                mURotatedBuffer = ByteBuffer.allocateDirect(
-                        imageProxy.getWidth() * imageProxy.getHeight() / 4);
-            }
-            mURotatedBuffer.position(0);
-
-            if (mVRotatedBuffer == null) {
-                mVRotatedBuffer = ByteBuffer.allocateDirect(
-                        imageProxy.getWidth() * imageProxy.getHeight() / 4);
-            }
-            mVRotatedBuffer.position(0);
-        } else if (mOutputImageFormat == OUTPUT_IMAGE_FORMAT_RGBA_8888) {
-            if (mRGBConvertedBuffer == null) {
-                mRGBConvertedBuffer = ByteBuffer.allocateDirect(
-                        imageProxy.getWidth() * imageProxy.getHeight() * 4);
-            }
-        }
-    }
-
     @GuardedBy("mAnalyzerLock")
     private void recreateImageReaderProxy(
             @NonNull ImageProxy imageProxy,
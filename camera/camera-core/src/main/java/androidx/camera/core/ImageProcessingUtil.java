@@ -32,6 +32,7 @@ import androidx.annotation.NonNull;
 import androidx.annotation.Nullable;
 import androidx.annotation.RequiresApi;
 import androidx.annotation.RestrictTo;
+import androidx.annotation.VisibleForTesting;
 import androidx.camera.core.impl.ImageOutputConfig;
 import androidx.camera.core.impl.ImageReaderProxy;
 import androidx.camera.core.internal.compat.ImageWriterCompat;
@@ -176,7 +177,6 @@ public final class ImageProcessingUtil {
      *
      * @param imageProxy           input image proxy in YUV.
      * @param rgbImageReaderProxy  output image reader proxy in RGB.
-     * @param rgbConvertedBuffer   intermediate image buffer for format conversion.
      * @param rotationDegrees      output image rotation degrees.
      * @param onePixelShiftEnabled true if one pixel shift should be applied, otherwise false.
      * @return output image proxy in RGB.
@@ -185,7 +185,6 @@ public final class ImageProcessingUtil {
     public static ImageProxy convertYUVToRGB(
             @NonNull ImageProxy imageProxy,
             @NonNull ImageReaderProxy rgbImageReaderProxy,
-            @Nullable ByteBuffer rgbConvertedBuffer,
             @IntRange(from = 0, to = 359) int rotationDegrees,
             boolean onePixelShiftEnabled) {
         if (!isSupportedYUVFormat(imageProxy)) {
@@ -203,7 +202,6 @@ public final class ImageProcessingUtil {
         Result result = convertYUVToRGBInternal(
                 imageProxy,
                 rgbImageReaderProxy.getSurface(),
-                rgbConvertedBuffer,
                 rotationDegrees,
                 onePixelShiftEnabled);
 
@@ -242,7 +240,7 @@ public final class ImageProcessingUtil {
      * Converts image proxy in YUV to {@link Bitmap}.
      *
      * <p> Different from {@link ImageProcessingUtil#convertYUVToRGB(
-     * ImageProxy, ImageReaderProxy, ByteBuffer, int, boolean)}, this function converts to
+     * ImageProxy, ImageReaderProxy, int, boolean)}, this function converts to
      * {@link Bitmap} in RGBA directly. If input format is invalid,
      * {@link IllegalArgumentException} will be thrown. If the conversion to bitmap failed,
      * {@link UnsupportedOperationException} will be thrown.
@@ -314,9 +312,6 @@ public final class ImageProcessingUtil {
      * @param imageProxy              input image proxy.
      * @param rotatedImageReaderProxy input image reader proxy.
      * @param rotatedImageWriter      output image writer.
-     * @param yRotatedBuffer          intermediate image buffer for y plane rotation.
-     * @param uRotatedBuffer          intermediate image buffer for u plane rotation.
-     * @param vRotatedBuffer          intermediate image buffer for v plane rotation.
      * @param rotationDegrees         output image rotation degrees.
      * @return rotated image proxy or null if rotation fails or format is not supported.
      */
@@ -325,9 +320,6 @@ public final class ImageProcessingUtil {
             @NonNull ImageProxy imageProxy,
             @NonNull ImageReaderProxy rotatedImageReaderProxy,
             @NonNull ImageWriter rotatedImageWriter,
-            @NonNull ByteBuffer yRotatedBuffer,
-            @NonNull ByteBuffer uRotatedBuffer,
-            @NonNull ByteBuffer vRotatedBuffer,
             @IntRange(from = 0, to = 359) int rotationDegrees) {
         if (!isSupportedYUVFormat(imageProxy)) {
             Logger.e(TAG, "Unsupported format for rotate YUV");
@@ -347,9 +339,6 @@ public final class ImageProcessingUtil {
             result = rotateYUVInternal(
                     imageProxy,
                     rotatedImageWriter,
-                    yRotatedBuffer,
-                    uRotatedBuffer,
-                    vRotatedBuffer,
                     rotationDegrees);
         }
 
@@ -394,7 +383,6 @@ public final class ImageProcessingUtil {
     private static Result convertYUVToRGBInternal(
             @NonNull ImageProxy imageProxy,
             @NonNull Surface surface,
-            @Nullable ByteBuffer rgbConvertedBuffer,
             @ImageOutputConfig.RotationDegreesValue int rotation,
             boolean onePixelShiftEnabled) {
         int imageWidth = imageProxy.getWidth();
@@ -419,7 +407,6 @@ public final class ImageProcessingUtil {
                 srcPixelStrideY,
                 srcPixelStrideUV,
                 surface,
-                rgbConvertedBuffer,
                 imageWidth,
                 imageHeight,
                 startOffsetY,
@@ -471,9 +458,6 @@ public final class ImageProcessingUtil {
     private static Result rotateYUVInternal(
             @NonNull ImageProxy imageProxy,
             @NonNull ImageWriter rotatedImageWriter,
-            @NonNull ByteBuffer yRotatedBuffer,
-            @NonNull ByteBuffer uRotatedBuffer,
-            @NonNull ByteBuffer vRotatedBuffer,
             @ImageOutputConfig.RotationDegreesValue int rotationDegrees) {
         int imageWidth = imageProxy.getWidth();
         int imageHeight = imageProxy.getHeight();
@@ -504,9 +488,6 @@ public final class ImageProcessingUtil {
                 rotatedImage.getPlanes()[2].getBuffer(),
                 rotatedImage.getPlanes()[2].getRowStride(),
                 rotatedImage.getPlanes()[2].getPixelStride(),
-                yRotatedBuffer,
-                uRotatedBuffer,
-                vRotatedBuffer,
                 imageWidth,
                 imageHeight,
                 rotationDegrees);
@@ -539,7 +520,6 @@ public final class ImageProcessingUtil {
             int srcPixelStrideY,
             int srcPixelStrideUV,
             @Nullable Surface surface,
-            @Nullable ByteBuffer convertedByteBufferRGB,
             int width,
             int height,
             int startOffsetY,
@@ -576,7 +556,8 @@ public final class ImageProcessingUtil {
             int startOffsetU,
             int startOffsetV);
 
-    private static native int nativeRotateYUV(
+    @VisibleForTesting
+    static native int nativeRotateYUV(
             @NonNull ByteBuffer srcByteBufferY,
             int srcStrideY,
             @NonNull ByteBuffer srcByteBufferU,
@@ -593,9 +574,6 @@ public final class ImageProcessingUtil {
             @NonNull ByteBuffer dstByteBufferV,
             int dstStrideV,
             int dstPixelStrideV,
-            @NonNull ByteBuffer rotatedByteBufferY,
-            @NonNull ByteBuffer rotatedByteBufferU,
-            @NonNull ByteBuffer rotatedByteBufferV,
             int width,
             int height,
             @ImageOutputConfig.RotationDegreesValue int rotationDegrees);
@@ -46,6 +46,7 @@ import androidx.opengl.EGLExt.Companion.EGL_SYNC_NATIVE_FENCE_ANDROID
 import androidx.opengl.EGLExt.Companion.EGL_SYNC_PRIOR_COMMANDS_COMPLETE_KHR
 import androidx.opengl.EGLExt.Companion.EGL_SYNC_STATUS_KHR
 import androidx.opengl.EGLExt.Companion.EGL_SYNC_TYPE_KHR
+import androidx.opengl.EGLImageCache
 import androidx.opengl.EGLSyncKHR
 import androidx.test.ext.junit.runners.AndroidJUnit4
 import androidx.test.filters.SdkSuppress
@@ -452,6 +453,45 @@ class EGLManagerTest {
         }
     }
 
+    @Test
+    @SdkSuppress(minSdkVersion = Build.VERSION_CODES.O)
+    fun testEGLImageCacheReusesImages() {
+        testEGLManager {
+            initializeWithDefaultConfig()
+            if (isExtensionSupported(EGL_KHR_IMAGE_BASE) && isExtensionSupported(
+                    EGL_ANDROID_IMAGE_NATIVE_BUFFER)) {
+                val buffers = Array(3) {
+                    HardwareBuffer.create(
+                        10,
+                        10,
+                        PixelFormat.RGBA_8888,
+                        1,
+                        HardwareBuffer.USAGE_GPU_COLOR_OUTPUT or
+                            HardwareBuffer.USAGE_GPU_SAMPLED_IMAGE
+                    )
+                }
+                EGLImageCache(EGL14.eglGetCurrentDisplay(), capacity = 2).use { cache ->
+                    val first = cache.getTexture(buffers[0])
+                    assertNotEquals(0, first)
+                    assertEquals(first, cache.getTexture(buffers[0]))
+                    assertNotEquals(0, cache.getTexture(buffers[1]))
+                    assertEquals(2L, cache.createdImageCount)
+
+                    // The least recently used buffer is evicted to make room for a new one
+                    assertNotEquals(0, cache.getTexture(buffers[2]))
+                    assertEquals(2, cache.size)
+                    assertFalse(cache.evict(buffers[0]))
+                    assertTrue(cache.evict(buffers[1]))
+                    assertEquals(1, cache.size)
+
+                    cache.clear()
+                    assertEquals(0, cache.size)
+                }
+                buffers.forEach { it.close() }
+            }
+        }
+    }
+
     @Test
     fun testGlImageTargetTexture2DOESSupported() {
         testEGLManager {
@@ -187,6 +187,69 @@ class SurfaceControlCompatTest {
         }
     }
 
+    @Test
+    fun testSurfaceTransactionFrameStatsCollector() {
+        val collector = FrameStatsCollector(capacity = 4)
+        if (Build.VERSION.SDK_INT == Build.VERSION_CODES.TIRAMISU) {
+            // Platform transactions only report frame statistics from Android U
+            SurfaceControlCompat.Transaction().use { transaction ->
+                assertThrows(UnsupportedOperationException::class.java) {
+                    transaction.addFrameStatsCollector(collector)
+                }
+            }
+            collector.close()
+            return
+        }
+
+        val scenario = ActivityScenario.launch(SurfaceControlWrapperTestActivity::class.java)
+            .moveToState(Lifecycle.State.CREATED)
+        try {
+            scenario.onActivity {
+                val callback = object : SurfaceHolderCallback() {
+                    override fun surfaceCreated(sh: SurfaceHolder) {
+                        val surfaceControl = SurfaceControlCompat.Builder()
+                            .setParent(it.getSurfaceView())
+                            .setName("SurfaceControlCompatTest")
+                            .build()
+
+                        SurfaceControlCompat.Transaction()
+                            .addFrameStatsCollector(collector)
+                            .setBuffer(
+                                surfaceControl,
+                                getSolidBuffer(
+                                    SurfaceControlWrapperTestActivity.DEFAULT_WIDTH,
+                                    SurfaceControlWrapperTestActivity.DEFAULT_HEIGHT,
+                                    Color.BLUE
+                                )
+                            )
+                            .commit()
+                    }
+                }
+
+                it.addSurface(it.mSurfaceView, callback)
+            }
+            scenario.moveToState(Lifecycle.State.RESUMED)
+
+            val records = LongArray(FrameStatsCollector.RECORD_SIZE * 4)
+            var count = 0
+            val deadline = SystemClock.elapsedRealtime() + 3000
+            while (count == 0 && SystemClock.elapsedRealtime() < deadline) {
+                count = collector.drain(records)
+                if (count == 0) {
+                    Thread.sleep(10)
+                }
+            }
+            assertEquals(1, count)
+            assertTrue(records[FrameStatsCollector.COMPLETE_TIME] > 0)
+            assertTrue(records[FrameStatsCollector.LATCH_TIME] > 0)
+            assertEquals(0L, collector.droppedCount)
+        } finally {
+            collector.close()
+            // ensure activity is destroyed after any failures
+            scenario.moveToState(Lifecycle.State.DESTROYED)
+        }
+    }
+
     @SdkSuppress(minSdkVersion = Build.VERSION_CODES.S)
     @Test
     fun testSurfaceTransactionOnCommitCallback_multiple() {
@@ -146,6 +146,39 @@ class SurfaceControlWrapperTest {
         }
     }
 
+    @Test
+    fun testSurfaceTransactionOnCompleteCallback_sharedListener() {
+        val latch = CountDownLatch(3)
+        val listener = object : SurfaceControlCompat.TransactionCompletedListener {
+            override fun onTransactionCompleted(transactionStats: Long) {
+                latch.countDown()
+            }
+        }
+
+        val scenario = ActivityScenario.launch(SurfaceControlWrapperTestActivity::class.java)
+            .moveToState(Lifecycle.State.CREATED)
+
+        try {
+            scenario.onActivity {
+                // The listener is shared natively by all the pending transactions
+                SurfaceControlWrapper.Transaction()
+                    .addTransactionCompletedListener(listener)
+                    .addTransactionCompletedListener(listener)
+                    .commit()
+                SurfaceControlWrapper.Transaction()
+                    .addTransactionCompletedListener(listener)
+                    .commit()
+            }
+
+            scenario.moveToState(Lifecycle.State.RESUMED)
+
+            assertTrue(latch.await(3, TimeUnit.SECONDS))
+        } finally {
+            // ensure activity is destroyed after any failures
+            scenario.moveToState(Lifecycle.State.DESTROYED)
+        }
+    }
+
     @SdkSuppress(minSdkVersion = Build.VERSION_CODES.S)
     @Test
     fun testSurfaceTransactionOnCommitCallback() {
@@ -455,6 +488,56 @@ class SurfaceControlWrapperTest {
         }
     }
 
+    @Test
+    fun testTransactionApplyCommands_show() {
+        val listener = TransactionOnCompleteListener()
+        val scenario = ActivityScenario.launch(SurfaceControlWrapperTestActivity::class.java)
+            .moveToState(
+                Lifecycle.State.CREATED
+            ).onActivity {
+                val callback = object : SurfaceHolderCallback() {
+                    override fun surfaceCreated(sh: SurfaceHolder) {
+                        val scCompat = SurfaceControlWrapper
+                            .Builder()
+                            .setParent(it.getSurfaceView().holder.surface)
+                            .setDebugName("SurfaceControlWrapperTest")
+                            .build()
+
+                        // Buffer colorspace is RGBA, so Color.BLUE will be visually Red
+                        val buffer =
+                            SurfaceControlUtils.getSolidBuffer(
+                                SurfaceControlWrapperTestActivity.DEFAULT_WIDTH,
+                                SurfaceControlWrapperTestActivity.DEFAULT_HEIGHT,
+                                Color.BLUE
+                            )
+                        assertNotNull(buffer)
+
+                        val commands = SurfaceTransactionCommands()
+                            .setBuffer(scCompat, buffer)
+                            .setVisibility(scCompat, true)
+                        assertEquals(2, commands.commandCount)
+
+                        SurfaceControlWrapper.Transaction()
+                            .addTransactionCompletedListener(listener)
+                            .applyCommands(commands)
+                            .commit()
+                        assertTrue(commands.isEmpty())
+                    }
+                }
+
+                it.addSurface(it.mSurfaceView, callback)
+            }
+
+        scenario.moveToState(Lifecycle.State.RESUMED).onActivity {
+            assertTrue(listener.mLatch.await(3000, TimeUnit.MILLISECONDS))
+            SurfaceControlUtils.validateOutput { bitmap ->
+                val coord = intArrayOf(0, 0)
+                it.mSurfaceView.getLocationOnScreen(coord)
+                Color.RED == bitmap.getPixel(coord[0], coord[1])
+            }
+        }
+    }
+
     @Test
     fun testTransactionSetVisibility_hide() {
         val listener = TransactionOnCompleteListener()
@@ -728,6 +811,134 @@ class SurfaceControlWrapperTest {
         }
     }
 
+    @Test
+    fun testTransactionSetDamageRegion_multipleRects() {
+        val listener = TransactionOnCompleteListener()
+        val scenario = ActivityScenario.launch(SurfaceControlWrapperTestActivity::class.java)
+            .moveToState(
+                Lifecycle.State.CREATED
+            ).onActivity {
+                val callback = object : SurfaceHolderCallback() {
+                    override fun surfaceCreated(sh: SurfaceHolder) {
+                        val scCompat = SurfaceControlWrapper
+                            .Builder()
+                            .setParent(it.getSurfaceView().holder.surface)
+                            .setDebugName("SurfaceControlWrapperTest")
+                            .build()
+
+                        val width = SurfaceControlWrapperTestActivity.DEFAULT_WIDTH
+                        val height = SurfaceControlWrapperTestActivity.DEFAULT_HEIGHT
+                        // Overlapping, adjacent and scattered rects, coalesced natively
+                        val rects = intArrayOf(
+                            0, 0, 10, 10,
+                            5, 5, 20, 20,
+                            20, 0, 30, 20,
+                            width - 10, height - 10, width, height
+                        )
+                        // Buffer colorspace is RGBA, so Color.BLUE will be visually Red
+                        SurfaceControlWrapper.Transaction()
+                            .addTransactionCompletedListener(listener)
+                            .setDamageRegion(scCompat, rects)
+                            .setBuffer(
+                                scCompat,
+                                SurfaceControlUtils.getSolidBuffer(
+                                    width,
+                                    height,
+                                    Color.BLUE
+                                )
+                            )
+                            .commit()
+                    }
+                }
+
+                it.addSurface(it.mSurfaceView, callback)
+            }
+
+        scenario.moveToState(Lifecycle.State.RESUMED).onActivity {
+            assert(listener.mLatch.await(3000, TimeUnit.MILLISECONDS))
+            SurfaceControlUtils.validateOutput { bitmap ->
+                val coord = intArrayOf(0, 0)
+                it.mSurfaceView.getLocationOnScreen(coord)
+                Color.RED == bitmap.getPixel(coord[0], coord[1])
+            }
+        }
+    }
+
+    @Test
+    fun testTransactionFrameStatsCollector() {
+        val listener = TransactionOnCompleteListener()
+        val collector = FrameStatsCollector(capacity = 4)
+        var nativeSurfaceControl = 0L
+        val scenario = ActivityScenario.launch(SurfaceControlWrapperTestActivity::class.java)
+            .moveToState(
+                Lifecycle.State.CREATED
+            ).onActivity {
+                val callback = object : SurfaceHolderCallback() {
+                    override fun surfaceCreated(sh: SurfaceHolder) {
+                        val scCompat = SurfaceControlWrapper
+                            .Builder()
+                            .setParent(it.getSurfaceView().holder.surface)
+                            .setDebugName("SurfaceControlWrapperTest")
+                            .build()
+                        nativeSurfaceControl = scCompat.mNativeSurfaceControl
+
+                        SurfaceControlWrapper.Transaction()
+                            .addFrameStatsCollector(collector)
+                            .addTransactionCompletedListener(listener)
+                            .setBuffer(
+                                scCompat,
+                                SurfaceControlUtils.getSolidBuffer(
+                                    SurfaceControlWrapperTestActivity.DEFAULT_WIDTH,
+                                    SurfaceControlWrapperTestActivity.DEFAULT_HEIGHT,
+                                    Color.BLUE
+                                )
+                            )
+                            .commit()
+                    }
+                }
+
+                it.addSurface(it.mSurfaceView, callback)
+            }
+
+        try {
+            scenario.moveToState(Lifecycle.State.RESUMED).onActivity {
+                assert(listener.mLatch.await(3000, TimeUnit.MILLISECONDS))
+            }
+            // The present fence usually signals after the transaction completes, its signal
+            // time is resolved when the record is drained
+            Thread.sleep(100)
+            // Both completion callbacks run on the same thread in no particular order
+            val records = LongArray(FrameStatsCollector.RECORD_SIZE * 4)
+            var count = 0
+            val deadline = SystemClock.elapsedRealtime() + 3000
+            while (count == 0 && SystemClock.elapsedRealtime() < deadline) {
+                count = collector.drain(records)
+                if (count == 0) {
+                    Thread.sleep(10)
+                }
+            }
+            assertEquals(1, count)
+            assertTrue(records[FrameStatsCollector.LATCH_TIME] > 0)
+            assertTrue(
+                records[FrameStatsCollector.PRESENT_TIME] != FrameStatsCollector.SIGNAL_TIME_PENDING
+            )
+            assertTrue(records[FrameStatsCollector.LAYER_COUNT] >= 1)
+            val layerCount = minOf(
+                records[FrameStatsCollector.LAYER_COUNT].toInt(),
+                FrameStatsCollector.MAX_LAYERS
+            )
+            val layers = (0 until layerCount).map {
+                records[FrameStatsCollector.layerOffset(it) +
+                    FrameStatsCollector.LAYER_SURFACE_CONTROL]
+            }
+            assertTrue(layers.contains(nativeSurfaceControl))
+            assertEquals(0, collector.drain(records))
+            assertEquals(0L, collector.droppedCount)
+        } finally {
+            collector.close()
+        }
+    }
+
     @Test
     fun testTransactionSetDamageRegion_null() {
         val listener = TransactionOnCompleteListener()
@@ -0,0 +1,93 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package androidx.hardware
+
+import android.graphics.Bitmap
+import android.graphics.Color
+import android.graphics.ColorSpace
+import android.hardware.HardwareBuffer
+import android.os.Build
+import androidx.annotation.RequiresApi
+import androidx.test.ext.junit.runners.AndroidJUnit4
+import androidx.test.filters.SdkSuppress
+import androidx.test.filters.SmallTest
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertFalse
+import org.junit.Assert.assertTrue
+import org.junit.Test
+import org.junit.runner.RunWith
+
+@RunWith(AndroidJUnit4::class)
+@SdkSuppress(minSdkVersion = Build.VERSION_CODES.Q)
+@SmallTest
+class HardwareBufferPixelsTest {
+
+    @Test
+    fun testFillCopyAndBlend() {
+        val dst = createBuffer()
+        val src = createBuffer()
+        try {
+            assertTrue(HardwareBufferPixels.fill(dst, 0, 0, SIZE, SIZE, Color.BLUE))
+            // Rects extending past the buffer bounds are clipped
+            assertTrue(HardwareBufferPixels.fill(src, -10, -10, SIZE * 2, SIZE * 2, Color.RED))
+            assertTrue(HardwareBufferPixels.copy(dst, 0, 0, src, 0, 0, SIZE / 2, SIZE))
+            assertTrue(HardwareBufferPixels.fill(src, 0, 0, SIZE, SIZE, Color.TRANSPARENT))
+            assertTrue(
+                HardwareBufferPixels.fill(src, SIZE / 2, 0, SIZE, SIZE / 2, Color.GREEN)
+            )
+            assertTrue(HardwareBufferPixels.blend(dst, 0, 0, src, 0, 0, SIZE, SIZE))
+
+            val bitmap = dst.toBitmap()
+            assertEquals(Color.RED, bitmap.getPixel(SIZE / 4, SIZE / 4))
+            assertEquals(Color.RED, bitmap.getPixel(SIZE / 4, SIZE * 3 / 4))
+            assertEquals(Color.GREEN, bitmap.getPixel(SIZE * 3 / 4, SIZE / 4))
+            assertEquals(Color.BLUE, bitmap.getPixel(SIZE * 3 / 4, SIZE * 3 / 4))
+        } finally {
+            dst.close()
+            src.close()
+        }
+    }
+
+    @Test
+    fun testCopyToSameBufferFails() {
+        val buffer = createBuffer()
+        try {
+            assertFalse(HardwareBufferPixels.copy(buffer, 1, 1, buffer, 0, 0, SIZE, SIZE))
+        } finally {
+            buffer.close()
+        }
+    }
+
+    @RequiresApi(Build.VERSION_CODES.Q)
+    private fun HardwareBuffer.toBitmap(): Bitmap =
+        Bitmap.wrapHardwareBuffer(this, ColorSpace.get(ColorSpace.Named.SRGB))!!
+            .copy(Bitmap.Config.ARGB_8888, false)
+
+    private fun createBuffer(): HardwareBuffer = HardwareBuffer.create(
+        SIZE,
+        SIZE,
+        HardwareBuffer.RGBA_8888,
+        1,
+        HardwareBuffer.USAGE_CPU_READ_OFTEN or
+            HardwareBuffer.USAGE_CPU_WRITE_OFTEN or
+            HardwareBuffer.USAGE_GPU_SAMPLED_IMAGE
+    )
+
+    private companion object {
+        const val SIZE = 64
+    }
+}
@@ -104,6 +104,32 @@ class SyncFenceCompatTest {
         }
     }
 
+    @Test
+    @SdkSuppress(minSdkVersion = Build.VERSION_CODES.O)
+    fun testSyncFenceCompat_SignalTimes() {
+        testEglManager {
+            initializeWithDefaultConfig()
+            if (supportsNativeAndroidFence()) {
+                val start = System.nanoTime()
+                val fences = arrayOf(
+                    SyncFenceCompat.createNativeSyncFence(),
+                    SyncFenceCompat(SyncFenceV19(-1)),
+                    SyncFenceCompat.createNativeSyncFence()
+                )
+                assertTrue(SyncFenceCompat.awaitAll(fences, -1))
+
+                val signalTimes = LongArray(fences.size)
+                SyncFenceCompat.getSignalTimesNanos(fences, signalTimes)
+                assertTrue(signalTimes[0] > start)
+                assertTrue(signalTimes[0] != SyncFenceCompat.SIGNAL_TIME_PENDING)
+                assertEquals(SyncFenceCompat.SIGNAL_TIME_INVALID, signalTimes[1])
+                assertEquals(fences[2].getSignalTimeNanos(), signalTimes[2])
+
+                fences.forEach { it.close() }
+            }
+        }
+    }
+
     // Helper method used in testing to initialize EGL and default
     // EGLConfig to the ARGB8888 configuration
     private fun EGLManager.initializeWithDefaultConfig() {
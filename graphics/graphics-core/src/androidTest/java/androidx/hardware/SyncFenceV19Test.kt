@@ -17,11 +17,14 @@
 package androidx.hardware
 
 import android.os.Build
+import android.os.ParcelFileDescriptor
 import androidx.graphics.surface.JniBindings
 import androidx.test.ext.junit.runners.AndroidJUnit4
 import androidx.test.filters.SdkSuppress
 import androidx.test.filters.SmallTest
 import org.junit.Assert
+import org.junit.Assert.assertArrayEquals
+import org.junit.Assert.assertEquals
 import org.junit.Assert.assertFalse
 import org.junit.Assert.assertTrue
 import org.junit.Assert.fail
@@ -59,6 +62,11 @@ class SyncFenceV19Test {
         Assert.assertEquals(-1, JniBindings.nDupFenceFd(SyncFenceV19(-1)))
     }
 
+    @Test
+    fun testDupeFdWhenInvalid() {
+        Assert.assertEquals(-1, SyncFenceV19(-1).dupeFd())
+    }
+
     @SdkSuppress(minSdkVersion = Build.VERSION_CODES.O)
     @Test
     fun testSignalTimeInvalid() {
@@ -93,4 +101,119 @@ class SyncFenceV19Test {
     fun testResolveSyncFileInfoFree() {
         assertTrue(SyncFenceBindings.nResolveSyncFileInfoFree())
     }
+
+    // The read end of a pipe behaves like a fence that signals once the write end is written to
+    // or closed
+    private fun createPipeFence(): Pair<SyncFenceCompat, ParcelFileDescriptor> {
+        val (read, write) = ParcelFileDescriptor.createPipe()
+        return Pair(SyncFenceCompat(SyncFenceV19(read.detachFd())), write)
+    }
+
+    @Test
+    fun testAwaitAnyTimeout() {
+        val (fence1, write1) = createPipeFence()
+        val (fence2, write2) = createPipeFence()
+        val signaled = BooleanArray(2)
+        assertEquals(0, SyncFenceCompat.awaitAny(arrayOf(fence1, fence2), 1_000_000, signaled))
+        assertArrayEquals(booleanArrayOf(false, false), signaled)
+        write1.close()
+        write2.close()
+        fence1.close()
+        fence2.close()
+    }
+
+    @Test
+    fun testAwaitAnyReportsSignaledFences() {
+        val (fence1, write1) = createPipeFence()
+        val (fence2, write2) = createPipeFence()
+        val (fence3, write3) = createPipeFence()
+        write2.close()
+
+        val signaled = BooleanArray(3)
+        val fences = arrayOf(fence1, fence2, fence3)
+        assertEquals(1, SyncFenceCompat.awaitAny(fences, -1, signaled))
+        assertArrayEquals(booleanArrayOf(false, true, false), signaled)
+
+        write1.close()
+        write3.close()
+        fences.forEach { fence -> fence.close() }
+    }
+
+    // The write end of a pipe whose read end is closed polls with POLLERR, like a fence in an
+    // error state
+    private fun createErroredFence(): SyncFenceCompat {
+        val (read, write) = ParcelFileDescriptor.createPipe()
+        read.close()
+        return SyncFenceCompat(SyncFenceV19(write.detachFd()))
+    }
+
+    @Test
+    fun testAwaitAnySkipsErroredFences() {
+        val errored = createErroredFence()
+        val (fence, write) = createPipeFence()
+        val fences = arrayOf(errored, fence)
+        val signaled = BooleanArray(2)
+
+        assertEquals(0, SyncFenceCompat.awaitAny(fences, 1_000_000, signaled))
+        assertArrayEquals(booleanArrayOf(false, false), signaled)
+
+        write.close()
+        assertEquals(1, SyncFenceCompat.awaitAny(fences, -1, signaled))
+        assertArrayEquals(booleanArrayOf(false, true), signaled)
+
+        // No fence is left that can signal, the wait does not block
+        assertEquals(0, SyncFenceCompat.awaitAny(arrayOf(errored), -1, signaled))
+        assertFalse(SyncFenceCompat.awaitAll(fences, -1, signaled))
+        assertArrayEquals(booleanArrayOf(false, true), signaled)
+
+        fences.forEach { it.close() }
+    }
+
+    @Test
+    fun testAwaitAll() {
+        val (fence1, write1) = createPipeFence()
+        val (fence2, write2) = createPipeFence()
+        val fences = arrayOf(fence1, SyncFenceCompat(SyncFenceV19(-1)), fence2)
+        val signaled = BooleanArray(3)
+
+        write1.close()
+        assertFalse(SyncFenceCompat.awaitAll(fences, 1_000_000, signaled))
+        assertArrayEquals(booleanArrayOf(true, true, false), signaled)
+
+        write2.close()
+        assertTrue(SyncFenceCompat.awaitAll(fences, -1, signaled))
+        assertArrayEquals(booleanArrayOf(true, true, true), signaled)
+
+        fences.forEach { fence -> fence.close() }
+    }
+
+    @Test
+    fun testAwaitAllInvalidFences() {
+        val fences = arrayOf(SyncFenceCompat(SyncFenceV19(-1)), SyncFenceCompat(SyncFenceV19(-1)))
+        assertTrue(SyncFenceCompat.awaitAll(fences, 0))
+        assertEquals(2, SyncFenceCompat.awaitAny(fences, 0))
+        assertTrue(SyncFenceCompat.awaitAll(emptyArray(), 0))
+    }
+
+    @Test
+    fun testMergeInvalidFences() {
+        val merged = SyncFenceCompat.merge(
+            arrayOf(SyncFenceCompat(SyncFenceV19(-1)), SyncFenceCompat(SyncFenceV19(-1)))
+        )
+        assertFalse(merged.isValid())
+    }
+
+    @Test
+    fun testMergeSingleFence() {
+        val (fence, write) = createPipeFence()
+        val merged = SyncFenceCompat.merge(arrayOf(SyncFenceCompat(SyncFenceV19(-1)), fence))
+        assertTrue(merged.isValid())
+        assertFalse(merged.await(1_000_000))
+
+        // The merged fence waits on its own copy of the file descriptor
+        fence.close()
+        write.close()
+        assertTrue(merged.await(-1))
+        merged.close()
+    }
 }
@@ -0,0 +1,148 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+package androidx.hardware
+
+import android.os.Build
+import android.os.ParcelFileDescriptor
+import androidx.test.ext.junit.runners.AndroidJUnit4
+import androidx.test.filters.SdkSuppress
+import androidx.test.filters.SmallTest
+import java.util.concurrent.CountDownLatch
+import java.util.concurrent.TimeUnit
+import java.util.concurrent.atomic.AtomicLong
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertFalse
+import org.junit.Assert.assertTrue
+import org.junit.Test
+import org.junit.runner.RunWith
+
+@RunWith(AndroidJUnit4::class)
+@SdkSuppress(minSdkVersion = Build.VERSION_CODES.KITKAT)
+@SmallTest
+class SyncFenceWatcherTest {
+
+    // The read end of a pipe behaves like a fence that signals once the write end is closed
+    private fun createPipeFence(): Pair<SyncFenceCompat, ParcelFileDescriptor> {
+        val (read, write) = ParcelFileDescriptor.createPipe()
+        return Pair(SyncFenceCompat(SyncFenceV19(read.detachFd())), write)
+    }
+
+    @Test
+    fun testCallbackInvokedWhenFenceSignals() {
+        SyncFenceWatcher().use { watcher ->
+            val (fence, write) = createPipeFence()
+            val latch = CountDownLatch(1)
+            val signalTime = AtomicLong()
+            watcher.watch(fence) { time ->
+                signalTime.set(time)
+                latch.countDown()
+            }
+            // The watcher waits on its own copy of the file descriptor
+            fence.close()
+
+            assertFalse(latch.await(10, TimeUnit.MILLISECONDS))
+            assertEquals(1, watcher.pendingCount)
+
+            val before = System.nanoTime()
+            write.close()
+            assertTrue(latch.await(3, TimeUnit.SECONDS))
+            assertEquals(0, watcher.pendingCount)
+            // Stand-in fences report the time the watcher received the event, there is no
+            // sync_file_info to resolve for pipes
+            assertTrue(signalTime.get() in before..System.nanoTime())
+        }
+    }
+
+    @Test
+    fun testWatchManyFences() {
+        SyncFenceWatcher().use { watcher ->
+            val count = 32
+            val latch = CountDownLatch(count)
+            val writes = (0 until count).map {
+                val (fence, write) = createPipeFence()
+                watcher.watch(fence) { latch.countDown() }
+                fence.close()
+                write
+            }
+            assertEquals(count, watcher.pendingCount)
+            // Signal from another thread than the one that registered the fences
+            Thread { writes.forEach { write -> write.close() } }.start()
+            assertTrue(latch.await(3, TimeUnit.SECONDS))
+        }
+    }
+
+    @Test
+    fun testInvalidFenceSignalsImmediately() {
+        SyncFenceWatcher().use { watcher ->
+            var signalTime = 0L
+            watcher.watch(SyncFenceCompat(SyncFenceV19(-1))) { time -> signalTime = time }
+            assertEquals(SyncFenceCompat.SIGNAL_TIME_INVALID, signalTime)
+        }
+    }
+
+    @Test
+    fun testCloseDropsPendingFences() {
+        val watcher = SyncFenceWatcher()
+        val (fence, write) = createPipeFence()
+        var invoked = false
+        watcher.watch(fence) { invoked = true }
+        watcher.close()
+        write.close()
+        fence.close()
+        assertFalse(invoked)
+        assertEquals(0, watcher.pendingCount)
+    }
+
+    @Test(expected = IllegalStateException::class)
+    fun testWatchAfterClose() {
+        val watcher = SyncFenceWatcher()
+        watcher.close()
+        val (fence, write) = createPipeFence()
+        try {
+            watcher.watch(fence) {}
+        } finally {
+            write.close()
+            fence.close()
+        }
+    }
+
+    @Test
+    fun testCloseFromCallbackThrows() {
+        SyncFenceWatcher().use { watcher ->
+            val (fence, write) = createPipeFence()
+            val latch = CountDownLatch(1)
+            var error: Throwable? = null
+            watcher.watch(fence) {
+                error = runCatching { watcher.close() }.exceptionOrNull()
+                latch.countDown()
+            }
+            fence.close()
+            write.close()
+            assertTrue(latch.await(3, TimeUnit.SECONDS))
+            assertTrue(error is IllegalStateException)
+
+            // The watcher is still running
+            val (other, otherWrite) = createPipeFence()
+            val otherLatch = CountDownLatch(1)
+            watcher.watch(other) { otherLatch.countDown() }
+            other.close()
+            otherWrite.close()
+            assertTrue(otherLatch.await(3, TimeUnit.SECONDS))
+        }
+    }
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "damage_region.h"
+
+#include <algorithm>
+
+static bool isEmpty(const ARect& rect) {
+    return rect.right <= rect.left || rect.bottom <= rect.top;
+}
+
+static int64_t area(const ARect& rect) {
+    return static_cast<int64_t>(rect.right - rect.left) * (rect.bottom - rect.top);
+}
+
+static ARect bounds(const ARect& a, const ARect& b) {
+    return ARect{std::min(a.left, b.left), std::min(a.top, b.top),
+                 std::max(a.right, b.right), std::max(a.bottom, b.bottom)};
+}
+
+// Pixels covered by the bounds of both rects but by neither of them, negative when they overlap
+static int64_t mergeCost(const ARect& a, const ARect& b) {
+    return area(bounds(a, b)) - area(a) - area(b);
+}
+
+int32_t coalesceDamageRects(ARect* rects, int32_t count, int32_t maxRects) {
+    int32_t size = 0;
+    for (int32_t i = 0; i < count; i++) {
+        if (!isEmpty(rects[i])) {
+            rects[size++] = rects[i];
+        }
+    }
+
+    // Merges that do not grow the damaged area, repeated as each merge can enable others
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (int32_t i = 0; i < size; i++) {
+            for (int32_t j = i + 1; j < size; j++) {
+                if (mergeCost(rects[i], rects[j]) <= 0) {
+                    rects[i] = bounds(rects[i], rects[j]);
+                    rects[j--] = rects[--size];
+                    merged = true;
+                }
+            }
+        }
+    }
+
+    if (maxRects < 1) {
+        maxRects = 1;
+    }
+    while (size > maxRects) {
+        int32_t bestI = 0;
+        int32_t bestJ = 1;
+        int64_t bestCost = INT64_MAX;
+        for (int32_t i = 0; i < size; i++) {
+            for (int32_t j = i + 1; j < size; j++) {
+                const int64_t cost = mergeCost(rects[i], rects[j]);
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestI = i;
+                    bestJ = j;
+                }
+            }
+        }
+        rects[bestI] = bounds(rects[bestI], rects[bestJ]);
+        rects[bestJ] = rects[--size];
+    }
+    return size;
+}
+
+void DamageRegion::add(const ARect& rect) {
+    if (isEmpty(rect)) {
+        return;
+    }
+    constexpr int32_t capacity = sizeof(mRects) / sizeof(mRects[0]);
+    if (mCount == capacity) {
+        coalesce();
+    }
+    mRects[mCount++] = rect;
+}
+
+void DamageRegion::coalesce() {
+    mCount = coalesceDamageRects(mRects, mCount, MAX_DAMAGE_RECTS);
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROIDX_DAMAGE_REGION_H
+#define ANDROIDX_DAMAGE_REGION_H
+
+#include <android/rect.h>
+#include <cstdint>
+
+/**
+ * Maximum number of rects of a damage region handed to the compositor. Compositors only track a
+ * handful of rects per layer, larger regions are coalesced down to this count.
+ */
+static constexpr int32_t MAX_DAMAGE_RECTS = 8;
+
+/**
+ * Coalesces the given rects in place, and returns the resulting number of rects.
+ *
+ * Empty rects are dropped. Rects are merged into their bounds when the bounds cover no more
+ * pixels than the rects do separately, which is the case of overlapping and adjacent rects
+ * sharing an edge. If more than maxRects rects remain, the pairs of rects whose bounds add the
+ * fewest pixels are then merged until maxRects are left. The resulting region always covers the
+ * input rects.
+ */
+int32_t coalesceDamageRects(ARect* rects, int32_t count, int32_t maxRects);
+
+/**
+ * Accumulates the rects of a damage region without allocating, coalescing them whenever the
+ * storage fills up.
+ */
+class DamageRegion {
+public:
+    void add(const ARect& rect);
+
+    /**
+     * Coalesces the accumulated rects down to MAX_DAMAGE_RECTS
+     */
+    void coalesce();
+
+    const ARect* rects() const { return mRects; }
+
+    int32_t count() const { return mCount; }
+
+private:
+    ARect mRects[MAX_DAMAGE_RECTS * 2];
+    int32_t mCount = 0;
+};
+
+#endif //ANDROIDX_DAMAGE_REGION_H
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "egl_image_cache.h"
+
+EGLImageCache::EGLImageCache(const EGLImageFunctions& functions, EGLDisplay display,
+                             size_t capacity)
+        : mFunctions(functions), mDisplay(display), mCapacity(capacity > 0 ? capacity : 1) {
+    mEntries.reserve(mCapacity);
+}
+
+EGLImageCache::~EGLImageCache() {
+    clear();
+}
+
+const EGLImageCache::Entry* EGLImageCache::get(AHardwareBuffer* buffer) {
+    if (buffer == nullptr) {
+        return nullptr;
+    }
+
+    auto it = mEntries.find(buffer);
+    if (it != mEntries.end()) {
+        it->second.lastUse = ++mUseCounter;
+        return &it->second;
+    }
+
+    EGLClientBuffer clientBuffer = mFunctions.getNativeClientBuffer(buffer);
+    const EGLint imageAttrs[] = {EGL_IMAGE_PRESERVED_KHR, EGL_TRUE, EGL_NONE};
+    EGLImageKHR image = mFunctions.createImage(mDisplay, EGL_NO_CONTEXT,
+                                               EGL_NATIVE_BUFFER_ANDROID, clientBuffer,
+                                               imageAttrs);
+    if (image == EGL_NO_IMAGE_KHR) {
+        return nullptr;
+    }
+    mCreatedCount++;
+
+    if (mEntries.size() >= mCapacity) {
+        auto oldest = mEntries.begin();
+        for (auto candidate = mEntries.begin(); candidate != mEntries.end(); ++candidate) {
+            if (candidate->second.lastUse < oldest->second.lastUse) {
+                oldest = candidate;
+            }
+        }
+        destroy(oldest->first, oldest->second);
+        mEntries.erase(oldest);
+    }
+
+    Entry entry;
+    entry.image = image;
+    entry.lastUse = ++mUseCounter;
+    mFunctions.genTextures(1, &entry.texture);
+    mFunctions.bindTexture(GL_TEXTURE_2D, entry.texture);
+    mFunctions.imageTargetTexture2D(GL_TEXTURE_2D, static_cast<GLeglImageOES>(image));
+    mFunctions.acquireBuffer(buffer);
+    return &mEntries.emplace(buffer, entry).first->second;
+}
+
+bool EGLImageCache::evict(AHardwareBuffer* buffer) {
+    auto it = mEntries.find(buffer);
+    if (it == mEntries.end()) {
+        return false;
+    }
+    destroy(it->first, it->second);
+    mEntries.erase(it);
+    return true;
+}
+
+void EGLImageCache::clear() {
+    for (auto& it : mEntries) {
+        destroy(it.first, it.second);
+    }
+    mEntries.clear();
+}
+
+void EGLImageCache::destroy(AHardwareBuffer* buffer, const Entry& entry) {
+    mFunctions.deleteTextures(1, &entry.texture);
+    mFunctions.destroyImage(mDisplay, entry.image);
+    mFunctions.releaseBuffer(buffer);
+}
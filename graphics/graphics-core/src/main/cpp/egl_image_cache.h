@@ -0,0 +1,118 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROIDX_EGL_IMAGE_CACHE_H
+#define ANDROIDX_EGL_IMAGE_CACHE_H
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GLES2/gl2.h>
+#include <GLES2/gl2ext.h>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+struct AHardwareBuffer;
+
+/**
+ * EGL, GL and AHardwareBuffer functions used by EGLImageCache. They are passed in rather than
+ * called directly so that the cache can be exercised against fakes off device.
+ */
+struct EGLImageFunctions {
+    void (*acquireBuffer)(AHardwareBuffer* buffer) = nullptr;
+    void (*releaseBuffer)(AHardwareBuffer* buffer) = nullptr;
+    EGLClientBuffer (*getNativeClientBuffer)(const AHardwareBuffer* buffer) = nullptr;
+    EGLImageKHR (*createImage)(EGLDisplay display, EGLContext context, EGLenum target,
+            EGLClientBuffer buffer, const EGLint* attrs) = nullptr;
+    EGLBoolean (*destroyImage)(EGLDisplay display, EGLImageKHR image) = nullptr;
+    void (*genTextures)(GLsizei count, GLuint* textures) = nullptr;
+    void (*deleteTextures)(GLsizei count, const GLuint* textures) = nullptr;
+    void (*bindTexture)(GLenum target, GLuint texture) = nullptr;
+    void (*imageTargetTexture2D)(GLenum target, GLeglImageOES image) = nullptr;
+};
+
+/**
+ * Caches the EGLImage and the GL texture created for each AHardwareBuffer, so that code receiving
+ * the same few buffers every frame, without keeping a wrapper per buffer as FrameBuffer does,
+ * does not create and destroy an EGLImage each time.
+ *
+ * Each cached buffer is acquired by the cache and released on eviction, so that its address
+ * cannot be reused by another buffer while it is used as a key. Buffers that are retired must be
+ * evicted explicitly, otherwise they remain allocated until the least recently used entry is
+ * evicted to make room for a new buffer, or the cache is cleared.
+ *
+ * The cache is not thread safe. It must be used on the thread where the EGL context owning the
+ * textures is current, as eviction deletes textures.
+ */
+class EGLImageCache {
+public:
+    struct Entry {
+        EGLImageKHR image = EGL_NO_IMAGE_KHR;
+        GLuint texture = 0;
+        // Value of the use counter the last time the entry was looked up
+        uint64_t lastUse = 0;
+    };
+
+    EGLImageCache(const EGLImageFunctions& functions, EGLDisplay display, size_t capacity);
+
+    /**
+     * Evicts all the entries
+     */
+    ~EGLImageCache();
+
+    EGLImageCache(const EGLImageCache&) = delete;
+    EGLImageCache& operator=(const EGLImageCache&) = delete;
+
+    /**
+     * Returns the entry of the given buffer, creating its EGLImage and binding it to a new
+     * GL_TEXTURE_2D texture on a miss. The least recently used entry is evicted first if the
+     * cache is full.
+     * @return nullptr if the EGLImage cannot be created
+     */
+    const Entry* get(AHardwareBuffer* buffer);
+
+    /**
+     * Destroys the EGLImage and the texture of the given buffer, and releases it
+     * @return false if the buffer is not cached
+     */
+    bool evict(AHardwareBuffer* buffer);
+
+    /**
+     * Evicts all the entries
+     */
+    void clear();
+
+    size_t size() const { return mEntries.size(); }
+
+    size_t capacity() const { return mCapacity; }
+
+    /**
+     * Number of EGLImages created over the lifetime of the cache, for diagnostics
+     */
+    uint64_t createdCount() const { return mCreatedCount; }
+
+private:
+    void destroy(AHardwareBuffer* buffer, const Entry& entry);
+
+    EGLImageFunctions mFunctions;
+    EGLDisplay mDisplay;
+    size_t mCapacity;
+    std::unordered_map<AHardwareBuffer*, Entry> mEntries;
+    uint64_t mUseCounter = 0;
+    uint64_t mCreatedCount = 0;
+};
+
+#endif //ANDROIDX_EGL_IMAGE_CACHE_H
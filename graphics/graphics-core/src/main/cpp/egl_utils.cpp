@@ -27,6 +27,7 @@
 #include <android/hardware_buffer_jni.h>
 #include <mutex>
 #include "egl_utils.h"
+#include "egl_image_cache.h"
 
 #define EGL_UTILS "EglUtils"
 #define ALOGE(...) __android_log_print(ANDROID_LOG_ERROR, EGL_UTILS, __VA_ARGS__)
@@ -431,6 +432,74 @@ jboolean EGLBindings_nDestroySyncKHR(
     return static_cast<jboolean>(eglDestroySyncKHR(display, sync));
 }
 
+/**
+ * Resolves the functions used by EGLImageCache, returns false if the EGLImage extensions are not
+ * supported on the device
+ */
+static bool obtainEGLImageFunctions(EGLImageFunctions* functions) {
+    static std::once_flag eglImageFunctionsFlag;
+    static EGLImageFunctions resolved;
+    std::call_once(eglImageFunctionsFlag, [](){
+        resolved.acquireBuffer = AHardwareBuffer_acquire;
+        resolved.releaseBuffer = AHardwareBuffer_release;
+        resolved.getNativeClientBuffer = obtainEglGetNativeClientBufferANDROID();
+        resolved.createImage = obtainEglCreateImageKHR();
+        resolved.destroyImage = obtainEglDestroyImageKHR();
+        resolved.genTextures = glGenTextures;
+        resolved.deleteTextures = glDeleteTextures;
+        resolved.bindTexture = glBindTexture;
+        resolved.imageTargetTexture2D = obtainGlImageTargetTexture2DOES();
+    });
+    if (!resolved.getNativeClientBuffer || !resolved.createImage || !resolved.destroyImage ||
+        !resolved.imageTargetTexture2D) {
+        return false;
+    }
+    *functions = resolved;
+    return true;
+}
+
+jlong EGLBindings_nCreateImageCache(JNIEnv *env, jclass, jlong egl_display_ptr, jint capacity) {
+    EGLImageFunctions functions;
+    if (!obtainEGLImageFunctions(&functions)) {
+        ALOGE("Unable to resolve the EGLImage extensions required by the image cache");
+        return 0;
+    }
+    auto display = reinterpret_cast<EGLDisplay>(egl_display_ptr);
+    auto cache = new EGLImageCache(functions, display, static_cast<size_t>(capacity));
+    return reinterpret_cast<jlong>(cache);
+}
+
+void EGLBindings_nDestroyImageCache(JNIEnv *env, jclass, jlong cache_ptr) {
+    delete reinterpret_cast<EGLImageCache *>(cache_ptr);
+}
+
+jint EGLBindings_nImageCacheGetTexture(JNIEnv *env, jclass, jlong cache_ptr,
+                                       jobject hardware_buffer) {
+    auto cache = reinterpret_cast<EGLImageCache *>(cache_ptr);
+    AHardwareBuffer *buffer = AHardwareBuffer_fromHardwareBuffer(env, hardware_buffer);
+    const EGLImageCache::Entry *entry = cache->get(buffer);
+    return entry != nullptr ? static_cast<jint>(entry->texture) : 0;
+}
+
+jboolean EGLBindings_nImageCacheEvict(JNIEnv *env, jclass, jlong cache_ptr,
+                                      jobject hardware_buffer) {
+    auto cache = reinterpret_cast<EGLImageCache *>(cache_ptr);
+    AHardwareBuffer *buffer = AHardwareBuffer_fromHardwareBuffer(env, hardware_buffer);
+    return static_cast<jboolean>(cache->evict(buffer));
+}
+
+void EGLBindings_nImageCacheClear(JNIEnv *env, jclass, jlong cache_ptr) {
+    reinterpret_cast<EGLImageCache *>(cache_ptr)->clear();
+}
+
+jint EGLBindings_nImageCacheSize(JNIEnv *env, jclass, jlong cache_ptr) {
+    return static_cast<jint>(reinterpret_cast<EGLImageCache *>(cache_ptr)->size());
+}
+
+jlong EGLBindings_nImageCacheCreatedCount(JNIEnv *env, jclass, jlong cache_ptr) {
+    return static_cast<jlong>(reinterpret_cast<EGLImageCache *>(cache_ptr)->createdCount());
+}
+
 /**
  * Helper method used in testing to verify if the eglGetNativeClientBufferANDROID method
  * is actually supported on the Android device.
@@ -523,6 +592,41 @@ static const JNINativeMethod EGL_METHOD_TABLE[] = {
             "(JJ)Z",
             (void*)EGLBindings_nDestroyImageKHR
         },
+        {
+            "nCreateImageCache",
+            "(JI)J",
+            (void*)EGLBindings_nCreateImageCache
+        },
+        {
+            "nDestroyImageCache",
+            "(J)V",
+            (void*)EGLBindings_nDestroyImageCache
+        },
+        {
+            "nImageCacheGetTexture",
+            "(JLandroid/hardware/HardwareBuffer;)I",
+            (void*)EGLBindings_nImageCacheGetTexture
+        },
+        {
+            "nImageCacheEvict",
+            "(JLandroid/hardware/HardwareBuffer;)Z",
+            (void*)EGLBindings_nImageCacheEvict
+        },
+        {
+            "nImageCacheClear",
+            "(J)V",
+            (void*)EGLBindings_nImageCacheClear
+        },
+        {
+            "nImageCacheSize",
+            "(J)I",
+            (void*)EGLBindings_nImageCacheSize
+        },
+        {
+            "nImageCacheCreatedCount",
+            "(J)J",
+            (void*)EGLBindings_nImageCacheCreatedCount
+        },
         {
             "nImageTargetTexture2DOES",
             "(IJ)V",
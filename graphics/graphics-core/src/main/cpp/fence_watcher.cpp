@@ -0,0 +1,324 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "fence_watcher.h"
+#include "sync_fence.h"
+
+#include <android/log.h>
+#include <errno.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <ctime>
+#include <unistd.h>
+
+#define FENCE_WATCHER "FENCE_WATCHER"
+#define ALOGE(msg, ...) \
+    __android_log_print(ANDROID_LOG_ERROR, FENCE_WATCHER, (msg), __VA_ARGS__)
+
+// Epoll key of the wake up eventfd, fence keys start at 1
+static constexpr uint64_t WAKE_KEY = 0;
+static constexpr int MAX_EVENTS = 16;
+
+static int64_t monotonic_time() {
+    struct timespec time{};
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return static_cast<int64_t>(time.tv_sec) * 1000000000LL + time.tv_nsec;
+}
+
+FenceWatcher::FenceWatcher(const Callbacks& callbacks) : mCallbacks(callbacks) {}
+
+FenceWatcher::~FenceWatcher() {
+    if (mThread.joinable()) {
+        uint64_t value = 1;
+        write(mWakeFd, &value, sizeof(value));
+        mThread.join();
+    }
+
+    for (auto& entry : mFences) {
+        close(entry.second.fd);
+    }
+    mFences.clear();
+
+    if (mWakeFd != -1) {
+        close(mWakeFd);
+    }
+    if (mEpollFd != -1) {
+        close(mEpollFd);
+    }
+}
+
+bool FenceWatcher::start() {
+    mEpollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (mEpollFd == -1) {
+        ALOGE("Unable to create epoll instance, errno: <%d>", errno);
+        return false;
+    }
+
+    mWakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (mWakeFd == -1) {
+        ALOGE("Unable to create eventfd, errno: <%d>", errno);
+        return false;
+    }
+
+    struct epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.u64 = WAKE_KEY;
+    if (epoll_ctl(mEpollFd, EPOLL_CTL_ADD, mWakeFd, &event) == -1) {
+        ALOGE("Unable to watch eventfd, errno: <%d>", errno);
+        return false;
+    }
+
+    mThread = std::thread([this]() { run(); });
+    return true;
+}
+
+bool FenceWatcher::watch(int fd, int64_t id) {
+    if (fd < 0 || mEpollFd == -1) {
+        if (fd >= 0) close(fd);
+        return false;
+    }
+
+    // The fence is registered before epoll_ctl so that the watcher thread, which may receive its
+    // event before epoll_ctl returns, always finds it
+    uint64_t key;
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        key = mNextKey++;
+        mFences[key] = Fence{fd, id};
+    }
+
+    // Fences only signal once, epoll stops reporting them after their first event
+    struct epoll_event event{};
+    event.events = EPOLLIN | EPOLLONESHOT;
+    event.data.u64 = key;
+    if (epoll_ctl(mEpollFd, EPOLL_CTL_ADD, fd, &event) == -1) {
+        ALOGE("Unable to watch fd: <%d>", fd);
+        std::lock_guard<std::mutex> lock(mLock);
+        mFences.erase(key);
+        close(fd);
+        return false;
+    }
+    return true;
+}
+
+bool FenceWatcher::isWatcherThread() const {
+    return mThread.get_id() == std::this_thread::get_id();
+}
+
+size_t FenceWatcher::pendingCount() {
+    std::lock_guard<std::mutex> lock(mLock);
+    return mFences.size();
+}
+
+void FenceWatcher::run() {
+    if (mCallbacks.onThreadStart) {
+        mCallbacks.onThreadStart(mCallbacks.context);
+    }
+
+    struct epoll_event events[MAX_EVENTS];
+    bool running = true;
+    while (running) {
+        int count = epoll_wait(mEpollFd, events, MAX_EVENTS, -1);
+        if (count == -1) {
+            if (errno == EINTR) continue;
+            ALOGE("epoll_wait failed, errno: <%d>", errno);
+            break;
+        }
+
+        for (int i = 0; i < count; i++) {
+            if (events[i].data.u64 == WAKE_KEY) {
+                running = false;
+            } else {
+                dispatch(events[i].data.u64, events[i].events);
+            }
+        }
+    }
+
+    if (mCallbacks.onThreadStop) {
+        mCallbacks.onThreadStop(mCallbacks.context);
+    }
+}
+
+void FenceWatcher::dispatch(uint64_t key, uint32_t events) {
+    Fence fence{};
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        auto entry = mFences.find(key);
+        if (entry == mFences.end()) {
+            return;
+        }
+        fence = entry->second;
+        mFences.erase(entry);
+    }
+
+    int64_t signalTime;
+    if (events & EPOLLERR) {
+        signalTime = SIGNAL_TIME_INVALID;
+    } else {
+        // Stand-ins for fences such as pipes, and devices where libsync cannot be resolved, do
+        // not report a signal time, fall back to the time the event was received
+        signalTime = getSyncFenceSignalTime(fence.fd);
+        if (signalTime == SIGNAL_TIME_INVALID || signalTime == SIGNAL_TIME_PENDING) {
+            signalTime = monotonic_time();
+        }
+    }
+
+    epoll_ctl(mEpollFd, EPOLL_CTL_DEL, fence.fd, nullptr);
+    close(fence.fd);
+
+    if (mCallbacks.onSignaled) {
+        mCallbacks.onSignaled(mCallbacks.context, fence.id, signalTime);
+    }
+}
+
+/**
+ * FenceWatcher bound to a SyncFenceWatcher instance, whose onFenceSignaled method is invoked from
+ * the watcher thread once attached to the VM
+ */
+struct JniFenceWatcher {
+    JavaVM* vm = nullptr;
+    jobject object = nullptr;
+    jmethodID onFenceSignaled = nullptr;
+    JNIEnv* threadEnv = nullptr;
+    FenceWatcher watcher;
+
+    JniFenceWatcher();
+};
+
+static void onWatcherThreadStart(void* context) {
+    auto* jniWatcher = static_cast<JniFenceWatcher*>(context);
+    JavaVMAttachArgs args{JNI_VERSION_1_6, "SyncFenceWatcher", nullptr};
+    if (jniWatcher->vm->AttachCurrentThread(&jniWatcher->threadEnv, &args) != JNI_OK) {
+        ALOGE("Unable to attach watcher thread: <%d>", errno);
+        jniWatcher->threadEnv = nullptr;
+    }
+}
+
+static void onWatcherThreadStop(void* context) {
+    auto* jniWatcher = static_cast<JniFenceWatcher*>(context);
+    if (jniWatcher->threadEnv != nullptr) {
+        jniWatcher->vm->DetachCurrentThread();
+        jniWatcher->threadEnv = nullptr;
+    }
+}
+
+static void onWatcherFenceSignaled(void* context, int64_t id, int64_t signalTime) {
+    auto* jniWatcher = static_cast<JniFenceWatcher*>(context);
+    JNIEnv* env = jniWatcher->threadEnv;
+    if (env == nullptr) {
+        return;
+    }
+    env->CallVoidMethod(jniWatcher->object, jniWatcher->onFenceSignaled,
+                        static_cast<jlong>(id), static_cast<jlong>(signalTime));
+    if (env->ExceptionCheck()) {
+        // Exceptions thrown by a callback must not stop the dispatch of the other fences
+        env->ExceptionDescribe();
+        env->ExceptionClear();
+    }
+}
+
+JniFenceWatcher::JniFenceWatcher() : watcher({
+        this, onWatcherThreadStart, onWatcherThreadStop, onWatcherFenceSignaled}) {}
+
+jlong SyncFenceWatcher_nCreate(JNIEnv* env, jobject thiz) {
+    jclass clazz = env->GetObjectClass(thiz);
+    jmethodID onFenceSignaled = env->GetMethodID(clazz, "onFenceSignaled", "(JJ)V");
+    env->DeleteLocalRef(clazz);
+    if (onFenceSignaled == nullptr) {
+        return 0;
+    }
+
+    auto* jniWatcher = new JniFenceWatcher();
+    env->GetJavaVM(&jniWatcher->vm);
+    jniWatcher->object = env->NewGlobalRef(thiz);
+    jniWatcher->onFenceSignaled = onFenceSignaled;
+
+    if (!jniWatcher->watcher.start()) {
+        env->DeleteGlobalRef(jniWatcher->object);
+        delete jniWatcher;
+        return 0;
+    }
+    return reinterpret_cast<jlong>(jniWatcher);
+}
+
+void SyncFenceWatcher_nDestroy(JNIEnv* env, jobject, jlong watcher) {
+    auto* jniWatcher = reinterpret_cast<JniFenceWatcher*>(watcher);
+    if (jniWatcher->watcher.isWatcherThread()) {
+        // Joining the watcher thread from itself would deadlock, SyncFenceWatcher.close()
+        // prevents this
+        ALOGE("SyncFenceWatcher closed from its own thread: <%p>", jniWatcher);
+        return;
+    }
+    jobject object = jniWatcher->object;
+    delete jniWatcher;
+    env->DeleteGlobalRef(object);
+}
+
+jboolean SyncFenceWatcher_nWatch(JNIEnv*, jobject, jlong watcher, jint fd, jlong id) {
+    auto* jniWatcher = reinterpret_cast<JniFenceWatcher*>(watcher);
+    return static_cast<jboolean>(jniWatcher->watcher.watch(fd, id));
+}
+
+jint SyncFenceWatcher_nPendingCount(JNIEnv*, jobject, jlong watcher) {
+    auto* jniWatcher = reinterpret_cast<JniFenceWatcher*>(watcher);
+    return static_cast<jint>(jniWatcher->watcher.pendingCount());
+}
+
+jboolean SyncFenceWatcher_nIsWatcherThread(JNIEnv*, jobject, jlong watcher) {
+    auto* jniWatcher = reinterpret_cast<JniFenceWatcher*>(watcher);
+    return static_cast<jboolean>(jniWatcher->watcher.isWatcherThread());
+}
+
+static const JNINativeMethod FENCE_WATCHER_METHOD_TABLE[] = {
+        {
+            "nCreate",
+            "()J",
+            (void*)SyncFenceWatcher_nCreate
+        },
+        {
+            "nDestroy",
+            "(J)V",
+            (void*)SyncFenceWatcher_nDestroy
+        },
+        {
+            "nWatch",
+            "(JIJ)Z",
+            (void*)SyncFenceWatcher_nWatch
+        },
+        {
+            "nPendingCount",
+            "(J)I",
+            (void*)SyncFenceWatcher_nPendingCount
+        },
+        {
+            "nIsWatcherThread",
+            "(J)Z",
+            (void*)SyncFenceWatcher_nIsWatcherThread
+        }
+};
+
+jint loadFenceWatcherMethods(JNIEnv* env) {
+    jclass fenceWatcherClass = env->FindClass("androidx/hardware/SyncFenceWatcher");
+    if (fenceWatcherClass == nullptr) {
+        return JNI_ERR;
+    }
+
+    if (env->RegisterNatives(fenceWatcherClass, FENCE_WATCHER_METHOD_TABLE,
+                    sizeof(FENCE_WATCHER_METHOD_TABLE) / sizeof(JNINativeMethod)) != JNI_OK) {
+        return JNI_ERR;
+    }
+
+    return JNI_OK;
+}
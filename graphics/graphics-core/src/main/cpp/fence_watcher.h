@@ -0,0 +1,101 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROIDX_FENCE_WATCHER_H
+#define ANDROIDX_FENCE_WATCHER_H
+
+#include <jni.h>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+/**
+ * Watches fences on a single thread driven by epoll, instead of parking one thread per fence in
+ * sync_wait. Fences can be added from any thread. Once a fence signals, its file descriptor is
+ * closed and the signal callback is invoked on the watcher thread with the time at which the fence
+ * signaled, in the CLOCK_MONOTONIC time domain.
+ */
+class FenceWatcher {
+public:
+    struct Callbacks {
+        void* context = nullptr;
+        /**
+         * Invoked on the watcher thread before it starts watching, and right before it exits
+         */
+        void (*onThreadStart)(void* context) = nullptr;
+        void (*onThreadStop)(void* context) = nullptr;
+        /**
+         * Invoked on the watcher thread when the fence registered with the given id signals.
+         * signalTime is SIGNAL_TIME_INVALID if the fence is in an error state.
+         */
+        void (*onSignaled)(void* context, int64_t id, int64_t signalTime) = nullptr;
+    };
+
+    explicit FenceWatcher(const Callbacks& callbacks);
+
+    /**
+     * Stops the watcher thread and closes the file descriptors of the fences that are still
+     * pending, their callbacks are never invoked.
+     */
+    ~FenceWatcher();
+
+    /**
+     * Starts the watcher thread
+     * @return false if the epoll instance cannot be created
+     */
+    bool start();
+
+    /**
+     * Watches the fence backed by the given file descriptor, whose ownership is transferred to the
+     * watcher. The id is passed back to the signal callback.
+     * @return false if the fence cannot be watched, the file descriptor is then closed
+     */
+    bool watch(int fd, int64_t id);
+
+    /**
+     * Returns true if called from the watcher thread, from a signal callback
+     */
+    bool isWatcherThread() const;
+
+    /**
+     * Returns the number of fences that have not signaled yet
+     */
+    size_t pendingCount();
+
+private:
+    void run();
+    void dispatch(uint64_t key, uint32_t events);
+
+    Callbacks mCallbacks;
+    int mEpollFd = -1;
+    // eventfd used to wake the watcher thread up when it needs to exit
+    int mWakeFd = -1;
+    std::thread mThread;
+
+    std::mutex mLock;
+    // Fences being watched, by epoll key
+    struct Fence {
+        int fd;
+        int64_t id;
+    };
+    std::unordered_map<uint64_t, Fence> mFences;
+    uint64_t mNextKey = 1;
+};
+
+jint loadFenceWatcherMethods(JNIEnv* env);
+
+#endif //ANDROIDX_FENCE_WATCHER_H
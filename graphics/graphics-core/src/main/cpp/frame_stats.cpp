@@ -0,0 +1,305 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "frame_stats.h"
+#include "sync_fence.h"
+
+#include <algorithm>
+#include <ctime>
+#include <iterator>
+#include <unistd.h>
+
+static int64_t monotonic_time() {
+    struct timespec time{};
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return static_cast<int64_t>(time.tv_sec) * 1000000000LL + time.tv_nsec;
+}
+
+static int64_t fence_signal_time(int fd) {
+    return fd < 0 ? SIGNAL_TIME_INVALID : getSyncFenceSignalTime(fd);
+}
+
+TransactionStatsSnapshot::TransactionStatsSnapshot(ASurfaceTransactionStats* stats)
+        : mStats(stats),
+          mLatchTime(ASurfaceTransactionStats_getLatchTime(stats)),
+          mPresentFenceFd(ASurfaceTransactionStats_getPresentFenceFd(stats)) {
+    ASurfaceTransactionStats_getASurfaceControls(stats, &mSurfaceControls, &mSurfaceControlCount);
+    size_t count = std::min(mSurfaceControlCount, MAX_LAYERS);
+    for (size_t i = 0; i < count; i++) {
+        ASurfaceControl* sc = mSurfaceControls[i];
+        mLayers[i].surfaceControl = sc;
+        mLayers[i].acquireTime = ASurfaceTransactionStats_getAcquireTime(stats, sc);
+        mLayers[i].releaseFenceFd = ASurfaceTransactionStats_getPreviousReleaseFenceFd(stats, sc);
+    }
+}
+
+TransactionStatsSnapshot::~TransactionStatsSnapshot() {
+    size_t count = std::min(mSurfaceControlCount, MAX_LAYERS);
+    for (size_t i = 0; i < count; i++) {
+        if (mLayers[i].releaseFenceFd >= 0) {
+            close(mLayers[i].releaseFenceFd);
+        }
+    }
+    if (mPresentFenceFd >= 0) {
+        close(mPresentFenceFd);
+    }
+    if (mSurfaceControls != nullptr) {
+        ASurfaceTransactionStats_releaseASurfaceControls(mSurfaceControls);
+    }
+}
+
+int TransactionStatsSnapshot::dupReleaseFenceFd(ASurfaceControl* surfaceControl) const {
+    size_t count = std::min(mSurfaceControlCount, MAX_LAYERS);
+    for (size_t i = 0; i < count; i++) {
+        if (mLayers[i].surfaceControl == surfaceControl) {
+            int fd = mLayers[i].releaseFenceFd;
+            return fd >= 0 ? dup(fd) : -1;
+        }
+    }
+    // Querying a layer that is not part of the transaction crashes, so only layers returned by
+    // the stats are queried
+    for (size_t i = count; i < mSurfaceControlCount; i++) {
+        if (mSurfaceControls[i] == surfaceControl) {
+            return ASurfaceTransactionStats_getPreviousReleaseFenceFd(mStats, surfaceControl);
+        }
+    }
+    return -1;
+}
+
+FrameStatsRing::FrameStatsRing(size_t capacity) {
+    size_t size = 1;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    mSlots.reset(new Slot[size]);
+    for (size_t i = 0; i < size; i++) {
+        mSlots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    mMask = size - 1;
+}
+
+void PendingFrameRecord::closeFences() {
+    if (presentFenceFd >= 0) {
+        close(presentFenceFd);
+    }
+    for (int fd : releaseFenceFds) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+}
+
+bool FrameStatsRing::push(const PendingFrameRecord& record) {
+    size_t position = mPushPosition.load(std::memory_order_relaxed);
+    for (;;) {
+        Slot& slot = mSlots[position & mMask];
+        size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+        if (diff == 0) {
+            // The slot is free, claim it
+            if (mPushPosition.compare_exchange_weak(position, position + 1,
+                                                    std::memory_order_relaxed)) {
+                slot.record = record;
+                slot.sequence.store(position + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            // The slot still holds the record pushed one lap earlier
+            return false;
+        } else {
+            position = mPushPosition.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool FrameStatsRing::pop(PendingFrameRecord* record) {
+    size_t position = mPopPosition.load(std::memory_order_relaxed);
+    for (;;) {
+        Slot& slot = mSlots[position & mMask];
+        size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+        if (diff == 0) {
+            if (mPopPosition.compare_exchange_weak(position, position + 1,
+                                                   std::memory_order_relaxed)) {
+                *record = slot.record;
+                slot.sequence.store(position + mMask + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            // Nothing was pushed to the slot yet
+            return false;
+        } else {
+            position = mPopPosition.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void FrameStatsCollector::registerTransaction(ASurfaceTransaction* transaction) {
+    acquire();
+    ASurfaceTransaction_setOnComplete(transaction, this, onTransactionComplete);
+}
+
+void FrameStatsCollector::onTransactionComplete(void* context,
+                                                ASurfaceTransactionStats* stats) {
+    auto* collector = reinterpret_cast<FrameStatsCollector*>(context);
+    TransactionStatsSnapshot snapshot(stats);
+    collector->record(snapshot);
+    collector->release();
+}
+
+// Samples the signal time of a fence, duplicating it into pendingFd if it has not signaled yet
+static int64_t sample_fence(int fd, int* pendingFd) {
+    const int64_t time = fence_signal_time(fd);
+    *pendingFd = time == SIGNAL_TIME_PENDING ? dup(fd) : -1;
+    return time;
+}
+
+// Resolves the signal time of a fence that was pending when sampled, and closes it
+static void resolve_fence(int* pendingFd, int64_t* time) {
+    if (*pendingFd >= 0) {
+        *time = getSyncFenceSignalTime(*pendingFd);
+        close(*pendingFd);
+        *pendingFd = -1;
+    }
+}
+
+FrameStatsCollector::~FrameStatsCollector() {
+    PendingFrameRecord pending;
+    while (mRing.pop(&pending)) {
+        pending.closeFences();
+    }
+}
+
+void FrameStatsCollector::record(const TransactionStatsSnapshot& snapshot) {
+    PendingFrameRecord pending{};
+    std::fill(std::begin(pending.releaseFenceFds), std::end(pending.releaseFenceFds), -1);
+    FrameRecord& record = pending.record;
+    record.completeTime = monotonic_time();
+    record.latchTime = snapshot.latchTime();
+    record.presentTime = sample_fence(snapshot.presentFenceFd(), &pending.presentFenceFd);
+    record.layerCount = static_cast<int64_t>(snapshot.layerCount());
+    size_t count = std::min(snapshot.layerCount(), FrameRecord::MAX_LAYERS);
+    for (size_t i = 0; i < count; i++) {
+        const auto& layer = snapshot.layer(i);
+        record.layers[i].surfaceControl = reinterpret_cast<int64_t>(layer.surfaceControl);
+        record.layers[i].acquireTime = layer.acquireTime;
+        record.layers[i].releaseTime =
+                sample_fence(layer.releaseFenceFd, &pending.releaseFenceFds[i]);
+    }
+    if (!mRing.push(pending)) {
+        pending.closeFences();
+        mDroppedCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+size_t FrameStatsCollector::drain(FrameRecord* records, size_t maxRecords) {
+    size_t count = 0;
+    PendingFrameRecord pending;
+    while (count < maxRecords && mRing.pop(&pending)) {
+        FrameRecord& record = pending.record;
+        resolve_fence(&pending.presentFenceFd, &record.presentTime);
+        for (size_t i = 0; i < FrameRecord::MAX_LAYERS; i++) {
+            resolve_fence(&pending.releaseFenceFds[i], &record.layers[i].releaseTime);
+        }
+        records[count++] = record;
+    }
+    return count;
+}
+
+void FrameStatsCollector::release() {
+    if (mRefCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        delete this;
+    }
+}
+
+// Records copied to the Java array per JNI call when draining
+static constexpr size_t DRAIN_BATCH_SIZE = 16;
+
+jlong FrameStatsCollector_nCreate(JNIEnv*, jclass, jint capacity) {
+    return reinterpret_cast<jlong>(new FrameStatsCollector(static_cast<size_t>(capacity)));
+}
+
+void FrameStatsCollector_nRelease(JNIEnv*, jclass, jlong collector) {
+    reinterpret_cast<FrameStatsCollector*>(collector)->release();
+}
+
+void FrameStatsCollector_nRegisterTransaction(JNIEnv*, jclass, jlong collector,
+                                              jlong surfaceTransaction) {
+    reinterpret_cast<FrameStatsCollector*>(collector)->registerTransaction(
+            reinterpret_cast<ASurfaceTransaction*>(surfaceTransaction));
+}
+
+jint FrameStatsCollector_nDrain(JNIEnv* env, jclass, jlong collector, jlongArray records,
+                                jint maxRecords) {
+    auto* frameStatsCollector = reinterpret_cast<FrameStatsCollector*>(collector);
+    FrameRecord batch[DRAIN_BATCH_SIZE];
+    size_t total = 0;
+    while (total < static_cast<size_t>(maxRecords)) {
+        size_t count = frameStatsCollector->drain(
+                batch, std::min(DRAIN_BATCH_SIZE, static_cast<size_t>(maxRecords) - total));
+        if (count == 0) {
+            break;
+        }
+        env->SetLongArrayRegion(records, static_cast<jsize>(total * FRAME_RECORD_LONGS),
+                                static_cast<jsize>(count * FRAME_RECORD_LONGS),
+                                reinterpret_cast<const jlong*>(batch));
+        total += count;
+    }
+    return static_cast<jint>(total);
+}
+
+jlong FrameStatsCollector_nDroppedCount(JNIEnv*, jclass, jlong collector) {
+    return reinterpret_cast<FrameStatsCollector*>(collector)->droppedCount();
+}
+
+static const JNINativeMethod FRAME_STATS_METHOD_TABLE[] = {
+        {
+                "nCreate",
+                "(I)J",
+                (void *) FrameStatsCollector_nCreate
+        },
+        {
+                "nRelease",
+                "(J)V",
+                (void *) FrameStatsCollector_nRelease
+        },
+        {
+                "nRegisterTransaction",
+                "(JJ)V",
+                (void *) FrameStatsCollector_nRegisterTransaction
+        },
+        {
+                "nDrain",
+                "(J[JI)I",
+                (void *) FrameStatsCollector_nDrain
+        },
+        {
+                "nDroppedCount",
+                "(J)J",
+                (void *) FrameStatsCollector_nDroppedCount
+        }
+};
+
+jint loadFrameStatsMethods(JNIEnv* env) {
+    jclass clazz = env->FindClass("androidx/graphics/surface/FrameStatsCollector");
+    if (clazz == nullptr) {
+        return JNI_ERR;
+    }
+    if (env->RegisterNatives(clazz, FRAME_STATS_METHOD_TABLE,
+                             sizeof(FRAME_STATS_METHOD_TABLE) / sizeof(JNINativeMethod)) != JNI_OK) {
+        return JNI_ERR;
+    }
+    return JNI_OK;
+}
@@ -0,0 +1,195 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROIDX_FRAME_STATS_H
+#define ANDROIDX_FRAME_STATS_H
+
+#include <jni.h>
+#include <android/surface_control.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * Statistics of a completed transaction, read once from ASurfaceTransactionStats on the callback
+ * thread so that later queries do not go back to the stats object. Snapshots live on the stack of
+ * the completion callback and own the fences they read, which are closed when they are destroyed.
+ */
+class TransactionStatsSnapshot {
+public:
+    // Layers whose stats are read up front, the release fences of the others are queried on demand
+    static constexpr size_t MAX_LAYERS = 16;
+
+    struct Layer {
+        ASurfaceControl* surfaceControl;
+        int64_t acquireTime;
+        int releaseFenceFd;
+    };
+
+    explicit TransactionStatsSnapshot(ASurfaceTransactionStats* stats);
+
+    ~TransactionStatsSnapshot();
+
+    TransactionStatsSnapshot(const TransactionStatsSnapshot&) = delete;
+    TransactionStatsSnapshot& operator=(const TransactionStatsSnapshot&) = delete;
+
+    int64_t latchTime() const { return mLatchTime; }
+
+    int presentFenceFd() const { return mPresentFenceFd; }
+
+    /**
+     * Number of layers in the transaction, the first min(layerCount, MAX_LAYERS) are available
+     * through layer()
+     */
+    size_t layerCount() const { return mSurfaceControlCount; }
+
+    const Layer& layer(size_t index) const { return mLayers[index]; }
+
+    /**
+     * Returns a duplicate of the release fence of the buffer previously latched on the given
+     * layer, to be closed by the caller, or -1 if the layer is not part of the transaction.
+     */
+    int dupReleaseFenceFd(ASurfaceControl* surfaceControl) const;
+
+private:
+    ASurfaceTransactionStats* mStats;
+    int64_t mLatchTime;
+    int mPresentFenceFd;
+    ASurfaceControl** mSurfaceControls = nullptr;
+    size_t mSurfaceControlCount = 0;
+    Layer mLayers[MAX_LAYERS];
+};
+
+/**
+ * Frame-pacing record of a completed transaction. Fence signal times are SIGNAL_TIME_PENDING if
+ * the fence had not signaled yet when the record was drained.
+ */
+struct FrameRecord {
+    // Layers recorded per frame, the first ones returned by the transaction stats
+    static constexpr size_t MAX_LAYERS = 4;
+
+    int64_t completeTime;
+    int64_t latchTime;
+    int64_t presentTime;
+    int64_t layerCount;
+    struct {
+        int64_t surfaceControl;
+        int64_t acquireTime;
+        int64_t releaseTime;
+    } layers[MAX_LAYERS];
+};
+
+// Size of a record once drained to a long array, must be kept in sync with FrameStatsCollector.kt
+static constexpr size_t FRAME_RECORD_LONGS = sizeof(FrameRecord) / sizeof(int64_t);
+
+/**
+ * Record queued until it is drained, along with duplicates of the fences that had not signaled
+ * yet when the transaction completed, or -1. The signal times of those fences are resolved when
+ * the record is drained, as the present fence in particular usually signals after the
+ * transaction completes.
+ */
+struct PendingFrameRecord {
+    FrameRecord record;
+    int presentFenceFd;
+    int releaseFenceFds[FrameRecord::MAX_LAYERS];
+
+    /**
+     * Closes the pending fences
+     */
+    void closeFences();
+};
+
+/**
+ * Bounded lock-free queue of pending frame records. Any number of threads can push and pop concurrently,
+ * each slot carries a sequence number that tells producers and consumers whose turn it is.
+ */
+class FrameStatsRing {
+public:
+    /**
+     * Creates a ring holding at least the given number of records, rounded up to a power of 2
+     */
+    explicit FrameStatsRing(size_t capacity);
+
+    /**
+     * Appends a record, returns false without blocking if the ring is full
+     */
+    bool push(const PendingFrameRecord& record);
+
+    /**
+     * Removes the oldest record, returns false without blocking if the ring is empty
+     */
+    bool pop(PendingFrameRecord* record);
+
+    size_t capacity() const { return mMask + 1; }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence;
+        PendingFrameRecord record;
+    };
+
+    std::unique_ptr<Slot[]> mSlots;
+    size_t mMask;
+    alignas(64) std::atomic<size_t> mPushPosition{0};
+    alignas(64) std::atomic<size_t> mPopPosition{0};
+};
+
+/**
+ * Collects a FrameRecord for every transaction it is registered on as a completion callback.
+ * Records are dropped, and counted, when the ring is full because they were not drained in time.
+ * The collector is reference counted, each pending transaction holds a reference so that it can
+ * be closed from Kotlin before all the transactions complete.
+ */
+class FrameStatsCollector {
+public:
+    explicit FrameStatsCollector(size_t capacity) : mRing(capacity) {}
+
+    /**
+     * Closes the pending fences of the records that were not drained
+     */
+    ~FrameStatsCollector();
+
+    /**
+     * Registers the collector as a completion callback of the given transaction
+     */
+    void registerTransaction(ASurfaceTransaction* transaction);
+
+    void record(const TransactionStatsSnapshot& snapshot);
+
+    /**
+     * Pops up to maxRecords records, resolving the signal times of their pending fences, returns
+     * the number of records popped
+     */
+    size_t drain(FrameRecord* records, size_t maxRecords);
+
+    int64_t droppedCount() const { return mDroppedCount.load(std::memory_order_relaxed); }
+
+    void acquire() { mRefCount.fetch_add(1, std::memory_order_relaxed); }
+
+    void release();
+
+private:
+    static void onTransactionComplete(void* context, ASurfaceTransactionStats* stats);
+
+    FrameStatsRing mRing;
+    std::atomic<int64_t> mDroppedCount{0};
+    std::atomic<int32_t> mRefCount{1};
+};
+
+jint loadFrameStatsMethods(JNIEnv* env);
+
+#endif //ANDROIDX_FRAME_STATS_H
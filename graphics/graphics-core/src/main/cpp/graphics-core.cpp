@@ -22,6 +22,9 @@
 #include <unistd.h>
 #include <ctime>
 #include <unistd.h>
+#include <memory>
+#include <mutex>
+#include <algorithm>
 #include <android/native_activity.h>
 #include <android/surface_control.h>
 #include <android/api-level.h>
@@ -33,6 +36,11 @@
 #include <sys/system_properties.h>
 #include "egl_utils.h"
 #include "sync_fence.h"
+#include "fence_watcher.h"
+#include "transaction_commands.h"
+#include "damage_region.h"
+#include "hardware_buffer_pixels.h"
+#include "frame_stats.h"
 
 #define ALOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
 
@@ -44,10 +52,13 @@ static struct {
     jfieldID bottom{};
 } gRectInfo;
 
+// Device API level, resolved once in JNI_OnLoad instead of on every call
+static int gDeviceApiLevel = 0;
+
 jlong JniBindings_nCreate(JNIEnv *env, jclass,
                                                    jlong surfaceControl,
                                                    jstring debug_name) {
-    if (android_get_device_api_level() >= 29) {
+    if (gDeviceApiLevel >= 29) {
         auto aSurfaceControl = reinterpret_cast<ASurfaceControl *>(surfaceControl);
         auto debugName = env->GetStringUTFChars(debug_name, nullptr);
         return reinterpret_cast<jlong>(ASurfaceControl_create(aSurfaceControl,
@@ -61,7 +72,7 @@ jlong JniBindings_nCreateFromSurface(JNIEnv *env,
                                                               jclass,
                                                               jobject surface,
                                                               jstring debug_name) {
-    if (android_get_device_api_level() >= 29) {
+    if (gDeviceApiLevel >= 29) {
         auto AWindow = ANativeWindow_fromSurface(env, surface);
         auto debugName = env->GetStringUTFChars(debug_name, nullptr);
         auto surfaceControl = reinterpret_cast<jlong>(ASurfaceControl_createFromWindow(AWindow,
@@ -74,7 +85,7 @@ jlong JniBindings_nCreateFromSurface(JNIEnv *env,
 }
 
 void JniBindings_nRelease(JNIEnv *env, jclass, jlong surfaceControl) {
-    if (android_get_device_api_level() >= 29) {
+    if (gDeviceApiLevel >= 29) {
         ASurfaceControl_release(reinterpret_cast<ASurfaceControl *>(surfaceControl));
     } else {
         return;
@@ -82,7 +93,7 @@ void JniBindings_nRelease(JNIEnv *env, jclass, jlong surfaceControl) {
 }
 
 jlong JniBindings_nTransactionCreate(JNIEnv *env, jclass) {
-    if (android_get_device_api_level() >= 29) {
+    if (gDeviceApiLevel >= 29) {
         return reinterpret_cast<jlong>(ASurfaceTransaction_create());
     } else {
         return 0;
@@ -90,20 +101,20 @@ jlong JniBindings_nTransactionCreate(JNIEnv *env, jclass) {
 }
 
 void JniBindings_nTransactionDelete(JNIEnv *env, jclass, jlong surfaceTransaction) {
-    if (android_get_device_api_level() >= 29) {
+    if (gDeviceApiLevel >= 29) {
         ASurfaceTransaction_delete(reinterpret_cast<ASurfaceTransaction *>(surfaceTransaction));
     }
 }
 
 void JniBindings_nTransactionApply(JNIEnv *env, jclass, jlong surfaceTransaction) {
-    if (android_get_device_api_level() >= 29) {
+    if (gDeviceApiLevel >= 29) {
         ASurfaceTransaction_apply(reinterpret_cast<ASurfaceTransaction *>(surfaceTransaction));
     }
 }
 
 void JniBindings_nTransactionReparent(JNIEnv *env, jclass, jlong surfaceTransaction,
                                       jlong surfaceControl, jlong newParent) {
-    if (android_get_device_api_level() >= 29) {
+    if (gDeviceApiLevel >= 29) {
         auto parent = (newParent != 0L) ? reinterpret_cast<ASurfaceControl *>(newParent) : nullptr;
         ASurfaceTransaction_reparent(reinterpret_cast<ASurfaceTransaction *>(surfaceTransaction),
                                      reinterpret_cast<ASurfaceControl *>(surfaceControl),
@@ -112,19 +123,16 @@ void JniBindings_nTransactionReparent(JNIEnv *env, jclass, jlong surfaceTransact
 }
 
 static struct {
-    bool CLASS_INFO_INITIALIZED = false;
     jclass clazz{};
     jmethodID onComplete{};
 } gTransactionCompletedListenerClassInfo;
 
 static struct {
-    bool CLASS_INFO_INITIALIZED = false;
     jclass clazz{};
     jmethodID onCommit{};
 } gTransactionCommittedListenerClassInfo;
 
 static struct {
-    bool CLASS_INFO_INITIALIZED = false;
     jclass clazz{};
     jmethodID dupeFileDescriptor{};
 } gSyncFenceClassInfo;
@@ -140,144 +148,178 @@ int64_t getSystemTime() {
     return (time.tv_sec * NANO_SECONDS) + time.tv_nsec;
 }
 
-/**
- * This wrapper class mimics the one found in CTS tests, specifcally
- * android_view_cts_ASurfaceControlTest.cpp and serves
- * to allow us to set a callback for Transaction onComplete.
- */
-class CallbackWrapper {
-public:
-    virtual ~CallbackWrapper() = default;
+static JavaVM *gVm = nullptr;
 
-    virtual void callback(ASurfaceTransactionStats *stats) = 0;
+// Env of the thread invoking transaction callbacks, resolved on its first callback. Callback
+// threads are attached to the VM for the lifetime of the process.
+static thread_local JNIEnv *tCallbackEnv = nullptr;
 
-    static void transactionCallbackThunk(void *context, ASurfaceTransactionStats *stats) {
-        CallbackWrapper *listener = reinterpret_cast<CallbackWrapper *>(context);
-        listener->callback(stats);
-        delete listener;
+static JNIEnv *getCallbackEnv() {
+    if (tCallbackEnv == nullptr) {
+        gVm->GetEnv(reinterpret_cast<void **>(&tCallbackEnv), JNI_VERSION_1_6);
     }
+    return tCallbackEnv;
+}
 
-protected:
-    JavaVM *mVm{};
-    jobject mCallbackObject{};
-
-    JNIEnv *getEnv() {
-        JNIEnv *env;
-        mVm->GetEnv(reinterpret_cast<void **>(&env), JNI_VERSION_1_6);
-        return env;
-    }
+/**
+ * Listener registered on pending transactions. A listener holds a single global ref shared by all
+ * the transactions it is registered on, released once the last of their callbacks is invoked.
+ */
+struct CallbackEntry {
+    jobject listener = nullptr;
+    int32_t pendingCount = 0;
+    bool pooled = false;
+    CallbackEntry *next = nullptr;
 };
 
-class OnCompleteCallbackWrapper : public CallbackWrapper {
+/**
+ * Registry of the listeners with pending callbacks. Entries come from a preallocated pool so that
+ * registering a callback neither allocates a wrapper nor creates a global ref in steady state,
+ * entries are only allocated on the heap once the pool is exhausted.
+ */
+class CallbackRegistry {
 public:
-    explicit OnCompleteCallbackWrapper(JNIEnv *env, jobject object) {
-        env->GetJavaVM(&mVm);
-        mCallbackObject = env->NewGlobalRef(object);
-    }
+    static constexpr size_t POOL_SIZE = 32;
 
-    ~OnCompleteCallbackWrapper() override {
-        getEnv()->DeleteGlobalRef(mCallbackObject);
-    }
-
-    void callback(ASurfaceTransactionStats *stats) override {
-        JNIEnv *env = getEnv();
-        env->CallVoidMethod(mCallbackObject,
-                            gTransactionCompletedListenerClassInfo.onComplete,
-                            reinterpret_cast<jlong>(stats));
+    CallbackRegistry() {
+        for (size_t i = 0; i < POOL_SIZE; i++) {
+            mPool[i].pooled = true;
+            mPool[i].next = mFree;
+            mFree = &mPool[i];
+        }
     }
-};
 
-class OnCommitCallbackWrapper : public CallbackWrapper {
-public:
-    explicit OnCommitCallbackWrapper(JNIEnv *env, jobject object) {
-        env->GetJavaVM(&mVm);
-        mCallbackObject = env->NewGlobalRef(object);
+    CallbackEntry *acquire(JNIEnv *env, jobject listener) {
+        std::lock_guard<std::mutex> lock(mLock);
+        for (CallbackEntry *entry = mActive; entry != nullptr; entry = entry->next) {
+            if (env->IsSameObject(entry->listener, listener)) {
+                entry->pendingCount++;
+                return entry;
+            }
+        }
+        CallbackEntry *entry = mFree;
+        if (entry != nullptr) {
+            mFree = entry->next;
+        } else {
+            entry = new CallbackEntry();
+        }
+        entry->listener = env->NewGlobalRef(listener);
+        entry->pendingCount = 1;
+        entry->next = mActive;
+        mActive = entry;
+        return entry;
     }
 
-    ~OnCommitCallbackWrapper() override {
-        getEnv()->DeleteGlobalRef(mCallbackObject);
+    void release(JNIEnv *env, CallbackEntry *entry) {
+        std::lock_guard<std::mutex> lock(mLock);
+        if (--entry->pendingCount > 0) {
+            return;
+        }
+        CallbackEntry **link = &mActive;
+        while (*link != entry) {
+            link = &(*link)->next;
+        }
+        *link = entry->next;
+        env->DeleteGlobalRef(entry->listener);
+        entry->listener = nullptr;
+        if (entry->pooled) {
+            entry->next = mFree;
+            mFree = entry;
+        } else {
+            delete entry;
+        }
     }
 
-    void callback(ASurfaceTransactionStats *stats) override {
-        JNIEnv *env = getEnv();
-        env->CallVoidMethod(mCallbackObject,
-                            gTransactionCommittedListenerClassInfo.onCommit);
-    }
+private:
+    std::mutex mLock;
+    CallbackEntry mPool[POOL_SIZE];
+    CallbackEntry *mFree = nullptr;
+    // Entries of the listeners with pending callbacks
+    CallbackEntry *mActive = nullptr;
 };
 
-void setupTransactionCompletedListenerClassInfo(JNIEnv *env) {
-    //ensure we only ever initialize class info once
-    if (!gTransactionCompletedListenerClassInfo.CLASS_INFO_INITIALIZED) {
-        //setup transactionCompleteListenerClassInfo for test usage
-        jclass transactionCompletedListenerClazz =
-                env->FindClass(
-                        "androidx/graphics/surface/"
-                        "SurfaceControlCompat$TransactionCompletedListener");
-        gTransactionCompletedListenerClassInfo.clazz =
-                static_cast<jclass>(env->NewGlobalRef(transactionCompletedListenerClazz));
-        gTransactionCompletedListenerClassInfo.onComplete =
-                env->GetMethodID(transactionCompletedListenerClazz, "onTransactionCompleted",
-                                 "(J)V");
+static CallbackRegistry gCallbackRegistry;
 
-        gTransactionCompletedListenerClassInfo.CLASS_INFO_INITIALIZED = true;
+static void onTransactionCompleteThunk(void *context, ASurfaceTransactionStats *stats) {
+    auto entry = reinterpret_cast<CallbackEntry *>(context);
+    JNIEnv *env = getCallbackEnv();
+    {
+        // Listeners receive a snapshot of the stats, read once here instead of on every query
+        TransactionStatsSnapshot snapshot(stats);
+        env->CallVoidMethod(entry->listener,
+                            gTransactionCompletedListenerClassInfo.onComplete,
+                            reinterpret_cast<jlong>(&snapshot));
     }
-
+    gCallbackRegistry.release(env, entry);
 }
 
-void setupTransactionCommittedListenerClassInfo(JNIEnv *env) {
-    //ensure we only ever initialize class info once
-    if (!gTransactionCommittedListenerClassInfo.CLASS_INFO_INITIALIZED) {
-        //setup transactionCommittedListenerClassInfo for test usage
-        jclass transactionCommittedListenerClazz =
-                env->FindClass(
-                        "androidx/graphics/surface/"
-                        "SurfaceControlCompat$TransactionCommittedListener");
-        gTransactionCommittedListenerClassInfo.clazz =
-                static_cast<jclass>(env->NewGlobalRef(transactionCommittedListenerClazz));
-        gTransactionCommittedListenerClassInfo.onCommit =
-                env->GetMethodID(transactionCommittedListenerClazz, "onTransactionCommitted",
-                                 "()V");
+static void onTransactionCommitThunk(void *context, ASurfaceTransactionStats *) {
+    auto entry = reinterpret_cast<CallbackEntry *>(context);
+    JNIEnv *env = getCallbackEnv();
+    env->CallVoidMethod(entry->listener, gTransactionCommittedListenerClassInfo.onCommit);
+    gCallbackRegistry.release(env, entry);
+}
 
-        gTransactionCommittedListenerClassInfo.CLASS_INFO_INITIALIZED = true;
+/**
+ * Resolves the classes called back from native once in JNI_OnLoad. Classes that were stripped
+ * because the app never uses them are skipped, no instance can be passed to the bindings then.
+ */
+static void loadCallbackMethod(JNIEnv *env, const char *className, const char *name,
+                               const char *signature, jclass *clazz, jmethodID *method) {
+    jclass localClazz = env->FindClass(className);
+    if (localClazz == nullptr) {
+        env->ExceptionClear();
+        return;
+    }
+    *clazz = static_cast<jclass>(env->NewGlobalRef(localClazz));
+    *method = env->GetMethodID(localClazz, name, signature);
+    if (*method == nullptr) {
+        env->ExceptionClear();
+        ALOGE("Unable to resolve %s.%s", className, name);
     }
+    env->DeleteLocalRef(localClazz);
+}
+
+void loadCallbackClassInfo(JNIEnv *env) {
+    loadCallbackMethod(env,
+                       "androidx/graphics/surface/"
+                       "SurfaceControlCompat$TransactionCompletedListener",
+                       "onTransactionCompleted", "(J)V",
+                       &gTransactionCompletedListenerClassInfo.clazz,
+                       &gTransactionCompletedListenerClassInfo.onComplete);
+    loadCallbackMethod(env,
+                       "androidx/graphics/surface/"
+                       "SurfaceControlCompat$TransactionCommittedListener",
+                       "onTransactionCommitted", "()V",
+                       &gTransactionCommittedListenerClassInfo.clazz,
+                       &gTransactionCommittedListenerClassInfo.onCommit);
+    loadCallbackMethod(env, "androidx/hardware/SyncFenceV19", "dupeFileDescriptor", "()I",
+                       &gSyncFenceClassInfo.clazz, &gSyncFenceClassInfo.dupeFileDescriptor);
 }
 
 void JniBindings_nTransactionSetOnComplete(JNIEnv *env, jclass, jlong surfaceTransaction,
                                            jobject callback) {
-    if (android_get_device_api_level() >= 29) {
-        setupTransactionCompletedListenerClassInfo(env);
-        void *context = new OnCompleteCallbackWrapper(env, callback);
+    if (gDeviceApiLevel >= 29) {
+        CallbackEntry *entry = gCallbackRegistry.acquire(env, callback);
         ASurfaceTransaction_setOnComplete(
                 reinterpret_cast<ASurfaceTransaction *>(surfaceTransaction),
-                reinterpret_cast<void *>(context),
-                CallbackWrapper::transactionCallbackThunk);
+                reinterpret_cast<void *>(entry),
+                onTransactionCompleteThunk);
     }
 }
 
 void JniBindings_nTransactionSetOnCommit(JNIEnv *env, jclass, jlong surfaceTransaction,
                                          jobject listener) {
-    if (android_get_device_api_level() >= 31) {
-        setupTransactionCommittedListenerClassInfo(env);
-        void *context = new OnCommitCallbackWrapper(env, listener);
+    if (gDeviceApiLevel >= 31) {
+        CallbackEntry *entry = gCallbackRegistry.acquire(env, listener);
         ASurfaceTransaction_setOnCommit(
                 reinterpret_cast<ASurfaceTransaction *>(surfaceTransaction),
-                reinterpret_cast<void *>(context),
-                CallbackWrapper::transactionCallbackThunk);
-    }
-}
-
-void setupSyncFenceClassInfo(JNIEnv *env) {
-    if (!gSyncFenceClassInfo.CLASS_INFO_INITIALIZED) {
-        jclass syncFenceClazz = env->FindClass("androidx/hardware/SyncFenceV19");
-        gSyncFenceClassInfo.clazz = static_cast<jclass>(env->NewGlobalRef(syncFenceClazz));
-        gSyncFenceClassInfo.dupeFileDescriptor =
-                env->GetMethodID(gSyncFenceClassInfo.clazz, "dupeFileDescriptor", "()I");
-        gSyncFenceClassInfo.CLASS_INFO_INITIALIZED = true;
+                reinterpret_cast<void *>(entry),
+                onTransactionCommitThunk);
     }
 }
 
 int dup_fence_fd(JNIEnv *env, jobject syncFence) {
-    setupSyncFenceClassInfo(env);
     return env->CallIntMethod(syncFence, gSyncFenceClassInfo.dupeFileDescriptor);
 }
 
@@ -287,26 +329,34 @@ jint JniBindings_nDupFenceFd(JNIEnv *env, jclass, jobject syncFence) {
     return dup_fence_fd(env, syncFence);
 }
 
+/**
+ * Takes ownership of acquireFenceFd, which is dup'ed on the Kotlin side so that setting a buffer
+ * does not require calling back into Java to read the fence.
+ */
 void JniBindings_nSetBuffer(JNIEnv *env, jclass, jlong surfaceTransaction,
                             jlong surfaceControl, jobject hBuffer,
-                            jobject syncFence) {
-    if (android_get_device_api_level() >= 29) {
+                            jint acquireFenceFd) {
+    if (gDeviceApiLevel >= 29) {
         auto transaction = reinterpret_cast<ASurfaceTransaction *>(surfaceTransaction);
         auto sc = reinterpret_cast<ASurfaceControl *>(surfaceControl);
         AHardwareBuffer* hardwareBuffer = nullptr;
         auto fence_fd = -1;
         if (hBuffer) {
             hardwareBuffer = AHardwareBuffer_fromHardwareBuffer(env, hBuffer);
-            fence_fd = dup_fence_fd(env, syncFence);
+            fence_fd = acquireFenceFd;
+        } else if (acquireFenceFd != -1) {
+            close(acquireFenceFd);
         }
         ASurfaceTransaction_setBuffer(transaction, sc, hardwareBuffer, fence_fd);
+    } else if (acquireFenceFd != -1) {
+        close(acquireFenceFd);
     }
 }
 
 void JniBindings_nSetVisibility(
         JNIEnv *env, jclass,
         jlong surfaceTransaction, jlong surfaceControl, jbyte jVisibility) {
-    if (android_get_device_api_level() >= 29) {
+    if (gDeviceApiLevel >= 29) {
         auto st = reinterpret_cast<ASurfaceTransaction *>(surfaceTransaction);
         auto sc = reinterpret_cast<ASurfaceControl *>(surfaceControl);
         ASurfaceTransaction_setVisibility(st, sc, jVisibility);
@@ -316,7 +366,7 @@ void JniBindings_nSetVisibility(
 void JniBindings_nSetZOrder(
         JNIEnv *env, jclass,
         jlong surfaceTransaction, jlong surfaceControl, jint z_order) {
-    if (android_get_device_api_level() >= 29) {
+    if (gDeviceApiLevel >= 29) {
         auto st = reinterpret_cast<ASurfaceTransaction *>(surfaceTransaction);
         auto sc = reinterpret_cast<ASurfaceControl *>(surfaceControl);
         ASurfaceTransaction_setZOrder(st, sc, z_order);
@@ -336,7 +386,7 @@ void JniBindings_nSetDamageRegion(
         JNIEnv *env, jclass,
         jlong surfaceTransaction, jlong surfaceControl,
         jobject rect) {
-    if (android_get_device_api_level() >= 29) {
+    if (gDeviceApiLevel >= 29) {
         auto st = reinterpret_cast<ASurfaceTransaction *>(surfaceTransaction);
         auto sc = reinterpret_cast<ASurfaceControl *>(surfaceControl);
 
@@ -351,10 +401,49 @@ void JniBindings_nSetDamageRegion(
     }
 }
 
+// Rects copied from the packed array per JNI call
+static constexpr jint DAMAGE_RECTS_CHUNK = 16;
+
+void JniBindings_nSetDamageRegions(
+        JNIEnv *env, jclass,
+        jlong surfaceTransaction, jlong surfaceControl,
+        jintArray rects, jint rectCount) {
+    if (gDeviceApiLevel >= 29) {
+        auto st = reinterpret_cast<ASurfaceTransaction *>(surfaceTransaction);
+        auto sc = reinterpret_cast<ASurfaceControl *>(surfaceControl);
+
+        if (rectCount < 0 || rectCount > env->GetArrayLength(rects) / 4) {
+            ALOGE("nSetDamageRegions: invalid rect count %d", rectCount);
+            return;
+        }
+
+        DamageRegion region;
+        jint chunk[DAMAGE_RECTS_CHUNK * 4];
+        for (jint start = 0; start < rectCount; start += DAMAGE_RECTS_CHUNK) {
+            const jint count = std::min(DAMAGE_RECTS_CHUNK, rectCount - start);
+            env->GetIntArrayRegion(rects, start * 4, count * 4, chunk);
+            for (jint i = 0; i < count; i++) {
+                const jint *rect = chunk + i * 4;
+                region.add(ARect{rect[0], rect[1], rect[2], rect[3]});
+            }
+        }
+        region.coalesce();
+
+        if (region.count() == 0) {
+            // No rects or only empty rects, nothing is damaged
+            const ARect empty{0, 0, 0, 0};
+            ASurfaceTransaction_setDamageRegion(st, sc, &empty, 1);
+        } else {
+            ASurfaceTransaction_setDamageRegion(st, sc, region.rects(),
+                                                static_cast<uint32_t>(region.count()));
+        }
+    }
+}
+
 void JniBindings_nSetDesiredPresentTime(
         JNIEnv *env, jclass,
         jlong surfaceTransaction, int64_t desiredPresentTimeNano) {
-    if (android_get_device_api_level() >= 29) {
+    if (gDeviceApiLevel >= 29) {
         ASurfaceTransaction_setDesiredPresentTime(
                 reinterpret_cast<ASurfaceTransaction *>(surfaceTransaction),
                 desiredPresentTimeNano);
@@ -364,7 +453,7 @@ void JniBindings_nSetDesiredPresentTime(
 void JniBindings_nSetBufferTransparency(
         JNIEnv *env, jclass,
         jlong surfaceTransaction, jlong surfaceControl, jbyte transparency) {
-    if (android_get_device_api_level() >= 29) {
+    if (gDeviceApiLevel >= 29) {
         ASurfaceTransaction_setBufferTransparency(
                 reinterpret_cast<ASurfaceTransaction *>(surfaceTransaction),
                 reinterpret_cast<ASurfaceControl *>(surfaceControl),
@@ -375,7 +464,7 @@ void JniBindings_nSetBufferTransparency(
 void JniBindings_nSetBufferAlpha(
         JNIEnv *env, jclass,
         jlong surfaceTransaction, jlong surfaceControl, jfloat alpha) {
-    if (android_get_device_api_level() >= 29) {
+    if (gDeviceApiLevel >= 29) {
         ASurfaceTransaction_setBufferAlpha(
                 reinterpret_cast<ASurfaceTransaction *>(surfaceTransaction),
                 reinterpret_cast<ASurfaceControl *>(surfaceControl),
@@ -464,24 +553,13 @@ jint JniBindings_nGetPreviousReleaseFenceFd(JNIEnv *env, jclass,
                                             jlong surfaceControl,
                                             jlong transactionStats) {
     auto sc = reinterpret_cast<ASurfaceControl *>(surfaceControl);
-    auto stats = reinterpret_cast<ASurfaceTransactionStats *>(transactionStats);
+    auto snapshot = reinterpret_cast<TransactionStatsSnapshot *>(transactionStats);
     int fd = -1;
-    if (stats) {
+    if (snapshot) {
         // Sometimes even though a SurfaceControl is part of a transaction it will not show up in
-        // the list of transaction provided by ASurfaceTransactionStats.
-        // So query the SurfaceControls that are within ASurfaceTransactionStats and only query
-        // getPreviousReleaseFenceFd is the target SurfaceControl is included.
-        // If we do not do this search in advance, getPreviousReleaseFenceFd will crash.
-        size_t numSurfaceControls;
-        ASurfaceControl** surfaceControls;
-        ASurfaceTransactionStats_getASurfaceControls(stats, &surfaceControls, &numSurfaceControls);
-        for (int i = 0; i < numSurfaceControls; i++) {
-            if (surfaceControls[i] == sc) {
-                fd = ASurfaceTransactionStats_getPreviousReleaseFenceFd(stats, sc);
-                break;
-            }
-        }
-        ASurfaceTransactionStats_releaseASurfaceControls(surfaceControls);
+        // the list of transaction provided by ASurfaceTransactionStats, the snapshot returns -1
+        // for those instead of querying getPreviousReleaseFenceFd, which would crash.
+        fd = snapshot->dupReleaseFenceFd(sc);
     }
     return static_cast<jint>(fd);
 }
@@ -495,7 +573,7 @@ void JniBindings_nSetFrameRate(JNIEnv *env, jclass,
     auto st = reinterpret_cast<ASurfaceTransaction *>(surfaceTransaction);
     auto sc = reinterpret_cast<ASurfaceControl *>(surfaceControl);
 
-    if (android_get_device_api_level() >= 31) {
+    if (gDeviceApiLevel >= 31) {
         ASurfaceTransaction_setFrameRateWithChangeStrategy(
                 st,
                 sc,
@@ -503,11 +581,158 @@ void JniBindings_nSetFrameRate(JNIEnv *env, jclass,
                 compatibility,
                 changeFrameRateStrategy
         );
-    } else if (android_get_device_api_level() >= 30) {
+    } else if (gDeviceApiLevel >= 30) {
         ASurfaceTransaction_setFrameRate(st, sc, framerate, compatibility);
     }
 }
 
+/**
+ * ASurfaceTransaction functions available on the device, resolved once in JNI_OnLoad
+ */
+static SurfaceTransactionFunctions gTransactionFunctions;
+
+void loadTransactionFunctions() {
+    const int apiLevel = gDeviceApiLevel;
+    auto& functions = gTransactionFunctions;
+    if (apiLevel >= 29) {
+        functions.setBuffer = [](ASurfaceTransaction *st, ASurfaceControl *sc,
+                                 AHardwareBuffer *buffer, int fenceFd) {
+            ASurfaceTransaction_setBuffer(st, sc, buffer, fenceFd);
+        };
+        functions.setVisibility = [](ASurfaceTransaction *st, ASurfaceControl *sc,
+                                     int8_t visibility) {
+            ASurfaceTransaction_setVisibility(st, sc, visibility);
+        };
+        functions.setZOrder = [](ASurfaceTransaction *st, ASurfaceControl *sc, int32_t zOrder) {
+            ASurfaceTransaction_setZOrder(st, sc, zOrder);
+        };
+        functions.setDamageRegion = [](ASurfaceTransaction *st, ASurfaceControl *sc,
+                                       const ARect *rects, uint32_t count) {
+            ASurfaceTransaction_setDamageRegion(st, sc, rects, count);
+        };
+        functions.setDesiredPresentTime = [](ASurfaceTransaction *st, int64_t time) {
+            ASurfaceTransaction_setDesiredPresentTime(st, time);
+        };
+        functions.setBufferTransparency = [](ASurfaceTransaction *st, ASurfaceControl *sc,
+                                             int8_t transparency) {
+            ASurfaceTransaction_setBufferTransparency(st, sc, transparency);
+        };
+        functions.setBufferAlpha = [](ASurfaceTransaction *st, ASurfaceControl *sc, float alpha) {
+            ASurfaceTransaction_setBufferAlpha(st, sc, alpha);
+        };
+        functions.setBufferDataSpace = [](ASurfaceTransaction *st, ASurfaceControl *sc,
+                                          ADataSpace dataSpace) {
+            ASurfaceTransaction_setBufferDataSpace(st, sc, dataSpace);
+        };
+        functions.setGeometry = [](ASurfaceTransaction *st, ASurfaceControl *sc,
+                                   const ARect &src, const ARect &dst, int32_t transform) {
+            ASurfaceTransaction_setGeometry(st, sc, src, dst, transform);
+        };
+        functions.reparent = [](ASurfaceTransaction *st, ASurfaceControl *sc,
+                                ASurfaceControl *parent) {
+            ASurfaceTransaction_reparent(st, sc, parent);
+        };
+    }
+    if (apiLevel >= 30) {
+        functions.setFrameRate = [](ASurfaceTransaction *st, ASurfaceControl *sc,
+                                    float frameRate, int8_t compatibility) {
+            ASurfaceTransaction_setFrameRate(st, sc, frameRate, compatibility);
+        };
+    }
+    if (apiLevel >= 31) {
+        functions.setCrop = [](ASurfaceTransaction *st, ASurfaceControl *sc, const ARect &crop) {
+            ASurfaceTransaction_setCrop(st, sc, crop);
+        };
+        functions.setPosition = [](ASurfaceTransaction *st, ASurfaceControl *sc,
+                                   int32_t x, int32_t y) {
+            ASurfaceTransaction_setPosition(st, sc, x, y);
+        };
+        functions.setScale = [](ASurfaceTransaction *st, ASurfaceControl *sc,
+                                float scaleX, float scaleY) {
+            ASurfaceTransaction_setScale(st, sc, scaleX, scaleY);
+        };
+        functions.setBufferTransform = [](ASurfaceTransaction *st, ASurfaceControl *sc,
+                                          int32_t transform) {
+            ASurfaceTransaction_setBufferTransform(st, sc, transform);
+        };
+        functions.setFrameRateWithChangeStrategy = [](ASurfaceTransaction *st,
+                                                      ASurfaceControl *sc, float frameRate,
+                                                      int8_t compatibility, int8_t strategy) {
+            ASurfaceTransaction_setFrameRateWithChangeStrategy(st, sc, frameRate, compatibility,
+                                                               strategy);
+        };
+    }
+}
+
+// Buffer slots of a command buffer resolved on the stack, larger batches go to the heap
+static constexpr jint MAX_STACK_SLOTS = 16;
+
+jint JniBindings_nApplyCommands(JNIEnv *env, jclass,
+                                jlong surfaceTransaction,
+                                jobject commands,
+                                jint size,
+                                jobjectArray hardwareBuffers,
+                                jintArray fenceFds,
+                                jint slotCount) {
+    auto st = reinterpret_cast<ASurfaceTransaction *>(surfaceTransaction);
+    auto data = static_cast<const uint8_t *>(env->GetDirectBufferAddress(commands));
+
+    const jint fenceCount = env->GetArrayLength(fenceFds);
+    if (slotCount < 0 || slotCount > env->GetArrayLength(hardwareBuffers) ||
+            slotCount > fenceCount) {
+        ALOGE("nApplyCommands: invalid slot count %d", slotCount);
+        // The fences of the slots that can be read are still owned by this call
+        jint fd;
+        for (jint i = 0; i < std::min(slotCount, fenceCount); i++) {
+            env->GetIntArrayRegion(fenceFds, i, 1, &fd);
+            if (fd != -1) {
+                close(fd);
+            }
+        }
+        return -1;
+    }
+
+    AHardwareBuffer *stackBuffers[MAX_STACK_SLOTS];
+    int stackFds[MAX_STACK_SLOTS];
+    std::unique_ptr<AHardwareBuffer *[]> heapBuffers;
+    std::unique_ptr<int[]> heapFds;
+    AHardwareBuffer **buffers = stackBuffers;
+    int *fds = stackFds;
+    if (slotCount > MAX_STACK_SLOTS) {
+        heapBuffers.reset(new AHardwareBuffer *[slotCount]);
+        heapFds.reset(new int[slotCount]);
+        buffers = heapBuffers.get();
+        fds = heapFds.get();
+    }
+
+    // The fence fds were duplicated when the commands were recorded, they are owned by this call
+    env->GetIntArrayRegion(fenceFds, 0, slotCount, reinterpret_cast<jint *>(fds));
+    for (jint i = 0; i < slotCount; i++) {
+        jobject buffer = env->GetObjectArrayElement(hardwareBuffers, i);
+        buffers[i] = buffer ? AHardwareBuffer_fromHardwareBuffer(env, buffer) : nullptr;
+        env->DeleteLocalRef(buffer);
+    }
+
+    int result = -1;
+    if (data != nullptr && size >= 0 && size <= env->GetDirectBufferCapacity(commands)) {
+        result = applyTransactionCommands(gTransactionFunctions, st, data,
+                                          static_cast<size_t>(size), buffers, fds,
+                                          static_cast<size_t>(slotCount));
+    }
+
+    // Fences of the slots that were not consumed by the transaction
+    for (jint i = 0; i < slotCount; i++) {
+        if (fds[i] != -1) {
+            close(fds[i]);
+        }
+    }
+
+    if (result < 0) {
+        ALOGE("nApplyCommands: malformed command buffer of size %d", size);
+    }
+    return static_cast<jint>(result);
+}
+
 void loadRectInfo(JNIEnv *env) {
     gRectInfo.clazz = env->FindClass("android/graphics/Rect");
 
@@ -571,7 +796,7 @@ static const JNINativeMethod JNI_METHOD_TABLE[] = {
         },
         {
                 "nSetBuffer",
-                "(JJLandroid/hardware/HardwareBuffer;Landroidx/hardware/SyncFenceV19;)V",
+                "(JJLandroid/hardware/HardwareBuffer;I)V",
                 (void *) JniBindings_nSetBuffer
         },
         {
@@ -589,6 +814,11 @@ static const JNINativeMethod JNI_METHOD_TABLE[] = {
                 "(JJLandroid/graphics/Rect;)V",
                 (void *) JniBindings_nSetDamageRegion
         },
+        {
+                "nSetDamageRegions",
+                "(JJ[II)V",
+                (void *) JniBindings_nSetDamageRegions
+        },
         {
                 "nSetDesiredPresentTime",
                 "(JJ)V",
@@ -644,6 +874,12 @@ static const JNINativeMethod JNI_METHOD_TABLE[] = {
                 "(JJ)I",
                 (void *)JniBindings_nGetPreviousReleaseFenceFd
         },
+        {
+            "nApplyCommands",
+                "(JLjava/nio/ByteBuffer;I[Landroid/hardware/HardwareBuffer;"
+                "[II)I",
+                (void *) JniBindings_nApplyCommands
+        },
         {
             "nSetFrameRate",
                 "(JJFII)V",
@@ -658,6 +894,7 @@ JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM *vm, void *) {
     if (vm->GetEnv((void **) &env, JNI_VERSION_1_6) != JNI_OK) {
         return JNI_ERR;
     }
+    gVm = vm;
 
     jclass clazz = env->FindClass("androidx/graphics/surface/JniBindings");
     if(clazz == nullptr) {
@@ -669,7 +906,12 @@ JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM *vm, void *) {
         return JNI_ERR;
     }
 
+    gDeviceApiLevel = android_get_device_api_level();
+
     loadRectInfo(env);
+    loadTransactionFunctions();
+
+    loadCallbackClassInfo(env);
 
     if (loadEGLMethods(env) != JNI_OK) {
         return JNI_ERR;
@@ -679,5 +921,17 @@ JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM *vm, void *) {
         return JNI_ERR;
     }
 
+    if (loadFenceWatcherMethods(env) != JNI_OK) {
+        return JNI_ERR;
+    }
+
+    if (loadHardwareBufferPixelsMethods(env) != JNI_OK) {
+        return JNI_ERR;
+    }
+
+    if (loadFrameStatsMethods(env) != JNI_OK) {
+        return JNI_ERR;
+    }
+
     return JNI_VERSION_1_6;
 }
\ No newline at end of file
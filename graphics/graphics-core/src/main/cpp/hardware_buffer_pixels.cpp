@@ -0,0 +1,174 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "HardwareBufferPixels"
+
+#include "hardware_buffer_pixels.h"
+#include "pixel_kernels.h"
+
+#include <algorithm>
+#include <android/hardware_buffer_jni.h>
+#include <android/log.h>
+
+#define ALOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+/**
+ * A CPU mapping of a 32 bit per pixel AHardwareBuffer, unlocked when going out of scope
+ */
+class LockedBuffer {
+public:
+    LockedBuffer(JNIEnv* env, jobject hardwareBuffer, uint64_t usage) {
+        mBuffer = AHardwareBuffer_fromHardwareBuffer(env, hardwareBuffer);
+        if (mBuffer == nullptr) {
+            return;
+        }
+        AHardwareBuffer_describe(mBuffer, &mDesc);
+        if (mDesc.format != AHARDWAREBUFFER_FORMAT_R8G8B8A8_UNORM &&
+            mDesc.format != AHARDWAREBUFFER_FORMAT_R8G8B8X8_UNORM) {
+            ALOGE("Unsupported buffer format %u", mDesc.format);
+            return;
+        }
+        if (AHardwareBuffer_lock(mBuffer, usage, -1, nullptr, &mData) != 0) {
+            ALOGE("Unable to lock buffer");
+            mData = nullptr;
+        }
+    }
+
+    ~LockedBuffer() {
+        if (mData != nullptr) {
+            AHardwareBuffer_unlock(mBuffer, nullptr);
+        }
+    }
+
+    void* data() const { return mData; }
+
+    uint32_t stride() const { return mDesc.stride; }
+
+    int32_t width() const { return static_cast<int32_t>(mDesc.width); }
+
+    int32_t height() const { return static_cast<int32_t>(mDesc.height); }
+
+private:
+    AHardwareBuffer* mBuffer = nullptr;
+    AHardwareBuffer_Desc mDesc{};
+    void* mData = nullptr;
+};
+
+/**
+ * Clips the source rect so that it lies within the source buffer, and its destination within the
+ * destination buffer. Returns false if nothing is left to copy.
+ */
+static bool clipRects(const LockedBuffer& dst, int32_t* dstX, int32_t* dstY,
+                      const LockedBuffer& src, int32_t* left, int32_t* top, int32_t* right,
+                      int32_t* bottom) {
+    // Offset from the source to the destination coordinates
+    const int32_t dx = *dstX - *left;
+    const int32_t dy = *dstY - *top;
+    *left = std::max({*left, 0, -dx});
+    *top = std::max({*top, 0, -dy});
+    *right = std::min({*right, src.width(), dst.width() - dx});
+    *bottom = std::min({*bottom, src.height(), dst.height() - dy});
+    *dstX = *left + dx;
+    *dstY = *top + dy;
+    return *left < *right && *top < *bottom;
+}
+
+jboolean HardwareBufferPixels_nFill(JNIEnv* env, jclass, jobject hardwareBuffer,
+                                    jint left, jint top, jint right, jint bottom, jint color) {
+    LockedBuffer buffer(env, hardwareBuffer, AHARDWAREBUFFER_USAGE_CPU_WRITE_OFTEN);
+    if (buffer.data() == nullptr) {
+        return JNI_FALSE;
+    }
+    left = std::max(left, 0);
+    top = std::max(top, 0);
+    right = std::min(right, buffer.width());
+    bottom = std::min(bottom, buffer.height());
+    if (left < right && top < bottom) {
+        fillPixels(buffer.data(), buffer.stride(), left, top, right, bottom,
+                   static_cast<uint32_t>(color));
+    }
+    return JNI_TRUE;
+}
+
+jboolean HardwareBufferPixels_nCopy(JNIEnv* env, jclass, jobject dstBuffer, jint dstX, jint dstY,
+                                    jobject srcBuffer, jint left, jint top, jint right,
+                                    jint bottom) {
+    if (env->IsSameObject(dstBuffer, srcBuffer)) {
+        ALOGE("Copying within the same buffer is not supported");
+        return JNI_FALSE;
+    }
+    LockedBuffer src(env, srcBuffer, AHARDWAREBUFFER_USAGE_CPU_READ_OFTEN);
+    LockedBuffer dst(env, dstBuffer, AHARDWAREBUFFER_USAGE_CPU_WRITE_OFTEN);
+    if (src.data() == nullptr || dst.data() == nullptr) {
+        return JNI_FALSE;
+    }
+    if (clipRects(dst, &dstX, &dstY, src, &left, &top, &right, &bottom)) {
+        copyPixels(dst.data(), dst.stride(), dstX, dstY, src.data(), src.stride(),
+                   left, top, right, bottom);
+    }
+    return JNI_TRUE;
+}
+
+jboolean HardwareBufferPixels_nBlend(JNIEnv* env, jclass, jobject dstBuffer, jint dstX, jint dstY,
+                                     jobject srcBuffer, jint left, jint top, jint right,
+                                     jint bottom) {
+    if (env->IsSameObject(dstBuffer, srcBuffer)) {
+        ALOGE("Blending within the same buffer is not supported");
+        return JNI_FALSE;
+    }
+    LockedBuffer src(env, srcBuffer, AHARDWAREBUFFER_USAGE_CPU_READ_OFTEN);
+    LockedBuffer dst(env, dstBuffer,
+                     AHARDWAREBUFFER_USAGE_CPU_READ_OFTEN | AHARDWAREBUFFER_USAGE_CPU_WRITE_OFTEN);
+    if (src.data() == nullptr || dst.data() == nullptr) {
+        return JNI_FALSE;
+    }
+    if (clipRects(dst, &dstX, &dstY, src, &left, &top, &right, &bottom)) {
+        blendPixels(dst.data(), dst.stride(), dstX, dstY, src.data(), src.stride(),
+                    left, top, right, bottom);
+    }
+    return JNI_TRUE;
+}
+
+static const JNINativeMethod HARDWARE_BUFFER_PIXELS_METHOD_TABLE[] = {
+        {
+                "nFill",
+                "(Landroid/hardware/HardwareBuffer;IIIII)Z",
+                (void *) HardwareBufferPixels_nFill
+        },
+        {
+                "nCopy",
+                "(Landroid/hardware/HardwareBuffer;IILandroid/hardware/HardwareBuffer;IIII)Z",
+                (void *) HardwareBufferPixels_nCopy
+        },
+        {
+                "nBlend",
+                "(Landroid/hardware/HardwareBuffer;IILandroid/hardware/HardwareBuffer;IIII)Z",
+                (void *) HardwareBufferPixels_nBlend
+        }
+};
+
+jint loadHardwareBufferPixelsMethods(JNIEnv* env) {
+    jclass clazz = env->FindClass("androidx/hardware/HardwareBufferPixels");
+    if (clazz == nullptr) {
+        return JNI_ERR;
+    }
+    if (env->RegisterNatives(clazz, HARDWARE_BUFFER_PIXELS_METHOD_TABLE,
+                             sizeof(HARDWARE_BUFFER_PIXELS_METHOD_TABLE) /
+                             sizeof(JNINativeMethod)) != JNI_OK) {
+        return JNI_ERR;
+    }
+    return JNI_OK;
+}
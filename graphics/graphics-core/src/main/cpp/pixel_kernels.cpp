@@ -0,0 +1,171 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "pixel_kernels.h"
+
+#include <cstring>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+static inline uint32_t* pixelAt(void* data, uint32_t stride, int32_t x, int32_t y) {
+    return static_cast<uint32_t*>(data) + static_cast<size_t>(stride) * y + x;
+}
+
+static inline const uint32_t* pixelAt(const void* data, uint32_t stride, int32_t x, int32_t y) {
+    return static_cast<const uint32_t*>(data) + static_cast<size_t>(stride) * y + x;
+}
+
+static inline void fillRow(uint32_t* dst, int32_t count, uint32_t color) {
+    for (int32_t x = 0; x < count; x++) {
+        dst[x] = color;
+    }
+}
+
+// Exact division by 255 of a product of two 8 bit values, rounded to nearest, matching the
+// NEON vraddhn/vrshr sequence
+static inline uint32_t div255(uint32_t value) {
+    value += 128;
+    return (value + (value >> 8)) >> 8;
+}
+
+static inline void blendRowScalar(uint32_t* dst, const uint32_t* src, int32_t count) {
+    for (int32_t x = 0; x < count; x++) {
+        const uint32_t s = src[x];
+        const uint32_t inverseAlpha = 255 - (s >> 24);
+        if (inverseAlpha == 0) {
+            dst[x] = s;
+            continue;
+        }
+        const uint32_t d = dst[x];
+        uint32_t result = 0;
+        for (int shift = 0; shift < 32; shift += 8) {
+            uint32_t channel = ((s >> shift) & 0xFF) + div255(((d >> shift) & 0xFF) * inverseAlpha);
+            result |= (channel > 255 ? 255 : channel) << shift;
+        }
+        dst[x] = result;
+    }
+}
+
+#if defined(__ARM_NEON)
+
+static inline void blendRow(uint32_t* dst, const uint32_t* src, int32_t count) {
+    int32_t x = 0;
+    for (; x + 8 <= count; x += 8) {
+        const uint8x8x4_t s = vld4_u8(reinterpret_cast<const uint8_t*>(src + x));
+        const uint8x8x4_t d = vld4_u8(reinterpret_cast<const uint8_t*>(dst + x));
+        const uint8x8_t inverseAlpha = vmvn_u8(s.val[3]);
+        uint8x8x4_t result;
+        for (int c = 0; c < 4; c++) {
+            const uint16x8_t product = vmull_u8(d.val[c], inverseAlpha);
+            const uint8x8_t scaled = vraddhn_u16(product, vrshrq_n_u16(product, 8));
+            result.val[c] = vqadd_u8(s.val[c], scaled);
+        }
+        vst4_u8(reinterpret_cast<uint8_t*>(dst + x), result);
+    }
+    blendRowScalar(dst + x, src + x, count - x);
+}
+
+#elif defined(__SSE2__)
+
+// Multiplies the 16 bit channels of 2 pixels by 255 minus their source alpha, divided by 255
+static inline __m128i scaleByInverseAlpha(__m128i destination, __m128i source) {
+    __m128i alpha = _mm_shufflelo_epi16(source, _MM_SHUFFLE(3, 3, 3, 3));
+    alpha = _mm_shufflehi_epi16(alpha, _MM_SHUFFLE(3, 3, 3, 3));
+    const __m128i inverseAlpha = _mm_sub_epi16(_mm_set1_epi16(255), alpha);
+    __m128i product = _mm_add_epi16(_mm_mullo_epi16(destination, inverseAlpha),
+                                    _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(product, _mm_srli_epi16(product, 8)), 8);
+}
+
+static inline void blendRow(uint32_t* dst, const uint32_t* src, int32_t count) {
+    const __m128i zero = _mm_setzero_si128();
+    int32_t x = 0;
+    for (; x + 4 <= count; x += 4) {
+        const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x));
+        const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + x));
+        const __m128i low = scaleByInverseAlpha(_mm_unpacklo_epi8(d, zero),
+                                                _mm_unpacklo_epi8(s, zero));
+        const __m128i high = scaleByInverseAlpha(_mm_unpackhi_epi8(d, zero),
+                                                 _mm_unpackhi_epi8(s, zero));
+        const __m128i result = _mm_adds_epu8(s, _mm_packus_epi16(low, high));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), result);
+    }
+    blendRowScalar(dst + x, src + x, count - x);
+}
+
+#else
+
+static inline void blendRow(uint32_t* dst, const uint32_t* src, int32_t count) {
+    blendRowScalar(dst, src, count);
+}
+
+#endif
+
+void fillPixels(void* data, uint32_t stride, int32_t left, int32_t top, int32_t right,
+                int32_t bottom, uint32_t color) {
+    const int32_t width = right - left;
+    if (width <= 0) {
+        return;
+    }
+    if (static_cast<uint32_t>(width) == stride && left == 0) {
+        // Rows are contiguous, fill them as a single row
+        fillRow(pixelAt(data, stride, 0, top),
+                width * (bottom - top), color);
+        return;
+    }
+    for (int32_t y = top; y < bottom; y++) {
+        fillRow(pixelAt(data, stride, left, y), width, color);
+    }
+}
+
+void copyPixels(void* dst, uint32_t dstStride, int32_t dstX, int32_t dstY,
+                const void* src, uint32_t srcStride,
+                int32_t srcLeft, int32_t srcTop, int32_t srcRight, int32_t srcBottom) {
+    const int32_t width = srcRight - srcLeft;
+    if (width <= 0) {
+        return;
+    }
+    const size_t rowBytes = static_cast<size_t>(width) * sizeof(uint32_t);
+    for (int32_t y = srcTop; y < srcBottom; y++) {
+        memcpy(pixelAt(dst, dstStride, dstX, dstY + y - srcTop),
+               pixelAt(src, srcStride, srcLeft, y), rowBytes);
+    }
+}
+
+void blendPixels(void* dst, uint32_t dstStride, int32_t dstX, int32_t dstY,
+                 const void* src, uint32_t srcStride,
+                 int32_t srcLeft, int32_t srcTop, int32_t srcRight, int32_t srcBottom) {
+    const int32_t width = srcRight - srcLeft;
+    if (width <= 0) {
+        return;
+    }
+    for (int32_t y = srcTop; y < srcBottom; y++) {
+        blendRow(pixelAt(dst, dstStride, dstX, dstY + y - srcTop),
+                 pixelAt(src, srcStride, srcLeft, y), width);
+    }
+}
+
+void blendPixelsScalar(void* dst, uint32_t dstStride, int32_t dstX, int32_t dstY,
+                       const void* src, uint32_t srcStride,
+                       int32_t srcLeft, int32_t srcTop, int32_t srcRight, int32_t srcBottom) {
+    for (int32_t y = srcTop; y < srcBottom; y++) {
+        blendRowScalar(pixelAt(dst, dstStride, dstX, dstY + y - srcTop),
+                       pixelAt(src, srcStride, srcLeft, y), srcRight - srcLeft);
+    }
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROIDX_PIXEL_KERNELS_H
+#define ANDROIDX_PIXEL_KERNELS_H
+
+#include <cstdint>
+
+/**
+ * CPU kernels operating on 32 bit per pixel memory, such as locked R8G8B8A8 AHardwareBuffers.
+ * Strides are expressed in pixels, as in AHardwareBuffer_Desc. Rects are [left, right) x
+ * [top, bottom) and must lie within the buffers, empty rects are no-ops.
+ *
+ * Only blending has NEON and SSE2 variants, used when the target supports them. They produce the
+ * same output as the scalar variant, which is exposed for testing and benchmarking. Filling and
+ * copying are plain loops and memcpy, which the compiler and libc already vectorize: hand written
+ * variants measured no faster.
+ */
+
+/**
+ * Fills the rect of the buffer with the given color, in the memory order of the buffer
+ */
+void fillPixels(void* data, uint32_t stride, int32_t left, int32_t top, int32_t right,
+                int32_t bottom, uint32_t color);
+
+/**
+ * Copies the [srcLeft, srcTop, srcRight, srcBottom) rect of src to dst, at (dstX, dstY). The
+ * source and destination rects must not overlap.
+ */
+void copyPixels(void* dst, uint32_t dstStride, int32_t dstX, int32_t dstY,
+                const void* src, uint32_t srcStride,
+                int32_t srcLeft, int32_t srcTop, int32_t srcRight, int32_t srcBottom);
+
+/**
+ * Composites the rect of src over dst at (dstX, dstY) with the SRC_OVER Porter-Duff mode. Pixels
+ * are premultiplied with alpha in their fourth byte, which is the case of both RGBA and BGRA
+ * formats. The source and destination rects must not overlap.
+ */
+void blendPixels(void* dst, uint32_t dstStride, int32_t dstX, int32_t dstY,
+                 const void* src, uint32_t srcStride,
+                 int32_t srcLeft, int32_t srcTop, int32_t srcRight, int32_t srcBottom);
+
+void blendPixelsScalar(void* dst, uint32_t dstStride, int32_t dstX, int32_t dstY,
+                       const void* src, uint32_t srcStride,
+                       int32_t srcLeft, int32_t srcTop, int32_t srcRight, int32_t srcBottom);
+
+#endif //ANDROIDX_PIXEL_KERNELS_H
@@ -18,19 +18,7 @@
 #include <android/api-level.h>
 #include <android/native_window_jni.h>
 #include <android/hardware_buffer_jni.h>
-
-void colorBufferRegion(void *data, int32_t left, int32_t top, int32_t right, int32_t bottom,
-                       uint32_t color, uint32_t stride) {
-    auto *ptr = static_cast<uint32_t *>(data);
-    ptr += stride * top;
-
-    for (uint32_t y = top; y < bottom; y++) {
-        for (uint32_t x = left; x < right; x++) {
-            ptr[x] = color;
-        }
-        ptr += stride;
-    }
-}
+#include "pixel_kernels.h"
 
 static AHardwareBuffer* allocateBuffer(int32_t width, int32_t height) {
     AHardwareBuffer* buffer = nullptr;
@@ -70,7 +58,7 @@ bool createSolidBuffer(JNIEnv *env, jobject thiz, int32_t width, int32_t height,
         return true;
     }
 
-    colorBufferRegion(data, 0, 0, width, height, color, desc.stride);
+    fillPixels(data, desc.stride, 0, 0, width, height, color);
     AHardwareBuffer_unlock(buffer, fence);
     *outBuffer = buffer;
     return false;
@@ -114,12 +102,10 @@ static bool getQuadrantBuffer(int32_t width, int32_t height, jint colorTopLeft,
         return true;
     }
 
-    colorBufferRegion(data, 0, 0, width / 2, height / 2, colorTopLeft, desc.stride);
-    colorBufferRegion(data, width / 2, 0, width, height / 2, colorTopRight, desc.stride);
-    colorBufferRegion(data, 0, height / 2, width / 2, height, colorBottomLeft,
-                      desc.stride);
-    colorBufferRegion(data, width / 2, height / 2, width, height, colorBottomRight,
-                      desc.stride);
+    fillPixels(data, desc.stride, 0, 0, width / 2, height / 2, colorTopLeft);
+    fillPixels(data, desc.stride, width / 2, 0, width, height / 2, colorTopRight);
+    fillPixels(data, desc.stride, 0, height / 2, width / 2, height, colorBottomLeft);
+    fillPixels(data, desc.stride, width / 2, height / 2, width, height, colorBottomRight);
 
     AHardwareBuffer_unlock(buffer, outFence);
 
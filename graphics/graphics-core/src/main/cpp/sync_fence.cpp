@@ -23,10 +23,15 @@
 #include <android/file_descriptor_jni.h>
 #include <errno.h>
 #include <dlfcn.h>
+#include <linux/sync_file.h>
+#include <sys/ioctl.h>
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <memory>
 #include <mutex>
-
-static constexpr int64_t SIGNAL_TIME_INVALID = -1;
-static constexpr int64_t SIGNAL_TIME_PENDING = INT64_MAX;
+#include <vector>
+#include "sync_fence.h"
 
 #define SYNC_FENCE "SYNC_FENCE"
 #define ALOGE(msg, ...) \
@@ -111,12 +116,12 @@ static void release_sync_file_info(struct sync_file_info* info) {
     }
 }
 
-jlong SyncFence_nGetSignalTime(JNIEnv *env, jobject, jint fd) {
+/**
+ * Resolves the signal time of a fence through libsync, which allocates the sync_file_info.
+ * Used on kernels that predate the SYNC_IOC_FILE_INFO ioctl.
+ */
+static int64_t libsync_signal_time(int fd) {
     // Implementation sampled from Fence::getSignalTime in the framework
-    if (fd == -1) {
-        return SIGNAL_TIME_INVALID;
-    }
-
     struct sync_file_info* finfo = get_sync_file_info(fd);
     if (finfo == nullptr) {
         ALOGE("sync_file_info returned NULL for fd %d", fd);
@@ -145,6 +150,89 @@ jlong SyncFence_nGetSignalTime(JNIEnv *env, jobject, jint fd) {
     return static_cast<int64_t>(timestamp);
 }
 
+static int sync_file_info_ioctl(int fd, struct sync_file_info* info) {
+    int ret;
+    do {
+        ret = ioctl(fd, SYNC_IOC_FILE_INFO, info);
+    } while (ret == -1 && (errno == EINTR || errno == EAGAIN));
+    return ret;
+}
+
+/**
+ * Resolves the signal time of a fence with the SYNC_IOC_FILE_INFO ioctl, as sync_file_info does,
+ * but reads the info of the fences backing it into the given scratch buffer instead of a new
+ * allocation. The fence infos are only read once the fence signaled, pending fences take a single
+ * ioctl.
+ * @return false if the ioctl is not supported by the kernel or the file descriptor, signal_time
+ * is left untouched then
+ */
+static bool query_signal_time(int fd, std::vector<struct sync_fence_info>& scratch,
+                              int64_t* signal_time) {
+    struct sync_file_info info{};
+    if (sync_file_info_ioctl(fd, &info) < 0) {
+        if (errno == ENOTTY) {
+            return false;
+        }
+        ALOGE("SYNC_IOC_FILE_INFO failed with errno: <%d> for fd: <%d>", errno, fd);
+        *signal_time = SIGNAL_TIME_INVALID;
+        return true;
+    }
+
+    if (info.status != 1) {
+        if (info.status < 0) {
+            ALOGE("nGetSignalTime: sync_file_info contains an error: <%d> for fd: <%d>",
+                  info.status, fd);
+        }
+        *signal_time = info.status < 0 ? SIGNAL_TIME_INVALID : SIGNAL_TIME_PENDING;
+        return true;
+    }
+
+    const uint32_t num_fences = info.num_fences;
+    if (scratch.size() < num_fences) {
+        scratch.resize(num_fences);
+    }
+    info = {};
+    info.num_fences = num_fences;
+    info.sync_fence_info = reinterpret_cast<uint64_t>(scratch.data());
+    if (sync_file_info_ioctl(fd, &info) < 0) {
+        ALOGE("SYNC_IOC_FILE_INFO failed with errno: <%d> for fd: <%d>", errno, fd);
+        *signal_time = SIGNAL_TIME_INVALID;
+        return true;
+    }
+
+    uint64_t timestamp = 0;
+    for (uint32_t i = 0; i < info.num_fences; i++) {
+        if (scratch[i].timestamp_ns > timestamp) {
+            timestamp = scratch[i].timestamp_ns;
+        }
+    }
+    *signal_time = static_cast<int64_t>(timestamp);
+    return true;
+}
+
+void getSyncFenceSignalTimes(const int* fds, int64_t* signal_times, size_t count) {
+    // Reused by all the queries made from the thread, fences rarely back more than a few fences
+    static thread_local std::vector<struct sync_fence_info> scratch;
+    for (size_t i = 0; i < count; i++) {
+        const int fd = fds[i];
+        if (fd < 0) {
+            signal_times[i] = SIGNAL_TIME_INVALID;
+        } else if (!query_signal_time(fd, scratch, &signal_times[i])) {
+            signal_times[i] = libsync_signal_time(fd);
+        }
+    }
+}
+
+int64_t getSyncFenceSignalTime(int fd) {
+    int64_t signal_time;
+    getSyncFenceSignalTimes(&fd, &signal_time, 1);
+    return signal_time;
+}
+
+jlong SyncFence_nGetSignalTime(JNIEnv *env, jobject, jint fd) {
+    return static_cast<jlong>(getSyncFenceSignalTime(fd));
+}
+
 // Implementation of sync_wait obtained from libsync/sync.c in the framework
 static int sync_wait(int fd, int timeout)
 {
@@ -176,6 +264,121 @@ static int sync_wait(int fd, int timeout)
     return ret;
 }
 
+/**
+ * Returns the number of milliseconds left before the given CLOCK_MONOTONIC deadline, 0 if the
+ * deadline has passed
+ */
+static int remaining_millis(const struct timespec& deadline) {
+    struct timespec now{};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    int64_t millis = (deadline.tv_sec - now.tv_sec) * 1000 +
+            (deadline.tv_nsec - now.tv_nsec) / 1000000;
+    return millis > 0 ? static_cast<int>(millis) : 0;
+}
+
+/**
+ * Waits for any or all of the provided fences to signal with a single poll over all the file
+ * descriptors, instead of one sync_wait per fence. Fences that signal are removed from the poll
+ * set, so waiting for all of them polls until the last one signals or the timeout expires.
+ * Negative file descriptors are treated as fences that have already signaled. Fences in an error
+ * state never signal: they are removed from the poll set and reported as not signaled, while the
+ * wait goes on for the other fences.
+ * @param fds File descriptors of the fences to wait on
+ * @param count Number of file descriptors in fds
+ * @param wait_all true to wait for all the fences to signal, false to wait for any of them
+ * @param timeout Timeout in milliseconds, negative values wait indefinitely
+ * @param signaled Receives, for each fence, whether it signaled
+ * @return The number of fences that signaled, which is less than count (or 0 when waiting for any
+ * fence) if the timeout expired or fences are in an error state, or -1 with errno set if poll
+ * failed
+ */
+static int sync_wait_many(const int* fds, int count, bool wait_all, int timeout, bool* signaled)
+{
+    std::vector<struct pollfd> poll_fds(count);
+    int signaled_count = 0;
+    int errored_count = 0;
+    for (int i = 0; i < count; i++) {
+        // poll ignores negative file descriptors
+        poll_fds[i].fd = fds[i] < 0 ? -1 : fds[i];
+        poll_fds[i].events = POLLIN;
+        signaled[i] = fds[i] < 0;
+        if (signaled[i]) signaled_count++;
+    }
+
+    struct timespec deadline{};
+    if (timeout > 0) {
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        deadline.tv_sec += timeout / 1000;
+        deadline.tv_nsec += (timeout % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+    }
+
+    // Nothing left to wait for, still poll once to report the fences that already signaled
+    if (signaled_count == count || (!wait_all && signaled_count > 0)) {
+        timeout = 0;
+    }
+
+    for (;;) {
+        int ret = poll(poll_fds.data(), static_cast<nfds_t>(count), timeout);
+        if (ret == -1) {
+            if (errno != EINTR && errno != EAGAIN) {
+                return -1;
+            }
+        } else if (ret == 0) {
+            return signaled_count;
+        } else {
+            for (int i = 0; i < count; i++) {
+                const short revents = poll_fds[i].revents;
+                if (revents & (POLLERR | POLLNVAL)) {
+                    errored_count++;
+                    poll_fds[i].fd = -1;
+                } else if (revents != 0) {
+                    // Like sync_wait, any other event (POLLIN, or POLLHUP for stand-ins such as
+                    // pipes) means that the fence signaled
+                    signaled[i] = true;
+                    signaled_count++;
+                    poll_fds[i].fd = -1;
+                }
+            }
+            // Done once a fence signaled when waiting for any of them, or once no fence is
+            // left that can still signal
+            if ((!wait_all && signaled_count > 0) || signaled_count + errored_count == count) {
+                return signaled_count;
+            }
+        }
+
+        if (timeout > 0) {
+            timeout = remaining_millis(deadline);
+        }
+    }
+}
+
+/**
+ * Merges two fences into a new fence that signals once both of them have signaled, as
+ * sync_merge does in libsync/sync.c in the framework
+ * @return The file descriptor of the new fence, or -1 with errno set on failure
+ */
+static int sync_merge_fds(const char* name, int fd1, int fd2)
+{
+    struct sync_merge_data data{};
+    int ret;
+
+    data.fd2 = fd2;
+    strncpy(data.name, name, sizeof(data.name) - 1);
+
+    do {
+        ret = ioctl(fd1, SYNC_IOC_MERGE, &data);
+    } while (ret == -1 && (errno == EINTR || errno == EAGAIN));
+
+    if (ret < 0) {
+        return ret;
+    }
+    return data.fence;
+}
+
 jboolean SyncFence_nWait(JNIEnv *env, jobject, jint fd, jint timeout_millis) {
     if (fd == -1) {
         return static_cast<jboolean>(true);
@@ -188,6 +391,102 @@ jboolean SyncFence_nWait(JNIEnv *env, jobject, jint fd, jint timeout_millis) {
     return static_cast<jboolean>(err == 0);
 }
 
+/**
+ * Closes the valid file descriptors of the given array
+ */
+static void close_fds(const jint* fds, jsize count) {
+    for (jsize i = 0; i < count; i++) {
+        if (fds[i] >= 0) {
+            close(fds[i]);
+        }
+    }
+}
+
+/**
+ * Waits on the given file descriptors, see sync_wait_many. The file descriptors are duplicates
+ * owned by this method, they are closed once the wait is over.
+ */
+jint SyncFence_nWaitMany(JNIEnv *env, jclass, jintArray fds, jboolean wait_all,
+                         jint timeout_millis, jbooleanArray signaled) {
+    const jsize count = env->GetArrayLength(fds);
+    if (count == 0) {
+        return 0;
+    }
+
+    jint* fd_values = env->GetIntArrayElements(fds, nullptr);
+    std::unique_ptr<bool[]> results(new bool[count]);
+    int ret = sync_wait_many(fd_values, count, wait_all, timeout_millis, results.get());
+    int error = errno;
+    close_fds(fd_values, count);
+    env->ReleaseIntArrayElements(fds, fd_values, JNI_ABORT);
+
+    if (ret < 0) {
+        ALOGE("nWaitMany: poll failed with errno: <%d>", error);
+        return -1;
+    }
+
+    if (signaled != nullptr) {
+        jboolean* flags = env->GetBooleanArrayElements(signaled, nullptr);
+        for (jsize i = 0; i < count; i++) {
+            flags[i] = static_cast<jboolean>(results[i]);
+        }
+        env->ReleaseBooleanArrayElements(signaled, flags, 0);
+    }
+    return static_cast<jint>(ret);
+}
+
+void SyncFence_nGetSignalTimes(JNIEnv *env, jclass, jintArray fds, jlongArray signal_times) {
+    // Fences are copied in and out in batches, so that no array is pinned while querying
+    static constexpr jsize BATCH_SIZE = 32;
+    int fd_values[BATCH_SIZE];
+    int64_t times[BATCH_SIZE];
+    const jsize count = env->GetArrayLength(fds);
+    for (jsize start = 0; start < count; start += BATCH_SIZE) {
+        const jsize size = std::min(BATCH_SIZE, count - start);
+        env->GetIntArrayRegion(fds, start, size, reinterpret_cast<jint*>(fd_values));
+        getSyncFenceSignalTimes(fd_values, times, static_cast<size_t>(size));
+        env->SetLongArrayRegion(signal_times, start, size, reinterpret_cast<const jlong*>(times));
+    }
+}
+
+/**
+ * Merges the given file descriptors into a new fence. The file descriptors are duplicates owned
+ * by this method, the first valid one becomes the merged fence when it is the only one and all
+ * the others are closed.
+ */
+jint SyncFence_nMerge(JNIEnv *env, jclass, jintArray fds) {
+    const jsize count = env->GetArrayLength(fds);
+    jint* fd_values = env->GetIntArrayElements(fds, nullptr);
+
+    int merged = -1;
+    jsize i = 0;
+    for (; i < count; i++) {
+        const int fd = fd_values[i];
+        if (fd < 0) {
+            continue;
+        }
+        if (merged == -1) {
+            merged = fd;
+            continue;
+        }
+        int result = sync_merge_fds("androidx.hardware.SyncFence", merged, fd);
+        close(merged);
+        close(fd);
+        merged = result;
+        if (merged == -1) {
+            ALOGE("nMerge: unable to merge fd: <%d>", fd);
+            break;
+        }
+    }
+    if (i < count) {
+        // Fences left after a failed merge
+        close_fds(fd_values + i + 1, count - i - 1);
+    }
+
+    env->ReleaseIntArrayElements(fds, fd_values, JNI_ABORT);
+    return static_cast<jint>(merged);
+}
+
 jboolean SyncFenceBindings_nResolveSyncFileInfo(JNIEnv *env, jclass) {
     load_libsync();
     return sync_file_info_ptr != nullptr;
@@ -222,6 +521,21 @@ static const JNINativeMethod SYNC_FENCE_METHOD_TABLE[] = {
             "nDup",
             "(I)I",
             (void*)SyncFence_nDup
+        },
+        {
+            "nWaitMany",
+            "([IZI[Z)I",
+            (void*)SyncFence_nWaitMany
+        },
+        {
+            "nMerge",
+            "([I)I",
+            (void*)SyncFence_nMerge
+        },
+        {
+            "nGetSignalTimes",
+            "([I[J)V",
+            (void*)SyncFence_nGetSignalTimes
         }
 };
 
@@ -17,6 +17,26 @@
 #ifndef ANDROIDX_SYNC_FENCE_H
 #define ANDROIDX_SYNC_FENCE_H
 
+#include <cstddef>
+#include <cstdint>
+
+static constexpr int64_t SIGNAL_TIME_INVALID = -1;
+static constexpr int64_t SIGNAL_TIME_PENDING = INT64_MAX;
+
 jint loadSyncFenceMethods(JNIEnv* env);
 
+/**
+ * Returns the time at which the fence backed by the given file descriptor signaled, in the
+ * CLOCK_MONOTONIC time domain, SIGNAL_TIME_PENDING if it has not signaled yet or
+ * SIGNAL_TIME_INVALID if the signal time cannot be resolved
+ */
+int64_t getSyncFenceSignalTime(int fd);
+
+/**
+ * Batch version of getSyncFenceSignalTime, negative file descriptors resolve to
+ * SIGNAL_TIME_INVALID. Queries SYNC_IOC_FILE_INFO directly with a reused scratch buffer rather
+ * than through the allocating libsync sync_file_info.
+ */
+void getSyncFenceSignalTimes(const int* fds, int64_t* signal_times, size_t count);
+
 #endif //ANDROIDX_SYNC_FENCE_H
@@ -0,0 +1,156 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Host test of coalesceDamageRects() and DamageRegion: which rects are merged, the cap on the
+// number of rects and the coverage of the input rects by the coalesced region.
+
+#include "../damage_region.h"
+#include "host_test.h"
+
+#include <vector>
+
+static bool contains(const ARect& outer, const ARect& inner) {
+    return outer.left <= inner.left && outer.top <= inner.top &&
+           outer.right >= inner.right && outer.bottom >= inner.bottom;
+}
+
+// Every rect of the input lies within one of the coalesced rects
+static bool covers(const ARect* region, int32_t count, const std::vector<ARect>& input) {
+    for (const ARect& rect : input) {
+        bool covered = false;
+        for (int32_t i = 0; i < count && !covered; i++) {
+            covered = contains(region[i], rect);
+        }
+        if (!covered) return false;
+    }
+    return true;
+}
+
+static int32_t coalesce(std::vector<ARect>* rects, int32_t maxRects = MAX_DAMAGE_RECTS) {
+    return coalesceDamageRects(rects->data(), static_cast<int32_t>(rects->size()), maxRects);
+}
+
+static void expectRect(const ARect& expected, const ARect& actual) {
+    EXPECT_EQ(expected.left, actual.left);
+    EXPECT_EQ(expected.top, actual.top);
+    EXPECT_EQ(expected.right, actual.right);
+    EXPECT_EQ(expected.bottom, actual.bottom);
+}
+
+static void testMergesOverlappingRects() {
+    std::vector<ARect> rects = {{0, 0, 10, 10}, {5, 0, 15, 10}};
+    EXPECT_EQ(1, coalesce(&rects));
+    expectRect({0, 0, 15, 10}, rects[0]);
+
+    // Contained rects
+    std::vector<ARect> contained = {{2, 2, 4, 4}, {0, 0, 10, 10}};
+    EXPECT_EQ(1, coalesce(&contained));
+    expectRect({0, 0, 10, 10}, contained[0]);
+}
+
+static void testMergesAdjacentRects() {
+    std::vector<ARect> rects = {{0, 0, 10, 10}, {0, 10, 10, 20}};
+    EXPECT_EQ(1, coalesce(&rects));
+    expectRect({0, 0, 10, 20}, rects[0]);
+
+    // A merge enables the next one: the first two rects only share an edge with the third once
+    // they are merged
+    std::vector<ARect> chained = {{0, 0, 5, 10}, {10, 0, 20, 10}, {5, 0, 10, 10}};
+    EXPECT_EQ(1, coalesce(&chained));
+    expectRect({0, 0, 20, 10}, chained[0]);
+}
+
+static void testRejectsDisjointRects() {
+    std::vector<ARect> rects = {{0, 0, 10, 10}, {20, 20, 30, 30}};
+    const std::vector<ARect> input = rects;
+    EXPECT_EQ(2, coalesce(&rects));
+    EXPECT_TRUE(covers(rects.data(), 2, input));
+
+    // Rects touching by a corner, or partially overlapping, would grow the damaged area
+    std::vector<ARect> corner = {{0, 0, 10, 10}, {10, 10, 20, 20}};
+    EXPECT_EQ(2, coalesce(&corner));
+    std::vector<ARect> offset = {{0, 0, 10, 10}, {5, 5, 15, 15}};
+    EXPECT_EQ(2, coalesce(&offset));
+}
+
+static void testDropsEmptyRects() {
+    std::vector<ARect> rects = {{5, 5, 5, 10}, {0, 0, 10, 10}, {10, 10, 0, 0}};
+    EXPECT_EQ(1, coalesce(&rects));
+    expectRect({0, 0, 10, 10}, rects[0]);
+
+    std::vector<ARect> empty = {{0, 0, 0, 0}, {3, 4, 3, 8}};
+    EXPECT_EQ(0, coalesce(&empty));
+}
+
+static void testCapsRectCount() {
+    // A grid of scattered rects, none of which can be merged for free
+    std::vector<ARect> rects;
+    for (int32_t y = 0; y < 5; y++) {
+        for (int32_t x = 0; x < 5; x++) {
+            rects.push_back({x * 100, y * 100, x * 100 + 10, y * 100 + 10});
+        }
+    }
+    const std::vector<ARect> input = rects;
+
+    int32_t count = coalesce(&rects);
+    EXPECT_EQ(MAX_DAMAGE_RECTS, count);
+    EXPECT_TRUE(covers(rects.data(), count, input));
+
+    // Merges the pair adding the fewest pixels: the two close rects rather than the far one
+    std::vector<ARect> close = {{0, 0, 10, 10}, {500, 500, 510, 510}, {12, 0, 22, 10}};
+    EXPECT_EQ(2, coalesce(&close, 2));
+    expectRect({0, 0, 22, 10}, close[0]);
+
+    // At least one rect is kept
+    std::vector<ARect> single = input;
+    count = coalesce(&single, 0);
+    EXPECT_EQ(1, count);
+    expectRect({0, 0, 410, 410}, single[0]);
+}
+
+static void testRegionStorageOverflow() {
+    // More rects than the storage of the region, which coalesces as it fills up
+    DamageRegion region;
+    std::vector<ARect> input;
+    for (int32_t i = 0; i < 100; i++) {
+        const ARect rect{(i % 10) * 50, (i / 10) * 50, (i % 10) * 50 + 20, (i / 10) * 50 + 20};
+        input.push_back(rect);
+        region.add(rect);
+        EXPECT_TRUE(region.count() <= MAX_DAMAGE_RECTS * 2);
+    }
+    region.coalesce();
+    EXPECT_TRUE(region.count() >= 1);
+    EXPECT_TRUE(region.count() <= MAX_DAMAGE_RECTS);
+    EXPECT_TRUE(covers(region.rects(), region.count(), input));
+
+    // Empty rects are not stored
+    DamageRegion empty;
+    for (int32_t i = 0; i < 100; i++) {
+        empty.add({i, i, i, i + 1});
+    }
+    empty.coalesce();
+    EXPECT_EQ(0, empty.count());
+}
+
+int main() {
+    RUN_TEST(testMergesOverlappingRects);
+    RUN_TEST(testMergesAdjacentRects);
+    RUN_TEST(testRejectsDisjointRects);
+    RUN_TEST(testDropsEmptyRects);
+    RUN_TEST(testCapsRectCount);
+    RUN_TEST(testRegionStorageOverflow);
+    return sFailureCount == 0 ? 0 : 1;
+}
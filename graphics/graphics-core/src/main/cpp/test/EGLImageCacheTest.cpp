@@ -0,0 +1,232 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Host test of EGLImageCache against a fake EGL and GL table that tracks the buffers acquired,
+// and the images and textures alive, so that eviction order and resource balance can be checked
+// without a device.
+
+#include "../egl_image_cache.h"
+#include "host_test.h"
+
+#include <map>
+#include <set>
+
+static std::map<AHardwareBuffer*, int> sBufferRefs;
+static std::set<EGLImageKHR> sImages;
+static std::set<GLuint> sTextures;
+static std::map<GLuint, EGLImageKHR> sTextureImages;
+static GLuint sBoundTexture = 0;
+static uintptr_t sNextImage = 1;
+static GLuint sNextTexture = 1;
+static AHardwareBuffer* sFailingBuffer = nullptr;
+
+static void resetFakes() {
+    sBufferRefs.clear();
+    sImages.clear();
+    sTextures.clear();
+    sTextureImages.clear();
+    sBoundTexture = 0;
+    sNextImage = 1;
+    sNextTexture = 1;
+    sFailingBuffer = nullptr;
+}
+
+static EGLImageFunctions fakeFunctions() {
+    EGLImageFunctions functions;
+    functions.acquireBuffer = [](AHardwareBuffer* buffer) {
+        sBufferRefs[buffer]++;
+    };
+    functions.releaseBuffer = [](AHardwareBuffer* buffer) {
+        if (--sBufferRefs[buffer] == 0) sBufferRefs.erase(buffer);
+    };
+    functions.getNativeClientBuffer = [](const AHardwareBuffer* buffer) {
+        return reinterpret_cast<EGLClientBuffer>(const_cast<AHardwareBuffer*>(buffer));
+    };
+    functions.createImage = [](EGLDisplay, EGLContext, EGLenum, EGLClientBuffer clientBuffer,
+            const EGLint*) {
+        if (reinterpret_cast<AHardwareBuffer*>(clientBuffer) == sFailingBuffer) {
+            return EGL_NO_IMAGE_KHR;
+        }
+        auto image = reinterpret_cast<EGLImageKHR>(sNextImage++);
+        sImages.insert(image);
+        return image;
+    };
+    functions.destroyImage = [](EGLDisplay, EGLImageKHR image) {
+        return static_cast<EGLBoolean>(sImages.erase(image) == 1 ? EGL_TRUE : EGL_FALSE);
+    };
+    functions.genTextures = [](GLsizei count, GLuint* textures) {
+        for (GLsizei i = 0; i < count; i++) {
+            textures[i] = sNextTexture++;
+            sTextures.insert(textures[i]);
+        }
+    };
+    functions.deleteTextures = [](GLsizei count, const GLuint* textures) {
+        for (GLsizei i = 0; i < count; i++) {
+            sTextures.erase(textures[i]);
+            sTextureImages.erase(textures[i]);
+        }
+    };
+    functions.bindTexture = [](GLenum, GLuint texture) {
+        sBoundTexture = texture;
+    };
+    functions.imageTargetTexture2D = [](GLenum, GLeglImageOES image) {
+        sTextureImages[sBoundTexture] = static_cast<EGLImageKHR>(image);
+    };
+    return functions;
+}
+
+static AHardwareBuffer* buffer(uintptr_t id) {
+    return reinterpret_cast<AHardwareBuffer*>(id * 0x1000);
+}
+
+static const EGLDisplay kDisplay = reinterpret_cast<EGLDisplay>(0x42);
+
+static void expectBalanced() {
+    EXPECT_EQ(0, sBufferRefs.size());
+    EXPECT_EQ(0, sImages.size());
+    EXPECT_EQ(0, sTextures.size());
+}
+
+static void testCachesImages() {
+    resetFakes();
+    {
+        EGLImageCache cache(fakeFunctions(), kDisplay, 4);
+        const EGLImageCache::Entry* entry = cache.get(buffer(1));
+        EXPECT_TRUE(entry != nullptr);
+        EXPECT_TRUE(sImages.count(entry->image) == 1);
+        EXPECT_TRUE(sTextureImages[entry->texture] == entry->image);
+        EXPECT_EQ(1, sBufferRefs[buffer(1)]);
+
+        // Hits neither create an image nor acquire the buffer again
+        const EGLImageKHR image = entry->image;
+        const GLuint texture = entry->texture;
+        entry = cache.get(buffer(1));
+        EXPECT_TRUE(entry->image == image);
+        EXPECT_EQ(texture, entry->texture);
+        EXPECT_EQ(1, cache.createdCount());
+        EXPECT_EQ(1, sBufferRefs[buffer(1)]);
+        EXPECT_EQ(1, sImages.size());
+
+        EXPECT_TRUE(cache.get(nullptr) == nullptr);
+        EXPECT_EQ(1, cache.size());
+    }
+    expectBalanced();
+}
+
+static void testEvictsLeastRecentlyUsed() {
+    resetFakes();
+    {
+        EGLImageCache cache(fakeFunctions(), kDisplay, 3);
+        cache.get(buffer(1));
+        cache.get(buffer(2));
+        cache.get(buffer(3));
+
+        // Using the oldest entry makes the second one the least recently used
+        cache.get(buffer(1));
+        cache.get(buffer(4));
+        EXPECT_EQ(3, cache.size());
+        EXPECT_EQ(0, sBufferRefs.count(buffer(2)));
+        EXPECT_EQ(3, sBufferRefs.size());
+        EXPECT_EQ(3, sImages.size());
+        EXPECT_EQ(3, sTextures.size());
+
+        cache.get(buffer(5));
+        EXPECT_EQ(0, sBufferRefs.count(buffer(3)));
+        EXPECT_EQ(1, sBufferRefs.count(buffer(1)));
+        EXPECT_EQ(1, sBufferRefs.count(buffer(4)));
+        EXPECT_EQ(1, sBufferRefs.count(buffer(5)));
+
+        // The evicted buffers are cached again on their next use
+        cache.get(buffer(2));
+        EXPECT_EQ(1, sBufferRefs.count(buffer(2)));
+        EXPECT_EQ(0, sBufferRefs.count(buffer(1)));
+        EXPECT_EQ(6, cache.createdCount());
+    }
+    expectBalanced();
+}
+
+static void testEvictAndClear() {
+    resetFakes();
+    EGLImageCache cache(fakeFunctions(), kDisplay, 4);
+    cache.get(buffer(1));
+    cache.get(buffer(2));
+    cache.get(buffer(3));
+
+    EXPECT_TRUE(cache.evict(buffer(2)));
+    EXPECT_TRUE(!cache.evict(buffer(2)));
+    EXPECT_TRUE(!cache.evict(buffer(7)));
+    EXPECT_EQ(2, cache.size());
+    EXPECT_EQ(0, sBufferRefs.count(buffer(2)));
+    EXPECT_EQ(2, sImages.size());
+    EXPECT_EQ(2, sTextures.size());
+
+    cache.clear();
+    EXPECT_EQ(0, cache.size());
+    expectBalanced();
+
+    // The cache remains usable after being cleared
+    EXPECT_TRUE(cache.get(buffer(1)) != nullptr);
+    cache.clear();
+    expectBalanced();
+}
+
+static void testCreateImageFailure() {
+    resetFakes();
+    {
+        EGLImageCache cache(fakeFunctions(), kDisplay, 2);
+        cache.get(buffer(1));
+        cache.get(buffer(2));
+
+        // A failure neither evicts an entry nor acquires the buffer
+        sFailingBuffer = buffer(3);
+        EXPECT_TRUE(cache.get(buffer(3)) == nullptr);
+        EXPECT_EQ(2, cache.size());
+        EXPECT_EQ(2, cache.createdCount());
+        EXPECT_EQ(0, sBufferRefs.count(buffer(3)));
+        EXPECT_EQ(1, sBufferRefs.count(buffer(1)));
+        EXPECT_EQ(1, sBufferRefs.count(buffer(2)));
+        EXPECT_EQ(2, sTextures.size());
+
+        // Nor is it cached
+        sFailingBuffer = nullptr;
+        EXPECT_TRUE(cache.get(buffer(3)) != nullptr);
+        EXPECT_EQ(0, sBufferRefs.count(buffer(1)));
+    }
+    expectBalanced();
+}
+
+static void testMinimumCapacity() {
+    resetFakes();
+    {
+        EGLImageCache cache(fakeFunctions(), kDisplay, 0);
+        EXPECT_EQ(1, cache.capacity());
+        cache.get(buffer(1));
+        cache.get(buffer(2));
+        EXPECT_EQ(1, cache.size());
+        EXPECT_EQ(1, sBufferRefs.size());
+        EXPECT_EQ(1, sBufferRefs.count(buffer(2)));
+    }
+    expectBalanced();
+}
+
+int main() {
+    RUN_TEST(testCachesImages);
+    RUN_TEST(testEvictsLeastRecentlyUsed);
+    RUN_TEST(testEvictAndClear);
+    RUN_TEST(testCreateImageFailure);
+    RUN_TEST(testMinimumCapacity);
+    return sFailureCount == 0 ? 0 : 1;
+}
@@ -0,0 +1,363 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Host test of applyTransactionCommands(). Command buffers are encoded as
+// SurfaceTransactionCommands.kt does and applied through SurfaceTransactionFunctions that record
+// each call, so that the decoding, the malformed buffer handling and the ownership of the fence
+// fds can be checked without a device.
+
+#include "../transaction_commands.h"
+#include "host_test.h"
+
+#include <cstdarg>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static std::string sCalls;
+
+static void record(const char* format, ...) __attribute__((format(printf, 1, 2)));
+
+static void record(const char* format, ...) {
+    char call[256];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(call, sizeof(call), format, args);
+    va_end(args);
+    sCalls += call;
+    sCalls += ';';
+}
+
+static long id(const void* pointer) {
+    return static_cast<long>(reinterpret_cast<intptr_t>(pointer));
+}
+
+static SurfaceTransactionFunctions recordingFunctions() {
+    SurfaceTransactionFunctions functions;
+    functions.setBuffer = [](ASurfaceTransaction*, ASurfaceControl* sc, AHardwareBuffer* buffer,
+            int fd) {
+        record("setBuffer %ld %ld %d", id(sc), id(buffer), fd);
+    };
+    functions.setVisibility = [](ASurfaceTransaction*, ASurfaceControl* sc, int8_t visibility) {
+        record("setVisibility %ld %d", id(sc), visibility);
+    };
+    functions.setZOrder = [](ASurfaceTransaction*, ASurfaceControl* sc, int32_t zOrder) {
+        record("setZOrder %ld %d", id(sc), zOrder);
+    };
+    functions.setDamageRegion = [](ASurfaceTransaction*, ASurfaceControl* sc, const ARect* rects,
+            uint32_t count) {
+        std::string call = "setDamageRegion " + std::to_string(id(sc));
+        if (rects == nullptr) call += " null";
+        for (uint32_t i = 0; i < count; i++) {
+            call += " [" + std::to_string(rects[i].left) + "," + std::to_string(rects[i].top) +
+                    "," + std::to_string(rects[i].right) + "," +
+                    std::to_string(rects[i].bottom) + "]";
+        }
+        record("%s", call.c_str());
+    };
+    functions.setDesiredPresentTime = [](ASurfaceTransaction*, int64_t time) {
+        record("setDesiredPresentTime %lld", static_cast<long long>(time));
+    };
+    functions.setBufferTransparency = [](ASurfaceTransaction*, ASurfaceControl* sc,
+            int8_t transparency) {
+        record("setBufferTransparency %ld %d", id(sc), transparency);
+    };
+    functions.setBufferAlpha = [](ASurfaceTransaction*, ASurfaceControl* sc, float alpha) {
+        record("setBufferAlpha %ld %.2f", id(sc), alpha);
+    };
+    functions.setCrop = [](ASurfaceTransaction*, ASurfaceControl* sc, const ARect& crop) {
+        record("setCrop %ld %d %d %d %d", id(sc), crop.left, crop.top, crop.right, crop.bottom);
+    };
+    functions.setPosition = [](ASurfaceTransaction*, ASurfaceControl* sc, int32_t x, int32_t y) {
+        record("setPosition %ld %d %d", id(sc), x, y);
+    };
+    functions.setScale = [](ASurfaceTransaction*, ASurfaceControl* sc, float x, float y) {
+        record("setScale %ld %.2f %.2f", id(sc), x, y);
+    };
+    functions.setBufferTransform = [](ASurfaceTransaction*, ASurfaceControl* sc,
+            int32_t transform) {
+        record("setBufferTransform %ld %d", id(sc), transform);
+    };
+    functions.setBufferDataSpace = [](ASurfaceTransaction*, ASurfaceControl* sc,
+            ADataSpace dataSpace) {
+        record("setBufferDataSpace %ld %d", id(sc), static_cast<int>(dataSpace));
+    };
+    functions.setGeometry = [](ASurfaceTransaction*, ASurfaceControl* sc, const ARect& src,
+            const ARect& dst, int32_t transform) {
+        record("setGeometry %ld %d %d %d %d %d", id(sc), src.right, src.bottom, dst.right,
+               dst.bottom, transform);
+    };
+    functions.setFrameRate = [](ASurfaceTransaction*, ASurfaceControl* sc, float frameRate,
+            int8_t compatibility) {
+        record("setFrameRate %ld %.1f %d", id(sc), frameRate, compatibility);
+    };
+    functions.setFrameRateWithChangeStrategy = [](ASurfaceTransaction*, ASurfaceControl* sc,
+            float frameRate, int8_t compatibility, int8_t strategy) {
+        record("setFrameRateWithChangeStrategy %ld %.1f %d %d", id(sc), frameRate, compatibility,
+               strategy);
+    };
+    functions.reparent = [](ASurfaceTransaction*, ASurfaceControl* sc, ASurfaceControl* parent) {
+        record("reparent %ld %ld", id(sc), id(parent));
+    };
+    return functions;
+}
+
+/**
+ * Encodes commands in native byte order, as SurfaceTransactionCommands.kt does
+ */
+class CommandWriter {
+public:
+    CommandWriter& begin(int32_t opcode, int64_t surfaceControl) {
+        return putInt(opcode).putLong(surfaceControl);
+    }
+
+    CommandWriter& putInt(int32_t value) { return put(value); }
+
+    CommandWriter& putLong(int64_t value) { return put(value); }
+
+    CommandWriter& putFloat(float value) { return put(value); }
+
+    CommandWriter& putRect(int32_t left, int32_t top, int32_t right, int32_t bottom) {
+        return putInt(left).putInt(top).putInt(right).putInt(bottom);
+    }
+
+    const uint8_t* data() const { return mData.data(); }
+
+    size_t size() const { return mData.size(); }
+
+private:
+    template<typename T>
+    CommandWriter& put(T value) {
+        const size_t offset = mData.size();
+        mData.resize(offset + sizeof(T));
+        memcpy(mData.data() + offset, &value, sizeof(T));
+        return *this;
+    }
+
+    std::vector<uint8_t> mData;
+};
+
+static AHardwareBuffer* const kBuffers[] = {
+        reinterpret_cast<AHardwareBuffer*>(0x100),
+        nullptr,
+        reinterpret_cast<AHardwareBuffer*>(0x300),
+};
+static constexpr size_t kSlotCount = sizeof(kBuffers) / sizeof(kBuffers[0]);
+
+static int apply(const SurfaceTransactionFunctions& functions, const CommandWriter& writer,
+                 int* fenceFds, size_t size) {
+    sCalls.clear();
+    return applyTransactionCommands(functions, nullptr, writer.data(), size, kBuffers, fenceFds,
+                                    kSlotCount);
+}
+
+static int apply(const CommandWriter& writer, int* fenceFds) {
+    return apply(recordingFunctions(), writer, fenceFds, writer.size());
+}
+
+static void testAppliesEveryCommandInOrder() {
+    CommandWriter writer;
+    writer.begin(TRANSACTION_COMMAND_SET_BUFFER, 1).putInt(0);
+    writer.begin(TRANSACTION_COMMAND_SET_VISIBILITY, 1).putInt(1);
+    writer.begin(TRANSACTION_COMMAND_SET_Z_ORDER, 1).putInt(-3);
+    writer.begin(TRANSACTION_COMMAND_SET_DAMAGE_REGION, 1).putInt(1).putRect(1, 2, 3, 4);
+    writer.putInt(TRANSACTION_COMMAND_SET_DESIRED_PRESENT_TIME).putLong(123456789012LL);
+    writer.begin(TRANSACTION_COMMAND_SET_BUFFER_TRANSPARENCY, 2).putInt(2);
+    writer.begin(TRANSACTION_COMMAND_SET_BUFFER_ALPHA, 2).putFloat(0.5f);
+    writer.begin(TRANSACTION_COMMAND_SET_CROP, 2).putRect(0, 0, 10, 20);
+    writer.begin(TRANSACTION_COMMAND_SET_POSITION, 2).putFloat(5.9f).putFloat(-6.0f);
+    writer.begin(TRANSACTION_COMMAND_SET_SCALE, 2).putFloat(2.0f).putFloat(0.25f);
+    writer.begin(TRANSACTION_COMMAND_SET_BUFFER_TRANSFORM, 2).putInt(4);
+    writer.begin(TRANSACTION_COMMAND_SET_DATA_SPACE, 2).putInt(ADATASPACE_SRGB);
+    writer.begin(TRANSACTION_COMMAND_SET_GEOMETRY, 2).putInt(100).putInt(200).putInt(50)
+            .putInt(60).putInt(7);
+    writer.begin(TRANSACTION_COMMAND_SET_FRAME_RATE, 2).putFloat(60.0f).putInt(1).putInt(0);
+    writer.begin(TRANSACTION_COMMAND_REPARENT, 2).putLong(1);
+
+    int fenceFds[kSlotCount] = {10, 11, 12};
+    EXPECT_EQ(15, apply(writer, fenceFds));
+    EXPECT_STREQ(
+            "setBuffer 1 256 10;"
+            "setVisibility 1 1;"
+            "setZOrder 1 -3;"
+            "setDamageRegion 1 [1,2,3,4];"
+            "setDesiredPresentTime 123456789012;"
+            "setBufferTransparency 2 2;"
+            "setBufferAlpha 2 0.50;"
+            "setCrop 2 0 0 10 20;"
+            "setPosition 2 5 -6;"
+            "setScale 2 2.00 0.25;"
+            "setBufferTransform 2 4;"
+            "setBufferDataSpace 2 142671872;"
+            "setGeometry 2 100 200 50 60 7;"
+            "setFrameRateWithChangeStrategy 2 60.0 1 0;"
+            "reparent 2 1;",
+            sCalls.c_str());
+}
+
+static void testEmptyCommands() {
+    CommandWriter writer;
+    int fenceFds[kSlotCount] = {10, 11, 12};
+    EXPECT_EQ(0, apply(writer, fenceFds));
+    EXPECT_STREQ("", sCalls.c_str());
+    EXPECT_EQ(10, fenceFds[0]);
+}
+
+static void testTruncatedCommands() {
+    CommandWriter writer;
+    writer.begin(TRANSACTION_COMMAND_SET_Z_ORDER, 1).putInt(2);
+    const size_t firstSize = writer.size();
+    writer.begin(TRANSACTION_COMMAND_SET_GEOMETRY, 1).putInt(100).putInt(200).putInt(50)
+            .putInt(60).putInt(7);
+
+    // Every cut inside the second command is malformed, the first command is still applied
+    for (size_t size = firstSize + 1; size < writer.size(); size++) {
+        int fenceFds[kSlotCount] = {10, 11, 12};
+        EXPECT_EQ(-1, apply(recordingFunctions(), writer, fenceFds, size));
+        EXPECT_STREQ("setZOrder 1 2;", sCalls.c_str());
+    }
+
+    int fenceFds[kSlotCount] = {10, 11, 12};
+    EXPECT_EQ(1, apply(recordingFunctions(), writer, fenceFds, firstSize));
+
+    // Truncated desired present time, which has no surface control
+    CommandWriter time;
+    time.putInt(TRANSACTION_COMMAND_SET_DESIRED_PRESENT_TIME).putInt(0);
+    EXPECT_EQ(-1, apply(time, fenceFds));
+    EXPECT_STREQ("", sCalls.c_str());
+
+    // Damage region whose count exceeds the remaining rects, or is negative
+    CommandWriter damage;
+    damage.begin(TRANSACTION_COMMAND_SET_DAMAGE_REGION, 1).putInt(2).putRect(0, 0, 1, 1);
+    EXPECT_EQ(-1, apply(damage, fenceFds));
+    EXPECT_STREQ("", sCalls.c_str());
+
+    CommandWriter negative;
+    negative.begin(TRANSACTION_COMMAND_SET_DAMAGE_REGION, 1).putInt(-2);
+    EXPECT_EQ(-1, apply(negative, fenceFds));
+    EXPECT_STREQ("", sCalls.c_str());
+}
+
+static void testBadOpcode() {
+    for (int32_t opcode : {0, 16, -1}) {
+        CommandWriter writer;
+        writer.begin(TRANSACTION_COMMAND_SET_VISIBILITY, 1).putInt(0);
+        writer.begin(opcode, 1).putInt(0);
+        writer.begin(TRANSACTION_COMMAND_SET_Z_ORDER, 1).putInt(1);
+
+        int fenceFds[kSlotCount] = {10, 11, 12};
+        EXPECT_EQ(-1, apply(writer, fenceFds));
+        EXPECT_STREQ("setVisibility 1 0;", sCalls.c_str());
+    }
+}
+
+static void testSlotOutOfRange() {
+    for (int32_t slot : {static_cast<int32_t>(kSlotCount), -1, INT32_MAX}) {
+        CommandWriter writer;
+        writer.begin(TRANSACTION_COMMAND_SET_BUFFER, 1).putInt(slot);
+
+        int fenceFds[kSlotCount] = {10, 11, 12};
+        EXPECT_EQ(-1, apply(writer, fenceFds));
+        EXPECT_STREQ("", sCalls.c_str());
+        EXPECT_EQ(10, fenceFds[0]);
+        EXPECT_EQ(11, fenceFds[1]);
+        EXPECT_EQ(12, fenceFds[2]);
+    }
+}
+
+static void testFenceOwnership() {
+    CommandWriter writer;
+    writer.begin(TRANSACTION_COMMAND_SET_BUFFER, 1).putInt(0);
+    writer.begin(TRANSACTION_COMMAND_SET_BUFFER, 2).putInt(1);
+    writer.begin(TRANSACTION_COMMAND_SET_BUFFER, 3).putInt(2);
+
+    // The transaction consumes the fences of the slots with a buffer. The slot without a buffer
+    // is set without a fence, its fd is left to the caller to close.
+    int fenceFds[kSlotCount] = {10, 11, -1};
+    EXPECT_EQ(3, apply(writer, fenceFds));
+    EXPECT_STREQ("setBuffer 1 256 10;setBuffer 2 0 -1;setBuffer 3 768 -1;", sCalls.c_str());
+    EXPECT_EQ(-1, fenceFds[0]);
+    EXPECT_EQ(11, fenceFds[1]);
+    EXPECT_EQ(-1, fenceFds[2]);
+
+    // Fences are not consumed when setBuffer is not available
+    SurfaceTransactionFunctions functions = recordingFunctions();
+    functions.setBuffer = nullptr;
+    int unusedFds[kSlotCount] = {10, 11, 12};
+    EXPECT_EQ(3, apply(functions, writer, unusedFds, writer.size()));
+    EXPECT_STREQ("", sCalls.c_str());
+    EXPECT_EQ(10, unusedFds[0]);
+    EXPECT_EQ(11, unusedFds[1]);
+    EXPECT_EQ(12, unusedFds[2]);
+
+    // Fences consumed before a malformed command stay consumed
+    CommandWriter malformed;
+    malformed.begin(TRANSACTION_COMMAND_SET_BUFFER, 1).putInt(0);
+    malformed.begin(TRANSACTION_COMMAND_SET_BUFFER, 3).putInt(3);
+    int partialFds[kSlotCount] = {10, 11, 12};
+    EXPECT_EQ(-1, apply(malformed, partialFds));
+    EXPECT_EQ(-1, partialFds[0]);
+    EXPECT_EQ(12, partialFds[2]);
+}
+
+static void testMissingFunctionsAreSkipped() {
+    CommandWriter writer;
+    writer.begin(TRANSACTION_COMMAND_SET_FRAME_RATE, 1).putFloat(30.0f).putInt(0).putInt(1);
+    writer.begin(TRANSACTION_COMMAND_SET_DATA_SPACE, 1).putInt(ADATASPACE_DISPLAY_P3);
+    writer.begin(TRANSACTION_COMMAND_SET_VISIBILITY, 1).putInt(1);
+
+    SurfaceTransactionFunctions functions = recordingFunctions();
+    functions.setFrameRateWithChangeStrategy = nullptr;
+    functions.setBufferDataSpace = nullptr;
+    int fenceFds[kSlotCount] = {10, 11, 12};
+    EXPECT_EQ(3, apply(functions, writer, fenceFds, writer.size()));
+    EXPECT_STREQ("setFrameRate 1 30.0 0;setVisibility 1 1;", sCalls.c_str());
+}
+
+static void testDamageRegion() {
+    int fenceFds[kSlotCount] = {10, 11, 12};
+
+    // Overlapping rects are coalesced, empty rects dropped
+    CommandWriter writer;
+    writer.begin(TRANSACTION_COMMAND_SET_DAMAGE_REGION, 1).putInt(3)
+            .putRect(0, 0, 10, 10).putRect(5, 0, 15, 10).putRect(20, 20, 20, 30);
+    EXPECT_EQ(1, apply(writer, fenceFds));
+    EXPECT_STREQ("setDamageRegion 1 [0,0,15,10];", sCalls.c_str());
+
+    CommandWriter entire;
+    entire.begin(TRANSACTION_COMMAND_SET_DAMAGE_REGION, 1).putInt(DAMAGE_REGION_ENTIRE_BUFFER);
+    EXPECT_EQ(1, apply(entire, fenceFds));
+    EXPECT_STREQ("setDamageRegion 1 null;", sCalls.c_str());
+
+    // No rects and only empty rects both mark nothing as damaged
+    CommandWriter nothing;
+    nothing.begin(TRANSACTION_COMMAND_SET_DAMAGE_REGION, 1).putInt(0);
+    nothing.begin(TRANSACTION_COMMAND_SET_DAMAGE_REGION, 1).putInt(1).putRect(4, 4, 4, 8);
+    EXPECT_EQ(2, apply(nothing, fenceFds));
+    EXPECT_STREQ("setDamageRegion 1 [0,0,0,0];setDamageRegion 1 [0,0,0,0];", sCalls.c_str());
+}
+
+int main() {
+    RUN_TEST(testAppliesEveryCommandInOrder);
+    RUN_TEST(testEmptyCommands);
+    RUN_TEST(testTruncatedCommands);
+    RUN_TEST(testBadOpcode);
+    RUN_TEST(testSlotOutOfRange);
+    RUN_TEST(testFenceOwnership);
+    RUN_TEST(testMissingFunctionsAreSkipped);
+    RUN_TEST(testDamageRegion);
+    return sFailureCount == 0 ? 0 : 1;
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Minimal assertions shared by the host tests of CMakeLists.txt. A failed expectation is reported
+// and counted, the test keeps running so that a single run lists every failure.
+
+#ifndef ANDROIDX_HOST_TEST_H
+#define ANDROIDX_HOST_TEST_H
+
+#include <cstdio>
+#include <cstring>
+
+static int sFailureCount = 0;
+
+#define EXPECT_TRUE(condition)                                                          \
+    do {                                                                                \
+        if (!(condition)) {                                                             \
+            fprintf(stderr, "%s:%d: expected %s\n", __FILE__, __LINE__, #condition);    \
+            sFailureCount++;                                                            \
+        }                                                                               \
+    } while (0)
+
+#define EXPECT_EQ(expected, actual)                                                     \
+    do {                                                                                \
+        const long long expectedValue = static_cast<long long>(expected);               \
+        const long long actualValue = static_cast<long long>(actual);                   \
+        if (expectedValue != actualValue) {                                             \
+            fprintf(stderr, "%s:%d: expected %s == %s, got %lld != %lld\n",             \
+                    __FILE__, __LINE__, #expected, #actual, expectedValue, actualValue); \
+            sFailureCount++;                                                            \
+        }                                                                               \
+    } while (0)
+
+#define EXPECT_STREQ(expected, actual)                                                  \
+    do {                                                                                \
+        const char* expectedValue = (expected);                                         \
+        const char* actualValue = (actual);                                             \
+        if (strcmp(expectedValue, actualValue) != 0) {                                  \
+            fprintf(stderr, "%s:%d: expected %s == %s, got\n  \"%s\"\n  \"%s\"\n",      \
+                    __FILE__, __LINE__, #expected, #actual, expectedValue, actualValue); \
+            sFailureCount++;                                                            \
+        }                                                                               \
+    } while (0)
+
+#define RUN_TEST(test)                                                                  \
+    do {                                                                                \
+        const int failures = sFailureCount;                                             \
+        test();                                                                         \
+        printf("%s %s\n", sFailureCount == failures ? "PASS" : "FAIL", #test);          \
+    } while (0)
+
+#endif //ANDROIDX_HOST_TEST_H
@@ -0,0 +1,30 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Host stand-in for the NDK header, only used by the host tests of CMakeLists.txt
+
+#ifndef ANDROIDX_HOST_ANDROID_DATA_SPACE_H
+#define ANDROIDX_HOST_ANDROID_DATA_SPACE_H
+
+#include <cstdint>
+
+enum ADataSpace : int32_t {
+    ADATASPACE_UNKNOWN = 0,
+    ADATASPACE_SRGB = 142671872,
+    ADATASPACE_DISPLAY_P3 = 143261696,
+};
+
+#endif //ANDROIDX_HOST_ANDROID_DATA_SPACE_H
@@ -0,0 +1,281 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "transaction_commands.h"
+#include "damage_region.h"
+
+#include <cstring>
+
+/**
+ * Bounds checked reader over the command words. Values are copied out since 64 bit values are
+ * only aligned on 4 bytes.
+ */
+class CommandReader {
+public:
+    CommandReader(const uint8_t* data, size_t size) : mData(data), mSize(size) {}
+
+    bool hasRemaining() const { return mOffset < mSize; }
+
+    bool canRead(size_t bytes) const { return bytes <= mSize - mOffset; }
+
+    template<typename T>
+    bool read(T* value) {
+        if (!canRead(sizeof(T))) {
+            mFailed = true;
+            return false;
+        }
+        memcpy(value, mData + mOffset, sizeof(T));
+        mOffset += sizeof(T);
+        return true;
+    }
+
+    int32_t readInt() {
+        int32_t value = 0;
+        read(&value);
+        return value;
+    }
+
+    int64_t readLong() {
+        int64_t value = 0;
+        read(&value);
+        return value;
+    }
+
+    float readFloat() {
+        float value = 0.0f;
+        read(&value);
+        return value;
+    }
+
+    ARect readRect() {
+        ARect rect{};
+        rect.left = readInt();
+        rect.top = readInt();
+        rect.right = readInt();
+        rect.bottom = readInt();
+        return rect;
+    }
+
+    void fail() { mFailed = true; }
+
+    bool failed() const { return mFailed; }
+
+private:
+    const uint8_t* mData;
+    size_t mSize;
+    size_t mOffset = 0;
+    bool mFailed = false;
+};
+
+static void applyDamageRegion(const SurfaceTransactionFunctions& functions,
+                              ASurfaceTransaction* transaction, ASurfaceControl* surfaceControl,
+                              CommandReader& reader) {
+    int32_t count = reader.readInt();
+    if (reader.failed()) return;
+    if (count == DAMAGE_REGION_ENTIRE_BUFFER) {
+        if (functions.setDamageRegion) {
+            functions.setDamageRegion(transaction, surfaceControl, nullptr, 0);
+        }
+        return;
+    }
+    if (count < 0 || !reader.canRead(static_cast<size_t>(count) * 4 * sizeof(int32_t))) {
+        reader.fail();
+        return;
+    }
+
+    DamageRegion region;
+    for (int32_t i = 0; i < count; i++) {
+        region.add(reader.readRect());
+    }
+    region.coalesce();
+
+    if (functions.setDamageRegion) {
+        if (region.count() == 0) {
+            // No rects or only empty rects, nothing is damaged
+            const ARect empty{0, 0, 0, 0};
+            functions.setDamageRegion(transaction, surfaceControl, &empty, 1);
+        } else {
+            functions.setDamageRegion(transaction, surfaceControl, region.rects(),
+                                      static_cast<uint32_t>(region.count()));
+        }
+    }
+}
+
+int applyTransactionCommands(
+        const SurfaceTransactionFunctions& functions,
+        ASurfaceTransaction* transaction,
+        const uint8_t* commands, size_t size,
+        AHardwareBuffer* const* buffers, int* fenceFds, size_t slotCount) {
+    CommandReader reader(commands, size);
+    int count = 0;
+
+    while (reader.hasRemaining()) {
+        const int32_t opcode = reader.readInt();
+        if (opcode == TRANSACTION_COMMAND_SET_DESIRED_PRESENT_TIME) {
+            const int64_t time = reader.readLong();
+            if (reader.failed()) return -1;
+            if (functions.setDesiredPresentTime) {
+                functions.setDesiredPresentTime(transaction, time);
+            }
+            count++;
+            continue;
+        }
+
+        auto sc = reinterpret_cast<ASurfaceControl*>(static_cast<intptr_t>(reader.readLong()));
+        switch (opcode) {
+            case TRANSACTION_COMMAND_SET_BUFFER: {
+                const int32_t slot = reader.readInt();
+                if (reader.failed() || slot < 0 || static_cast<size_t>(slot) >= slotCount) {
+                    return -1;
+                }
+                if (functions.setBuffer) {
+                    AHardwareBuffer* buffer = buffers[slot];
+                    // Without a buffer there is nothing for the acquire fence to guard
+                    const int fd = buffer != nullptr ? fenceFds[slot] : -1;
+                    functions.setBuffer(transaction, sc, buffer, fd);
+                    if (buffer != nullptr) {
+                        fenceFds[slot] = -1;
+                    }
+                }
+                break;
+            }
+            case TRANSACTION_COMMAND_SET_VISIBILITY: {
+                const int32_t visibility = reader.readInt();
+                if (reader.failed()) return -1;
+                if (functions.setVisibility) {
+                    functions.setVisibility(transaction, sc, static_cast<int8_t>(visibility));
+                }
+                break;
+            }
+            case TRANSACTION_COMMAND_SET_Z_ORDER: {
+                const int32_t zOrder = reader.readInt();
+                if (reader.failed()) return -1;
+                if (functions.setZOrder) {
+                    functions.setZOrder(transaction, sc, zOrder);
+                }
+                break;
+            }
+            case TRANSACTION_COMMAND_SET_DAMAGE_REGION:
+                applyDamageRegion(functions, transaction, sc, reader);
+                if (reader.failed()) return -1;
+                break;
+            case TRANSACTION_COMMAND_SET_BUFFER_TRANSPARENCY: {
+                const int32_t transparency = reader.readInt();
+                if (reader.failed()) return -1;
+                if (functions.setBufferTransparency) {
+                    functions.setBufferTransparency(transaction, sc,
+                                                    static_cast<int8_t>(transparency));
+                }
+                break;
+            }
+            case TRANSACTION_COMMAND_SET_BUFFER_ALPHA: {
+                const float alpha = reader.readFloat();
+                if (reader.failed()) return -1;
+                if (functions.setBufferAlpha) {
+                    functions.setBufferAlpha(transaction, sc, alpha);
+                }
+                break;
+            }
+            case TRANSACTION_COMMAND_SET_CROP: {
+                const ARect crop = reader.readRect();
+                if (reader.failed()) return -1;
+                if (functions.setCrop) {
+                    functions.setCrop(transaction, sc, crop);
+                }
+                break;
+            }
+            case TRANSACTION_COMMAND_SET_POSITION: {
+                const float x = reader.readFloat();
+                const float y = reader.readFloat();
+                if (reader.failed()) return -1;
+                if (functions.setPosition) {
+                    functions.setPosition(transaction, sc, static_cast<int32_t>(x),
+                                          static_cast<int32_t>(y));
+                }
+                break;
+            }
+            case TRANSACTION_COMMAND_SET_SCALE: {
+                const float scaleX = reader.readFloat();
+                const float scaleY = reader.readFloat();
+                if (reader.failed()) return -1;
+                if (functions.setScale) {
+                    functions.setScale(transaction, sc, scaleX, scaleY);
+                }
+                break;
+            }
+            case TRANSACTION_COMMAND_SET_BUFFER_TRANSFORM: {
+                const int32_t transform = reader.readInt();
+                if (reader.failed()) return -1;
+                if (functions.setBufferTransform) {
+                    functions.setBufferTransform(transaction, sc, transform);
+                }
+                break;
+            }
+            case TRANSACTION_COMMAND_SET_DATA_SPACE: {
+                const int32_t dataSpace = reader.readInt();
+                if (reader.failed()) return -1;
+                if (functions.setBufferDataSpace) {
+                    functions.setBufferDataSpace(transaction, sc,
+                                                 static_cast<ADataSpace>(dataSpace));
+                }
+                break;
+            }
+            case TRANSACTION_COMMAND_SET_GEOMETRY: {
+                const int32_t bufferWidth = reader.readInt();
+                const int32_t bufferHeight = reader.readInt();
+                const int32_t dstWidth = reader.readInt();
+                const int32_t dstHeight = reader.readInt();
+                const int32_t transform = reader.readInt();
+                if (reader.failed()) return -1;
+                if (functions.setGeometry) {
+                    const ARect src{0, 0, bufferWidth, bufferHeight};
+                    const ARect dst{0, 0, dstWidth, dstHeight};
+                    functions.setGeometry(transaction, sc, src, dst, transform);
+                }
+                break;
+            }
+            case TRANSACTION_COMMAND_SET_FRAME_RATE: {
+                const float frameRate = reader.readFloat();
+                const int32_t compatibility = reader.readInt();
+                const int32_t strategy = reader.readInt();
+                if (reader.failed()) return -1;
+                if (functions.setFrameRateWithChangeStrategy) {
+                    functions.setFrameRateWithChangeStrategy(
+                            transaction, sc, frameRate, static_cast<int8_t>(compatibility),
+                            static_cast<int8_t>(strategy));
+                } else if (functions.setFrameRate) {
+                    functions.setFrameRate(transaction, sc, frameRate,
+                                           static_cast<int8_t>(compatibility));
+                }
+                break;
+            }
+            case TRANSACTION_COMMAND_REPARENT: {
+                auto parent = reinterpret_cast<ASurfaceControl*>(
+                        static_cast<intptr_t>(reader.readLong()));
+                if (reader.failed()) return -1;
+                if (functions.reparent) {
+                    functions.reparent(transaction, sc, parent);
+                }
+                break;
+            }
+            default:
+                return -1;
+        }
+        if (reader.failed()) return -1;
+        count++;
+    }
+
+    return count;
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROIDX_TRANSACTION_COMMANDS_H
+#define ANDROIDX_TRANSACTION_COMMANDS_H
+
+#include <android/data_space.h>
+#include <android/rect.h>
+#include <cstddef>
+#include <cstdint>
+
+struct AHardwareBuffer;
+struct ASurfaceControl;
+struct ASurfaceTransaction;
+
+/**
+ * Commands encoded by SurfaceTransactionCommands on the Kotlin side. Commands are sequences of
+ * native endian 32 bit words: the opcode, followed for all commands but
+ * DESIRED_PRESENT_TIME by the ASurfaceControl pointer as a 64 bit value, followed by the
+ * arguments listed below. Must be kept in sync with SurfaceTransactionCommands.kt.
+ */
+enum TransactionCommand : int32_t {
+    // int32 slot: index of the buffer and of the acquire fence fd
+    TRANSACTION_COMMAND_SET_BUFFER = 1,
+    // int32 visibility
+    TRANSACTION_COMMAND_SET_VISIBILITY = 2,
+    // int32 z order
+    TRANSACTION_COMMAND_SET_Z_ORDER = 3,
+    // int32 count, followed by count rects of 4 int32 (left, top, right, bottom). A count of
+    // DAMAGE_REGION_ENTIRE_BUFFER marks the entire buffer as damaged, no rects nothing.
+    TRANSACTION_COMMAND_SET_DAMAGE_REGION = 4,
+    // int64 desired present time, no surface control
+    TRANSACTION_COMMAND_SET_DESIRED_PRESENT_TIME = 5,
+    // int32 transparency
+    TRANSACTION_COMMAND_SET_BUFFER_TRANSPARENCY = 6,
+    // float alpha
+    TRANSACTION_COMMAND_SET_BUFFER_ALPHA = 7,
+    // 4 int32 (left, top, right, bottom)
+    TRANSACTION_COMMAND_SET_CROP = 8,
+    // float x, float y
+    TRANSACTION_COMMAND_SET_POSITION = 9,
+    // float scale x, float scale y
+    TRANSACTION_COMMAND_SET_SCALE = 10,
+    // int32 transform
+    TRANSACTION_COMMAND_SET_BUFFER_TRANSFORM = 11,
+    // int32 data space
+    TRANSACTION_COMMAND_SET_DATA_SPACE = 12,
+    // int32 buffer width, buffer height, destination width, destination height, transform
+    TRANSACTION_COMMAND_SET_GEOMETRY = 13,
+    // float frame rate, int32 compatibility, int32 change frame rate strategy
+    TRANSACTION_COMMAND_SET_FRAME_RATE = 14,
+    // int64 new parent, 0 for none
+    TRANSACTION_COMMAND_REPARENT = 15,
+};
+
+/**
+ * Rect count of a SET_DAMAGE_REGION command that marks the entire buffer as damaged
+ */
+static constexpr int32_t DAMAGE_REGION_ENTIRE_BUFFER = -1;
+
+/**
+ * ASurfaceTransaction functions used to apply the commands, with the same signatures as the NDK.
+ * Functions that are not available on the device are left null and their commands are skipped.
+ */
+struct SurfaceTransactionFunctions {
+    void (*setBuffer)(ASurfaceTransaction*, ASurfaceControl*, AHardwareBuffer*, int) = nullptr;
+    void (*setVisibility)(ASurfaceTransaction*, ASurfaceControl*, int8_t) = nullptr;
+    void (*setZOrder)(ASurfaceTransaction*, ASurfaceControl*, int32_t) = nullptr;
+    void (*setDamageRegion)(ASurfaceTransaction*, ASurfaceControl*, const ARect*,
+            uint32_t) = nullptr;
+    void (*setDesiredPresentTime)(ASurfaceTransaction*, int64_t) = nullptr;
+    void (*setBufferTransparency)(ASurfaceTransaction*, ASurfaceControl*, int8_t) = nullptr;
+    void (*setBufferAlpha)(ASurfaceTransaction*, ASurfaceControl*, float) = nullptr;
+    void (*setCrop)(ASurfaceTransaction*, ASurfaceControl*, const ARect&) = nullptr;
+    void (*setPosition)(ASurfaceTransaction*, ASurfaceControl*, int32_t, int32_t) = nullptr;
+    void (*setScale)(ASurfaceTransaction*, ASurfaceControl*, float, float) = nullptr;
+    void (*setBufferTransform)(ASurfaceTransaction*, ASurfaceControl*, int32_t) = nullptr;
+    void (*setBufferDataSpace)(ASurfaceTransaction*, ASurfaceControl*, ADataSpace) = nullptr;
+    void (*setGeometry)(ASurfaceTransaction*, ASurfaceControl*, const ARect&, const ARect&,
+            int32_t) = nullptr;
+    void (*setFrameRate)(ASurfaceTransaction*, ASurfaceControl*, float, int8_t) = nullptr;
+    void (*setFrameRateWithChangeStrategy)(ASurfaceTransaction*, ASurfaceControl*, float, int8_t,
+            int8_t) = nullptr;
+    void (*reparent)(ASurfaceTransaction*, ASurfaceControl*, ASurfaceControl*) = nullptr;
+};
+
+/**
+ * Decodes the commands and applies them to the transaction, in order.
+ *
+ * SET_BUFFER commands refer to a slot of buffers and fenceFds. The transaction takes ownership of
+ * the fence fd of each slot it consumes, which is then set to -1: the caller remains responsible
+ * for closing the fds that are still valid afterwards.
+ *
+ * @return The number of commands decoded, or -1 if the commands are malformed. Commands that
+ * precede the malformed one are applied.
+ */
+int applyTransactionCommands(
+        const SurfaceTransactionFunctions& functions,
+        ASurfaceTransaction* transaction,
+        const uint8_t* commands, size_t size,
+        AHardwareBuffer* const* buffers, int* fenceFds, size_t slotCount);
+
+#endif //ANDROIDX_TRANSACTION_COMMANDS_H
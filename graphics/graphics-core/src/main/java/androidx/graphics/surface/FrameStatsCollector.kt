@@ -0,0 +1,276 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package androidx.graphics.surface
+
+import android.hardware.SyncFence
+import android.os.Build
+import androidx.annotation.RequiresApi
+import androidx.graphics.utils.JniVisible
+
+/**
+ * Collects frame-pacing statistics of the transactions it is added to with
+ * [SurfaceControlCompat.Transaction.addFrameStatsCollector]. For transactions backed by the NDK,
+ * the statistics are read natively on the transaction completion thread, without calling into
+ * Java, and stored in a lock-free ring of [capacity] records. Platform transactions, used on
+ * Android U and above, report the latch time and present fence of the transaction through the
+ * platform completion listener instead, their records have no layers. Records are drained in
+ * bulk with [drain], they are dropped, and counted in [droppedCount], when [capacity] records
+ * are already waiting to be drained.
+ *
+ * Each record is made of [RECORD_SIZE] longs:
+ * - [COMPLETE_TIME]: time at which the transaction completed
+ * - [LATCH_TIME]: time at which SurfaceFlinger latched the transaction
+ * - [PRESENT_TIME]: signal time of the present fence
+ * - [LAYER_COUNT]: number of layers in the transaction, the first [MAX_LAYERS] are recorded
+ * - For each recorded layer, starting at [layerOffset]: the native ASurfaceControl handle at
+ * [LAYER_SURFACE_CONTROL], the buffer acquire time at [LAYER_ACQUIRE_TIME] and the signal time of
+ * the release fence of the buffer it replaced at [LAYER_RELEASE_TIME]
+ *
+ * Times are in the [System.nanoTime] time domain. Fences are kept until their record is
+ * drained, so the signal times are resolved by [drain]: they are [SIGNAL_TIME_PENDING] only if
+ * the fence had not signaled by then, and [SIGNAL_TIME_INVALID] if there is no fence.
+ *
+ * This class is thread safe. It can be closed while transactions it was added to are pending.
+ *
+ * @param capacity Maximum number of records waiting to be drained
+ */
+@RequiresApi(Build.VERSION_CODES.Q)
+@JniVisible
+class FrameStatsCollector @JvmOverloads constructor(
+    val capacity: Int = DEFAULT_CAPACITY
+) : AutoCloseable {
+
+    private var collector: Long
+
+    /**
+     * Records of platform transactions, with their present fence, waiting to be drained
+     */
+    private val platformRecords = ArrayDeque<PlatformRecord>()
+    private var platformDroppedCount = 0L
+
+    private class PlatformRecord(
+        val completeTime: Long,
+        val latchTime: Long,
+        val presentFence: Any?
+    )
+
+    init {
+        require(capacity > 0) { "capacity must be positive" }
+        collector = nCreate(capacity)
+    }
+
+    /**
+     * Moves up to `records.size / RECORD_SIZE` records, oldest first, to [records], resolving the
+     * signal times of their fences
+     *
+     * @return the number of records drained
+     */
+    fun drain(records: LongArray): Int = synchronized(this) {
+        checkOpen()
+        val maxRecords = records.size / RECORD_SIZE
+        var count = nDrain(collector, records, maxRecords)
+        while (count < maxRecords && platformRecords.isNotEmpty()) {
+            val record = platformRecords.removeFirst()
+            val offset = count * RECORD_SIZE
+            records.fill(0L, offset, offset + RECORD_SIZE)
+            records[offset + COMPLETE_TIME] = record.completeTime
+            records[offset + LATCH_TIME] = record.latchTime
+            records[offset + PRESENT_TIME] = resolvePresentTime(record.presentFence)
+            count++
+        }
+        count
+    }
+
+    /**
+     * Number of records dropped because [capacity] records were waiting to be drained
+     */
+    val droppedCount: Long
+        get() = synchronized(this) {
+            checkOpen()
+            nDroppedCount(collector) + platformDroppedCount
+        }
+
+    val isClosed: Boolean
+        get() = synchronized(this) { collector == 0L }
+
+    internal fun registerTransaction(surfaceTransaction: Long) = synchronized(this) {
+        checkOpen()
+        nRegisterTransaction(collector, surfaceTransaction)
+    }
+
+    /**
+     * Records a completed platform transaction. Ownership of [presentFence] is transferred to the
+     * collector, which closes it once the record is drained.
+     */
+    @RequiresApi(Build.VERSION_CODES.TIRAMISU)
+    internal fun recordPlatformTransaction(latchTime: Long, presentFence: SyncFence?) {
+        val completeTime = System.nanoTime()
+        synchronized(this) {
+            if (collector != 0L && platformRecords.size < capacity) {
+                platformRecords.addLast(PlatformRecord(completeTime, latchTime, presentFence))
+                return
+            }
+            if (collector != 0L) {
+                platformDroppedCount++
+            }
+        }
+        presentFence?.close()
+    }
+
+    override fun close() = synchronized(this) {
+        if (collector != 0L) {
+            nRelease(collector)
+            collector = 0L
+            while (platformRecords.isNotEmpty()) {
+                closePresentFence(platformRecords.removeFirst().presentFence)
+            }
+        }
+    }
+
+    private fun resolvePresentTime(presentFence: Any?): Long {
+        if (presentFence == null || Build.VERSION.SDK_INT < Build.VERSION_CODES.TIRAMISU) {
+            return SIGNAL_TIME_INVALID
+        }
+        return FrameStatsVerificationHelperV33.resolveSignalTime(presentFence)
+    }
+
+    private fun closePresentFence(presentFence: Any?) {
+        if (presentFence != null && Build.VERSION.SDK_INT >= Build.VERSION_CODES.TIRAMISU) {
+            FrameStatsVerificationHelperV33.close(presentFence)
+        }
+    }
+
+    private fun checkOpen() {
+        check(collector != 0L) { "FrameStatsCollector is closed" }
+    }
+
+    companion object {
+
+        // Must be kept in sync with FrameRecord in frame_stats.h
+
+        /**
+         * Index, within a record, of the time at which the transaction completed
+         */
+        const val COMPLETE_TIME = 0
+
+        /**
+         * Index, within a record, of the time at which SurfaceFlinger latched the transaction
+         */
+        const val LATCH_TIME = 1
+
+        /**
+         * Index, within a record, of the signal time of the present fence
+         */
+        const val PRESENT_TIME = 2
+
+        /**
+         * Index, within a record, of the number of layers in the transaction
+         */
+        const val LAYER_COUNT = 3
+
+        /**
+         * Index, from [layerOffset], of the native ASurfaceControl handle of a layer
+         */
+        const val LAYER_SURFACE_CONTROL = 0
+
+        /**
+         * Index, from [layerOffset], of the time at which the buffer of a layer was acquired
+         */
+        const val LAYER_ACQUIRE_TIME = 1
+
+        /**
+         * Index, from [layerOffset], of the signal time of the release fence of the buffer a
+         * layer replaced
+         */
+        const val LAYER_RELEASE_TIME = 2
+
+        /**
+         * Maximum number of layers recorded per transaction
+         */
+        const val MAX_LAYERS = 4
+
+        /**
+         * Number of longs of a record
+         */
+        const val RECORD_SIZE = 4 + MAX_LAYERS * 3
+
+        /**
+         * Signal time of a fence that does not exist
+         */
+        const val SIGNAL_TIME_INVALID = -1L
+
+        /**
+         * Signal time of a fence that had not signaled yet when its record was drained
+         */
+        const val SIGNAL_TIME_PENDING = Long.MAX_VALUE
+
+        /**
+         * Default maximum number of records waiting to be drained
+         */
+        const val DEFAULT_CAPACITY = 64
+
+        /**
+         * Offset, within a record, of the stats of the layer at the given index
+         */
+        @JvmStatic
+        fun layerOffset(layer: Int): Int = 4 + layer * 3
+
+        @JvmStatic
+        @JniVisible
+        private external fun nCreate(capacity: Int): Long
+
+        @JvmStatic
+        @JniVisible
+        private external fun nRelease(collector: Long)
+
+        @JvmStatic
+        @JniVisible
+        private external fun nRegisterTransaction(collector: Long, surfaceTransaction: Long)
+
+        @JvmStatic
+        @JniVisible
+        private external fun nDrain(collector: Long, records: LongArray, maxRecords: Int): Int
+
+        @JvmStatic
+        @JniVisible
+        private external fun nDroppedCount(collector: Long): Long
+
+        init {
+            System.loadLibrary("graphics-core")
+        }
+    }
+}
+
+/**
+ * Helper class to avoid class verification failures
+ */
+@RequiresApi(Build.VERSION_CODES.TIRAMISU)
+private object FrameStatsVerificationHelperV33 {
+
+    @androidx.annotation.DoNotInline
+    fun resolveSignalTime(presentFence: Any): Long {
+        val fence = presentFence as SyncFence
+        val signalTime = fence.signalTime
+        fence.close()
+        return signalTime
+    }
+
+    @androidx.annotation.DoNotInline
+    fun close(presentFence: Any) {
+        (presentFence as SyncFence).close()
+    }
+}
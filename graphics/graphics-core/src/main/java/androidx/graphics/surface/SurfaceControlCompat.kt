@@ -242,6 +242,9 @@ class SurfaceControlCompat internal constructor(
          *
          * Buffers which are replaced or removed from the scene in the transaction invoking
          * this callback may be reused after this point.
+         *
+         * [transactionStats] is a handle to the native statistics of the transaction, read once
+         * before this callback is invoked. It is only valid for the duration of the callback.
          */
         @JniVisible
         fun onTransactionCompleted(transactionStats: Long)
@@ -417,6 +420,23 @@ class SurfaceControlCompat internal constructor(
             return this
         }
 
+        /**
+         * Records the frame-pacing statistics of this transaction into [collector] once it
+         * completes, see [FrameStatsCollector]. The collector can be added to any number of
+         * transactions, and drained from any thread.
+         *
+         * Transactions are backed by the platform on Android T and above, which only reports
+         * frame statistics from Android U: on Android T this throws.
+         *
+         * @param collector [FrameStatsCollector] receiving the statistics
+         * @throws UnsupportedOperationException on Android T, see above
+         */
+        @Suppress("PairedRegistration")
+        fun addFrameStatsCollector(collector: FrameStatsCollector): Transaction {
+            mImpl.addFrameStatsCollector(collector)
+            return this
+        }
+
         /**
          * Updates the region for the content on this surface updated in this transaction. The
          * damage region is the area of the buffer that has changed since the previously
@@ -210,6 +210,11 @@ internal interface SurfaceControlImpl {
             listener: TransactionCommittedListener
         ): Transaction
 
+        /**
+         * See [SurfaceControlCompat.Transaction.addFrameStatsCollector]
+         */
+        fun addFrameStatsCollector(collector: FrameStatsCollector): Transaction
+
         /**
          * Updates the region for the content on this surface updated in this transaction. The
          * damage region is the area of the buffer that has changed since the previously
@@ -92,10 +92,13 @@ internal class SurfaceControlV29 internal constructor(
     }
 
     /**
-     * See [SurfaceControlWrapper.Transaction]
+     * See [SurfaceControlWrapper.Transaction]. Updates are recorded into
+     * [SurfaceTransactionCommands] and applied to the native transaction with a single JNI call
+     * on [commit].
      */
     class Transaction : SurfaceControlImpl.Transaction {
         private val transaction = SurfaceControlWrapper.Transaction()
+        private val commands = SurfaceTransactionCommands()
         private val uncommittedBufferCallbackMap = HashMap<SurfaceControlImpl, BufferData?>()
         private val pendingSetTransformCalls = HashMap<SurfaceControlImpl, Int>()
 
@@ -117,6 +120,7 @@ internal class SurfaceControlV29 internal constructor(
             updateReleaseCallbacks()
             uncommittedBufferCallbackMap.clear()
             pendingSetTransformCalls.clear()
+            transaction.applyCommands(commands)
             transaction.commit()
         }
 
@@ -176,7 +180,7 @@ internal class SurfaceControlV29 internal constructor(
                             dstWidth = it.width
                             dstHeight = it.height
                         }
-                        transaction.setGeometry(
+                        commands.setGeometry(
                             surfaceControl.asWrapperSurfaceControl(),
                             it.width,
                             it.height,
@@ -196,7 +200,7 @@ internal class SurfaceControlV29 internal constructor(
             surfaceControl: SurfaceControlImpl,
             visible: Boolean
         ): SurfaceControlImpl.Transaction {
-            transaction.setVisibility(surfaceControl.asWrapperSurfaceControl(), visible)
+            commands.setVisibility(surfaceControl.asWrapperSurfaceControl(), visible)
             return this
         }
 
@@ -207,7 +211,7 @@ internal class SurfaceControlV29 internal constructor(
             surfaceControl: SurfaceControlImpl,
             newParent: SurfaceControlImpl?
         ): SurfaceControlImpl.Transaction {
-            transaction.reparent(
+            commands.reparent(
                 surfaceControl.asWrapperSurfaceControl(),
                 newParent?.asWrapperSurfaceControl()
             )
@@ -241,15 +245,11 @@ internal class SurfaceControlV29 internal constructor(
             val targetBuffer = buffer ?: PlaceholderBuffer
             // Ensure if we have a null value, we default to the default value for SyncFence
             // argument to prevent null pointer dereference
-            if (fence == null) {
-                transaction.setBuffer(surfaceControl.asWrapperSurfaceControl(), targetBuffer)
-            } else {
-                transaction.setBuffer(
-                    surfaceControl.asWrapperSurfaceControl(),
-                    targetBuffer,
-                    fence.asSyncFenceCompat()
-                )
-            }
+            commands.setBuffer(
+                surfaceControl.asWrapperSurfaceControl(),
+                targetBuffer,
+                fence?.asSyncFenceCompat()
+            )
 
             return this
         }
@@ -261,7 +261,7 @@ internal class SurfaceControlV29 internal constructor(
             surfaceControl: SurfaceControlImpl,
             z: Int
         ): SurfaceControlImpl.Transaction {
-            transaction.setLayer(surfaceControl.asWrapperSurfaceControl(), z)
+            commands.setLayer(surfaceControl.asWrapperSurfaceControl(), z)
             return this
         }
 
@@ -277,6 +277,16 @@ internal class SurfaceControlV29 internal constructor(
             return this
         }
 
+        /**
+         * See [SurfaceControlWrapper.Transaction.addFrameStatsCollector]
+         */
+        override fun addFrameStatsCollector(
+            collector: FrameStatsCollector
+        ): SurfaceControlImpl.Transaction {
+            transaction.addFrameStatsCollector(collector)
+            return this
+        }
+
         /**
          * See [SurfaceControlWrapper.Transaction.addTransactionCompletedListener]
          */
@@ -294,7 +304,7 @@ internal class SurfaceControlV29 internal constructor(
             surfaceControl: SurfaceControlImpl,
             region: Region?
         ): SurfaceControlImpl.Transaction {
-            transaction.setDamageRegion(surfaceControl.asWrapperSurfaceControl(), region)
+            commands.setDamageRegion(surfaceControl.asWrapperSurfaceControl(), region)
             return this
         }
 
@@ -305,7 +315,7 @@ internal class SurfaceControlV29 internal constructor(
             surfaceControl: SurfaceControlImpl,
             isOpaque: Boolean
         ): SurfaceControlImpl.Transaction {
-            transaction.setOpaque(surfaceControl.asWrapperSurfaceControl(), isOpaque)
+            commands.setOpaque(surfaceControl.asWrapperSurfaceControl(), isOpaque)
             return this
         }
 
@@ -316,7 +326,7 @@ internal class SurfaceControlV29 internal constructor(
             surfaceControl: SurfaceControlImpl,
             alpha: Float
         ): SurfaceControlImpl.Transaction {
-            transaction.setAlpha(surfaceControl.asWrapperSurfaceControl(), alpha)
+            commands.setAlpha(surfaceControl.asWrapperSurfaceControl(), alpha)
             return this
         }
 
@@ -328,7 +338,7 @@ internal class SurfaceControlV29 internal constructor(
             surfaceControl: SurfaceControlImpl,
             crop: Rect?
         ): SurfaceControlImpl.Transaction {
-            transaction.setCrop(surfaceControl.asWrapperSurfaceControl(), crop)
+            commands.setCrop(surfaceControl.asWrapperSurfaceControl(), crop)
             return this
         }
 
@@ -341,7 +351,7 @@ internal class SurfaceControlV29 internal constructor(
             x: Float,
             y: Float
         ): SurfaceControlImpl.Transaction {
-            transaction.setPosition(surfaceControl.asWrapperSurfaceControl(), x, y)
+            commands.setPosition(surfaceControl.asWrapperSurfaceControl(), x, y)
             return this
         }
 
@@ -354,7 +364,7 @@ internal class SurfaceControlV29 internal constructor(
             scaleX: Float,
             scaleY: Float
         ): SurfaceControlImpl.Transaction {
-            transaction.setScale(surfaceControl.asWrapperSurfaceControl(), scaleX, scaleY)
+            commands.setScale(surfaceControl.asWrapperSurfaceControl(), scaleX, scaleY)
             return this
         }
 
@@ -366,7 +376,7 @@ internal class SurfaceControlV29 internal constructor(
             @SurfaceControlCompat.Companion.BufferTransform transformation: Int
         ): Transaction {
             if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.S) {
-                transaction.setBufferTransform(
+                commands.setBufferTransform(
                     surfaceControl.asWrapperSurfaceControl(),
                     transformation
                 )
@@ -398,7 +408,7 @@ internal class SurfaceControlV29 internal constructor(
             surfaceControl: SurfaceControlImpl,
             dataSpace: Int
         ): SurfaceControlImpl.Transaction {
-            transaction.setDataSpace(surfaceControl.asWrapperSurfaceControl(), dataSpace)
+            commands.setDataSpace(surfaceControl.asWrapperSurfaceControl(), dataSpace)
             return this
         }
 
@@ -411,7 +421,7 @@ internal class SurfaceControlV29 internal constructor(
             compatibility: Int,
             changeFrameRateStrategy: Int
         ): Transaction {
-            transaction.setFrameRate(
+            commands.setFrameRate(
                 scImpl.asWrapperSurfaceControl(),
                 frameRate,
                 compatibility,
@@ -437,6 +447,7 @@ internal class SurfaceControlV29 internal constructor(
          * See [SurfaceControlWrapper.Transaction.close]
          */
         override fun close() {
+            commands.reset()
             transaction.close()
         }
 
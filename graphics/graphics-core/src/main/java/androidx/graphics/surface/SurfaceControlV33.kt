@@ -189,6 +189,26 @@ internal class SurfaceControlV33 internal constructor(
             return this
         }
 
+        /**
+         * See [SurfaceControlCompat.Transaction.addFrameStatsCollector]
+         */
+        override fun addFrameStatsCollector(
+            collector: FrameStatsCollector
+        ): SurfaceControlImpl.Transaction {
+            if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.UPSIDE_DOWN_CAKE) {
+                SurfaceControlTransactionVerificationHelperV34.addFrameStatsCollector(
+                    mTransaction,
+                    collector
+                )
+                return this
+            } else {
+                throw UnsupportedOperationException(
+                    "Collecting the frame statistics of platform transactions is only " +
+                        "available on Android U+"
+                )
+            }
+        }
+
         /**
          * See [SurfaceControlImpl.Transaction.setDamageRegion]
          */
@@ -392,6 +412,13 @@ private object SurfaceControlTransactionVerificationHelperV34 {
     ) {
         transaction.setExtendedRangeBrightness(surfaceControl, currentBufferRatio, desiredRatio)
     }
+
+    @androidx.annotation.DoNotInline
+    fun addFrameStatsCollector(transaction: Transaction, collector: FrameStatsCollector) {
+        transaction.addTransactionCompletedListener(Runnable::run) { stats ->
+            collector.recordPlatformTransaction(stats.latchTimeNanos, stats.presentFence)
+        }
+    }
 }
 
 @RequiresApi(Build.VERSION_CODES.TIRAMISU)
@@ -18,6 +18,7 @@ package androidx.graphics.surface
 
 import android.graphics.Rect
 import android.graphics.Region
+import android.graphics.RegionIterator
 import android.hardware.HardwareBuffer
 import android.os.Build
 import android.view.Surface
@@ -25,6 +26,7 @@ import android.view.SurfaceControl
 import androidx.annotation.RequiresApi
 import androidx.graphics.utils.JniVisible
 import androidx.hardware.SyncFenceV19
+import java.nio.ByteBuffer
 import java.util.concurrent.Executor
 
 @JniVisible
@@ -82,7 +84,7 @@ internal class JniBindings {
             surfaceTransaction: Long,
             surfaceControl: Long,
             hardwareBuffer: HardwareBuffer?,
-            acquireFieldFd: SyncFenceV19
+            acquireFenceFd: Int
         )
 
         @JvmStatic
@@ -116,6 +118,15 @@ internal class JniBindings {
             rect: Rect?
         )
 
+        @JvmStatic
+        @JniVisible
+        external fun nSetDamageRegions(
+            surfaceTransaction: Long,
+            surfaceControl: Long,
+            rects: IntArray,
+            rectCount: Int
+        )
+
         @JvmStatic
         @JniVisible
         external fun nSetDesiredPresentTime(
@@ -202,6 +213,17 @@ internal class JniBindings {
             changeFrameRateStrategy: Int
             )
 
+        @JvmStatic
+        @JniVisible
+        external fun nApplyCommands(
+            surfaceTransaction: Long,
+            commands: ByteBuffer,
+            size: Int,
+            hardwareBuffers: Array<HardwareBuffer?>,
+            fenceFds: IntArray,
+            slotCount: Int
+        ): Int
+
         init {
             System.loadLibrary("graphics-core")
         }
@@ -245,6 +267,8 @@ internal class SurfaceControlWrapper {
      */
     class Transaction() {
         private var mNativeSurfaceTransaction: Long
+        // Packed rects of the last complex damage region, reused across frames
+        private var damageRects = IntArray(16)
 
         init {
             mNativeSurfaceTransaction = JniBindings.nTransactionCreate()
@@ -284,6 +308,17 @@ internal class SurfaceControlWrapper {
             return this
         }
 
+        /**
+         * Records the frame statistics of this transaction into [collector] once it completes.
+         * Unlike [addTransactionCompletedListener] the statistics are gathered natively without
+         * calling back into Java.
+         */
+        @Suppress("PairedRegistration")
+        internal fun addFrameStatsCollector(collector: FrameStatsCollector): Transaction {
+            collector.registerTransaction(mNativeSurfaceTransaction)
+            return this
+        }
+
         /**
          * Sets the callback that is invoked once the updates from this transaction are
          * applied and ready to be presented. This callback is invoked before the
@@ -338,13 +373,33 @@ internal class SurfaceControlWrapper {
         fun setBuffer(
             surfaceControl: SurfaceControlWrapper,
             hardwareBuffer: HardwareBuffer?,
-            syncFence: SyncFenceV19 = SyncFenceV19(-1)
+            syncFence: SyncFenceV19? = null
+        ): Transaction {
+            val fenceFd = if (hardwareBuffer != null && syncFence != null) {
+                syncFence.dupeFd()
+            } else {
+                -1
+            }
+            return setBufferWithFenceFd(surfaceControl, hardwareBuffer, fenceFd)
+        }
+
+        /**
+         * Variant of [setBuffer] taking the acquire fence as a raw file descriptor, for callers
+         * that already own one. Ownership of [acquireFenceFd] is transferred to the transaction,
+         * the file descriptor is closed if [hardwareBuffer] is null.
+         *
+         * @param acquireFenceFd File descriptor of the presentation fence, or -1 for none
+         */
+        fun setBufferWithFenceFd(
+            surfaceControl: SurfaceControlWrapper,
+            hardwareBuffer: HardwareBuffer?,
+            acquireFenceFd: Int
         ): Transaction {
             JniBindings.nSetBuffer(
                 mNativeSurfaceTransaction,
                 surfaceControl.mNativeSurfaceControl,
                 hardwareBuffer,
-                syncFence
+                acquireFenceFd
             )
             return this
         }
@@ -427,10 +482,60 @@ internal class SurfaceControlWrapper {
             surfaceControl: SurfaceControlWrapper,
             region: Region?
         ): Transaction {
-            JniBindings.nSetDamageRegion(
+            if (region == null || region.isRect) {
+                JniBindings.nSetDamageRegion(
+                    mNativeSurfaceTransaction,
+                    surfaceControl.mNativeSurfaceControl,
+                    region?.bounds
+                )
+                return this
+            }
+            // Hand the individual rects of complex regions over instead of their bounds
+            var rects = damageRects
+            var rectCount = 0
+            val iterator = RegionIterator(region)
+            val rect = Rect()
+            while (iterator.next(rect)) {
+                if ((rectCount + 1) * 4 > rects.size) {
+                    rects = rects.copyOf(rects.size * 2)
+                }
+                rects[rectCount * 4] = rect.left
+                rects[rectCount * 4 + 1] = rect.top
+                rects[rectCount * 4 + 2] = rect.right
+                rects[rectCount * 4 + 3] = rect.bottom
+                rectCount++
+            }
+            damageRects = rects
+            return setDamageRegion(surfaceControl, rects, rectCount)
+        }
+
+        /**
+         * Updates the damage region of the surface with multiple rects, packed in [rects] as
+         * consecutive left, top, right, bottom values. Overlapping and adjacent rects are merged
+         * natively and the region is coalesced down to the handful of rects compositors track,
+         * so that scattered updates such as a cursor and a status indicator are not reported as
+         * a single large rect. Setting no rects marks nothing as damaged, pass a null [Region] to
+         * [setDamageRegion] to mark the entire buffer as damaged.
+         *
+         * @param surfaceControl The surface control for which we want to set the damage region of.
+         *
+         * @param rects The packed rects of the region
+         *
+         * @param rectCount Number of rects to read from [rects]
+         */
+        fun setDamageRegion(
+            surfaceControl: SurfaceControlWrapper,
+            rects: IntArray,
+            rectCount: Int = rects.size / 4
+        ): Transaction {
+            require(rectCount >= 0 && rectCount * 4 <= rects.size) {
+                "rectCount must be between 0 and the number of rects in the array"
+            }
+            JniBindings.nSetDamageRegions(
                 mNativeSurfaceTransaction,
                 surfaceControl.mNativeSurfaceControl,
-                region?.bounds
+                rects,
+                rectCount
             )
             return this
         }
@@ -684,6 +789,22 @@ internal class SurfaceControlWrapper {
             return this
         }
 
+        /**
+         * Applies all the updates recorded in [commands] to this transaction with a single JNI
+         * call, in the order they were recorded, then resets [commands] so that it can record the
+         * updates of the next frame.
+         *
+         * @throws IllegalStateException if the commands cannot be decoded
+         */
+        fun applyCommands(commands: SurfaceTransactionCommands): Transaction {
+            if (commands.isEmpty()) {
+                return this
+            }
+            val result = commands.applyTo(mNativeSurfaceTransaction)
+            check(result >= 0) { "Malformed transaction commands" }
+            return this
+        }
+
         /**
          * Destroys the transaction object.
          */
@@ -0,0 +1,369 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package androidx.graphics.surface
+
+import android.graphics.Rect
+import android.graphics.Region
+import android.graphics.RegionIterator
+import android.hardware.HardwareBuffer
+import android.os.Build
+import androidx.annotation.RequiresApi
+import androidx.hardware.SyncFenceV19
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+
+/**
+ * Records updates to [SurfaceControlWrapper] layers into a direct [ByteBuffer] so that all the
+ * updates of a frame are applied to an ASurfaceTransaction with a single JNI call, through
+ * [SurfaceControlWrapper.Transaction.applyCommands], instead of one call per property. Native
+ * code decodes the buffer in transaction_commands.cpp, the encoding of each command must be kept
+ * in sync with it.
+ *
+ * Fences passed to [setBuffer] are duplicated when recorded, so the caller keeps ownership of
+ * them. Buffers are only resolved when the commands are applied, they must remain valid until
+ * then. The storage is reused across frames once the commands are applied or [reset].
+ */
+internal class SurfaceTransactionCommands(initialCapacity: Int = 1024) {
+
+    private var commands: ByteBuffer = allocate(initialCapacity)
+    private var hardwareBuffers = arrayOfNulls<HardwareBuffer>(4)
+    private var fenceFds = IntArray(4) { -1 }
+    private var slotCount = 0
+    private val damageRect = Rect()
+
+    /**
+     * Number of commands recorded since the last [reset]
+     */
+    var commandCount = 0
+        private set
+
+    fun isEmpty(): Boolean = commandCount == 0
+
+    /**
+     * See [SurfaceControlWrapper.Transaction.setBuffer]
+     */
+    fun setBuffer(
+        surfaceControl: SurfaceControlWrapper,
+        hardwareBuffer: HardwareBuffer?,
+        syncFence: SyncFenceV19? = null
+    ): SurfaceTransactionCommands {
+        if (slotCount == hardwareBuffers.size) {
+            hardwareBuffers = hardwareBuffers.copyOf(slotCount * 2)
+            fenceFds = fenceFds.copyOf(slotCount * 2).apply { fill(-1, slotCount) }
+        }
+        hardwareBuffers[slotCount] = hardwareBuffer
+        fenceFds[slotCount] = if (hardwareBuffer != null && syncFence != null) {
+            syncFence.dupeFd()
+        } else {
+            -1
+        }
+        begin(SET_BUFFER, surfaceControl, 4).putInt(slotCount)
+        slotCount++
+        return this
+    }
+
+    /**
+     * See [SurfaceControlWrapper.Transaction.setVisibility]
+     */
+    fun setVisibility(
+        surfaceControl: SurfaceControlWrapper,
+        visibility: Boolean
+    ): SurfaceTransactionCommands {
+        begin(SET_VISIBILITY, surfaceControl, 4).putInt(if (visibility) 1 else 0)
+        return this
+    }
+
+    /**
+     * See [SurfaceControlWrapper.Transaction.setLayer]
+     */
+    fun setLayer(surfaceControl: SurfaceControlWrapper, zOrder: Int): SurfaceTransactionCommands {
+        begin(SET_Z_ORDER, surfaceControl, 4).putInt(zOrder)
+        return this
+    }
+
+    /**
+     * Updates the damage region of the surface with the given rects. As with
+     * [SurfaceControlWrapper.Transaction.setDamageRegion], null marks the entire buffer as damaged
+     * and an empty array marks nothing as damaged.
+     */
+    fun setDamageRegion(
+        surfaceControl: SurfaceControlWrapper,
+        rects: Array<Rect>?
+    ): SurfaceTransactionCommands {
+        if (rects == null) {
+            begin(SET_DAMAGE_REGION, surfaceControl, 4).putInt(ENTIRE_BUFFER_DAMAGED)
+            return this
+        }
+        val buffer = begin(SET_DAMAGE_REGION, surfaceControl, 4 + rects.size * 16)
+        buffer.putInt(rects.size)
+        for (rect in rects) {
+            buffer.putInt(rect.left).putInt(rect.top).putInt(rect.right).putInt(rect.bottom)
+        }
+        return this
+    }
+
+    /**
+     * See [SurfaceControlWrapper.Transaction.setDamageRegion]. The rects of [region] are recorded
+     * individually rather than its bounds.
+     */
+    fun setDamageRegion(
+        surfaceControl: SurfaceControlWrapper,
+        region: Region?
+    ): SurfaceTransactionCommands {
+        if (region == null) {
+            begin(SET_DAMAGE_REGION, surfaceControl, 4).putInt(ENTIRE_BUFFER_DAMAGED)
+            return this
+        }
+        // The rect count is only known once the region is iterated
+        val countPosition = begin(SET_DAMAGE_REGION, surfaceControl, 4).position()
+        commands.putInt(0)
+        var rectCount = 0
+        val iterator = RegionIterator(region)
+        val rect = damageRect
+        while (iterator.next(rect)) {
+            ensureCapacity(16)
+            commands.putInt(rect.left).putInt(rect.top).putInt(rect.right).putInt(rect.bottom)
+            rectCount++
+        }
+        commands.putInt(countPosition, rectCount)
+        return this
+    }
+
+    /**
+     * See [SurfaceControlWrapper.Transaction.setDesiredPresentTime]
+     */
+    fun setDesiredPresentTime(desiredPresentTimeNano: Long): SurfaceTransactionCommands {
+        ensureCapacity(12)
+        commands.putInt(SET_DESIRED_PRESENT_TIME).putLong(desiredPresentTimeNano)
+        commandCount++
+        return this
+    }
+
+    /**
+     * See [SurfaceControlWrapper.Transaction.setOpaque]
+     */
+    fun setOpaque(
+        surfaceControl: SurfaceControlWrapper,
+        isOpaque: Boolean
+    ): SurfaceTransactionCommands {
+        begin(SET_BUFFER_TRANSPARENCY, surfaceControl, 4).putInt(if (isOpaque) 2 else 0)
+        return this
+    }
+
+    /**
+     * See [SurfaceControlWrapper.Transaction.setAlpha]
+     */
+    fun setAlpha(surfaceControl: SurfaceControlWrapper, alpha: Float): SurfaceTransactionCommands {
+        require(alpha in 0.0f..1.0f) { "Alpha value must be between 0.0 and 1.0." }
+        begin(SET_BUFFER_ALPHA, surfaceControl, 4).putFloat(alpha)
+        return this
+    }
+
+    /**
+     * See [SurfaceControlWrapper.Transaction.setCrop]
+     */
+    @RequiresApi(Build.VERSION_CODES.S)
+    fun setCrop(surfaceControl: SurfaceControlWrapper, crop: Rect?): SurfaceTransactionCommands {
+        require((crop == null) || (crop.width() >= 0 && crop.height() >= 0)) {
+            "width and height must be non-negative"
+        }
+        val buffer = begin(SET_CROP, surfaceControl, 16)
+        if (crop == null) {
+            buffer.putInt(0).putInt(0).putInt(0).putInt(0)
+        } else {
+            buffer.putInt(crop.left).putInt(crop.top).putInt(crop.right).putInt(crop.bottom)
+        }
+        return this
+    }
+
+    /**
+     * See [SurfaceControlWrapper.Transaction.setPosition]
+     */
+    @RequiresApi(Build.VERSION_CODES.S)
+    fun setPosition(
+        surfaceControl: SurfaceControlWrapper,
+        x: Float,
+        y: Float
+    ): SurfaceTransactionCommands {
+        begin(SET_POSITION, surfaceControl, 8).putFloat(x).putFloat(y)
+        return this
+    }
+
+    /**
+     * See [SurfaceControlWrapper.Transaction.setScale]
+     */
+    @RequiresApi(Build.VERSION_CODES.S)
+    fun setScale(
+        surfaceControl: SurfaceControlWrapper,
+        scaleX: Float,
+        scaleY: Float
+    ): SurfaceTransactionCommands {
+        begin(SET_SCALE, surfaceControl, 8).putFloat(scaleX).putFloat(scaleY)
+        return this
+    }
+
+    /**
+     * See [SurfaceControlWrapper.Transaction.setBufferTransform]
+     */
+    @RequiresApi(Build.VERSION_CODES.S)
+    fun setBufferTransform(
+        surfaceControl: SurfaceControlWrapper,
+        transformation: Int
+    ): SurfaceTransactionCommands {
+        begin(SET_BUFFER_TRANSFORM, surfaceControl, 4).putInt(transformation)
+        return this
+    }
+
+    /**
+     * See [SurfaceControlWrapper.Transaction.setDataSpace]
+     */
+    fun setDataSpace(
+        surfaceControl: SurfaceControlWrapper,
+        dataSpace: Int
+    ): SurfaceTransactionCommands {
+        begin(SET_DATA_SPACE, surfaceControl, 4).putInt(dataSpace)
+        return this
+    }
+
+    /**
+     * See [SurfaceControlWrapper.Transaction.setGeometry]
+     */
+    fun setGeometry(
+        surfaceControl: SurfaceControlWrapper,
+        width: Int,
+        height: Int,
+        dstWidth: Int,
+        dstHeight: Int,
+        transformation: Int
+    ): SurfaceTransactionCommands {
+        begin(SET_GEOMETRY, surfaceControl, 20)
+            .putInt(width)
+            .putInt(height)
+            .putInt(dstWidth)
+            .putInt(dstHeight)
+            .putInt(transformation)
+        return this
+    }
+
+    /**
+     * See [SurfaceControlWrapper.Transaction.setFrameRate]
+     */
+    fun setFrameRate(
+        surfaceControl: SurfaceControlWrapper,
+        frameRate: Float,
+        compatibility: Int,
+        changeFrameRateStrategy: Int
+    ): SurfaceTransactionCommands {
+        begin(SET_FRAME_RATE, surfaceControl, 12)
+            .putFloat(frameRate)
+            .putInt(compatibility)
+            .putInt(changeFrameRateStrategy)
+        return this
+    }
+
+    /**
+     * See [SurfaceControlWrapper.Transaction.reparent]
+     */
+    fun reparent(
+        surfaceControl: SurfaceControlWrapper,
+        newParent: SurfaceControlWrapper?
+    ): SurfaceTransactionCommands {
+        begin(REPARENT, surfaceControl, 8).putLong(newParent?.mNativeSurfaceControl ?: 0L)
+        return this
+    }
+
+    /**
+     * Discards all the recorded commands, releases the references to the recorded buffers and
+     * closes the duplicated fences
+     */
+    fun reset() {
+        for (i in 0 until slotCount) {
+            val fd = fenceFds[i]
+            if (fd != -1) {
+                SyncFenceV19(fd).close()
+            }
+        }
+        clear()
+    }
+
+    internal fun applyTo(surfaceTransaction: Long): Int {
+        // Ownership of the duplicated fences is transferred to native code
+        val result = JniBindings.nApplyCommands(
+            surfaceTransaction,
+            commands,
+            commands.position(),
+            hardwareBuffers,
+            fenceFds,
+            slotCount
+        )
+        clear()
+        return result
+    }
+
+    private fun clear() {
+        commands.clear()
+        hardwareBuffers.fill(null, 0, slotCount)
+        fenceFds.fill(-1, 0, slotCount)
+        slotCount = 0
+        commandCount = 0
+    }
+
+    private fun begin(
+        opcode: Int,
+        surfaceControl: SurfaceControlWrapper,
+        argumentSize: Int
+    ): ByteBuffer {
+        ensureCapacity(12 + argumentSize)
+        commands.putInt(opcode).putLong(surfaceControl.mNativeSurfaceControl)
+        commandCount++
+        return commands
+    }
+
+    private fun ensureCapacity(size: Int) {
+        if (commands.remaining() < size) {
+            val grown = allocate(maxOf(commands.capacity() * 2, commands.position() + size))
+            commands.flip()
+            grown.put(commands)
+            commands = grown
+        }
+    }
+
+    private companion object {
+        // Must be kept in sync with TransactionCommand in transaction_commands.h
+        const val SET_BUFFER = 1
+        const val SET_VISIBILITY = 2
+        const val SET_Z_ORDER = 3
+        const val SET_DAMAGE_REGION = 4
+        const val SET_DESIRED_PRESENT_TIME = 5
+        const val SET_BUFFER_TRANSPARENCY = 6
+        const val SET_BUFFER_ALPHA = 7
+        const val SET_CROP = 8
+        const val SET_POSITION = 9
+        const val SET_SCALE = 10
+        const val SET_BUFFER_TRANSFORM = 11
+        const val SET_DATA_SPACE = 12
+        const val SET_GEOMETRY = 13
+        const val SET_FRAME_RATE = 14
+        const val REPARENT = 15
+
+        // Rect count of a SET_DAMAGE_REGION command that marks the entire buffer as damaged
+        const val ENTIRE_BUFFER_DAMAGED = -1
+
+        fun allocate(capacity: Int): ByteBuffer =
+            ByteBuffer.allocateDirect(capacity).order(ByteOrder.nativeOrder())
+    }
+}
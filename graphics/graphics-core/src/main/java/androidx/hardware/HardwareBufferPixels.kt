@@ -0,0 +1,140 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package androidx.hardware
+
+import android.hardware.HardwareBuffer
+import android.os.Build
+import androidx.annotation.RequiresApi
+import androidx.graphics.utils.JniVisible
+
+/**
+ * CPU fill, copy and blend of [HardwareBuffer] regions, backed by the kernels in
+ * pixel_kernels.cpp. Buffers are locked for CPU access for the duration of each call, so they
+ * must have been allocated with [HardwareBuffer.USAGE_CPU_WRITE_OFTEN], and
+ * [HardwareBuffer.USAGE_CPU_READ_OFTEN] for the source of [copy] and both buffers of [blend].
+ *
+ * Only [HardwareBuffer.RGBA_8888] and [HardwareBuffer.RGBX_8888] buffers are supported. Rects are
+ * clipped to the bounds of the buffers and the row stride of each buffer is honored.
+ */
+@RequiresApi(Build.VERSION_CODES.O)
+@JniVisible
+internal class HardwareBufferPixels private constructor() {
+    companion object {
+
+        /**
+         * Fills the given rect of [buffer] with [color], given as an ARGB color int
+         *
+         * @return `true` if the buffer was updated, `false` if it could not be locked or has an
+         * unsupported format
+         */
+        @JvmStatic
+        fun fill(
+            buffer: HardwareBuffer,
+            left: Int,
+            top: Int,
+            right: Int,
+            bottom: Int,
+            color: Int
+        ): Boolean {
+            // RGBA_8888 stores red in the lowest byte of each native endian pixel
+            val abgr = (color and 0xff00ff00.toInt()) or
+                ((color shr 16) and 0xff) or
+                ((color and 0xff) shl 16)
+            return nFill(buffer, left, top, right, bottom, abgr)
+        }
+
+        /**
+         * Copies the given rect of [src] to [dst], with its top left corner at ([dstX], [dstY]).
+         * [src] and [dst] must be different buffers.
+         *
+         * @return `true` if [dst] was updated, `false` if either buffer could not be locked or
+         * has an unsupported format
+         */
+        @JvmStatic
+        fun copy(
+            dst: HardwareBuffer,
+            dstX: Int,
+            dstY: Int,
+            src: HardwareBuffer,
+            left: Int,
+            top: Int,
+            right: Int,
+            bottom: Int
+        ): Boolean = nCopy(dst, dstX, dstY, src, left, top, right, bottom)
+
+        /**
+         * Composites the given rect of [src] over [dst], with its top left corner at
+         * ([dstX], [dstY]). Both buffers are expected to contain premultiplied alpha, the
+         * source over operator is applied. [src] and [dst] must be different buffers.
+         *
+         * @return `true` if [dst] was updated, `false` if either buffer could not be locked or
+         * has an unsupported format
+         */
+        @JvmStatic
+        fun blend(
+            dst: HardwareBuffer,
+            dstX: Int,
+            dstY: Int,
+            src: HardwareBuffer,
+            left: Int,
+            top: Int,
+            right: Int,
+            bottom: Int
+        ): Boolean = nBlend(dst, dstX, dstY, src, left, top, right, bottom)
+
+        @JvmStatic
+        @JniVisible
+        private external fun nFill(
+            buffer: HardwareBuffer,
+            left: Int,
+            top: Int,
+            right: Int,
+            bottom: Int,
+            color: Int
+        ): Boolean
+
+        @JvmStatic
+        @JniVisible
+        private external fun nCopy(
+            dst: HardwareBuffer,
+            dstX: Int,
+            dstY: Int,
+            src: HardwareBuffer,
+            left: Int,
+            top: Int,
+            right: Int,
+            bottom: Int
+        ): Boolean
+
+        @JvmStatic
+        @JniVisible
+        private external fun nBlend(
+            dst: HardwareBuffer,
+            dstX: Int,
+            dstY: Int,
+            src: HardwareBuffer,
+            left: Int,
+            top: Int,
+            right: Int,
+            bottom: Int
+        ): Boolean
+
+        init {
+            System.loadLibrary("graphics-core")
+        }
+    }
+}
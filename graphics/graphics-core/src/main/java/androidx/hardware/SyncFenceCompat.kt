@@ -25,6 +25,7 @@ import androidx.graphics.lowlatency.FrontBufferUtils
 import androidx.graphics.surface.SurfaceControlCompat
 import androidx.opengl.EGLExt
 import androidx.opengl.EGLSyncKHR
+import java.util.concurrent.TimeUnit
 
 /**
  * A synchronization primitive which signals when hardware units have completed work on a
@@ -66,6 +67,163 @@ class SyncFenceCompat : AutoCloseable {
             }
         }
 
+        /**
+         * Waits for all of the provided fences to signal for up to the [timeoutNanos] duration.
+         * Invalid fences are treated as fences that have already signaled.
+         *
+         * Fences created by this library are waited on with a single poll over all of their file
+         * descriptors rather than one wait per fence. Platform fences, used on Android T and
+         * above, are waited on one after another within the same overall timeout.
+         *
+         * @param fences Fences to wait on
+         * @param timeoutNanos Timeout duration in nanoseconds. Providing a negative value will
+         * wait indefinitely until all the fences are signaled
+         * @param signaled Optional array of at least [fences] size that receives, for each fence,
+         * whether it signaled. This is useful to find which fences are still pending after a
+         * timeout
+         * @return `true` if all the fences signaled, `false` otherwise. Fences in an error state
+         * never signal, they are reported as not signaled
+         * @throws IllegalStateException if the fences cannot be waited on
+         */
+        @JvmStatic
+        @JvmOverloads
+        fun awaitAll(
+            fences: Array<SyncFenceCompat>,
+            timeoutNanos: Long,
+            signaled: BooleanArray? = null
+        ): Boolean = awaitMany(fences, true, timeoutNanos, signaled) == fences.size
+
+        /**
+         * Waits for any of the provided fences to signal for up to the [timeoutNanos] duration.
+         * Invalid fences are treated as fences that have already signaled.
+         *
+         * Fences created by this library are waited on with a single poll over all of their file
+         * descriptors. Platform fences, used on Android T and above, are polled in turn until one
+         * of them signals or the timeout expires.
+         *
+         * @param fences Fences to wait on
+         * @param timeoutNanos Timeout duration in nanoseconds. Providing a negative value will
+         * wait indefinitely until one of the fences is signaled
+         * @param signaled Optional array of at least [fences] size that receives, for each fence,
+         * whether it signaled
+         * @return The number of fences that signaled, 0 if the timeout expired. Fences in an error
+         * state never signal: they are reported as not signaled and the wait goes on for the
+         * other fences, returning 0 once none of them can signal anymore
+         * @throws IllegalStateException if the fences cannot be waited on
+         */
+        @JvmStatic
+        @JvmOverloads
+        fun awaitAny(
+            fences: Array<SyncFenceCompat>,
+            timeoutNanos: Long,
+            signaled: BooleanArray? = null
+        ): Int = awaitMany(fences, false, timeoutNanos, signaled)
+
+        /**
+         * Creates a new fence that signals once all of the provided fences have signaled. The
+         * provided fences remain owned by the caller. Invalid fences are ignored, merging only
+         * invalid fences returns an invalid fence.
+         *
+         * Only fences created by this library can be merged. Platform fences, which
+         * [createNativeSyncFence] returns on Android T and above, do not expose their file
+         * descriptors, so this is not part of the public API.
+         *
+         * @throws IllegalArgumentException if one of the fences is a platform fence
+         * @throws IllegalStateException if the fences cannot be merged
+         */
+        @JvmStatic
+        internal fun merge(fences: Array<SyncFenceCompat>): SyncFenceCompat {
+            val impls = Array(fences.size) { i ->
+                fences[i].mImpl as? SyncFenceV19
+                    ?: throw IllegalArgumentException("Only compat fences can be merged")
+            }
+            return SyncFenceCompat(SyncFenceV19.merge(impls))
+        }
+
+        /**
+         * Returns the times at which the provided fences signaled in the [CLOCK_MONOTONIC] time
+         * domain, see [getSignalTimeNanos]. Invalid fences resolve to [SIGNAL_TIME_INVALID] and
+         * fences that have not signaled yet to [SIGNAL_TIME_PENDING].
+         *
+         * Fences created by this library are queried with a single native call that does not
+         * allocate per fence. Platform fences, used on Android T and above, are queried in turn.
+         *
+         * @param fences Fences to query
+         * @param signalTimes Array of at least [fences] size that receives the signal times
+         */
+        @JvmStatic
+        @RequiresApi(Build.VERSION_CODES.O)
+        fun getSignalTimesNanos(fences: Array<SyncFenceCompat>, signalTimes: LongArray) {
+            require(signalTimes.size >= fences.size) {
+                "signalTimes must hold at least ${fences.size} values"
+            }
+            if (fences.all { fence -> fence.mImpl is SyncFenceV19 }) {
+                val impls = Array(fences.size) { i -> fences[i].mImpl as SyncFenceV19 }
+                SyncFenceV19.getSignalTimes(impls, signalTimes)
+            } else {
+                for (i in fences.indices) {
+                    signalTimes[i] = fences[i].getSignalTimeNanos()
+                }
+            }
+        }
+
+        private fun awaitMany(
+            fences: Array<SyncFenceCompat>,
+            waitForAll: Boolean,
+            timeoutNanos: Long,
+            signaled: BooleanArray?
+        ): Int {
+            require(signaled == null || signaled.size >= fences.size) {
+                "signaled must hold at least ${fences.size} values"
+            }
+            if (fences.all { fence -> fence.mImpl is SyncFenceV19 }) {
+                val impls = Array(fences.size) { i -> fences[i].mImpl as SyncFenceV19 }
+                val count = SyncFenceV19.awaitMany(impls, waitForAll, timeoutNanos, signaled)
+                check(count >= 0) { "Unable to wait on the fences" }
+                return count
+            }
+            return awaitManyInTurn(fences, waitForAll, timeoutNanos, signaled)
+        }
+
+        // Fallback for platform fences, which do not expose their file descriptors
+        private fun awaitManyInTurn(
+            fences: Array<SyncFenceCompat>,
+            waitForAll: Boolean,
+            timeoutNanos: Long,
+            signaled: BooleanArray?
+        ): Int {
+            val deadline = System.nanoTime() + timeoutNanos
+            val done = BooleanArray(fences.size)
+            var count = 0
+            while (true) {
+                for (i in fences.indices) {
+                    if (done[i]) continue
+                    val timeout = when {
+                        timeoutNanos < 0 && waitForAll -> -1L
+                        waitForAll -> (deadline - System.nanoTime()).coerceAtLeast(0L)
+                        else -> 0L
+                    }
+                    if (fences[i].await(timeout)) {
+                        done[i] = true
+                        count++
+                    }
+                }
+                val remaining = deadline - System.nanoTime()
+                if (waitForAll || count > 0 || (timeoutNanos >= 0 && remaining <= 0)) break
+                // Platform fences can only be waited on one at a time, poll them in turn
+                val slice = if (timeoutNanos < 0) {
+                    POLL_SLICE_NANOS
+                } else {
+                    minOf(remaining, POLL_SLICE_NANOS)
+                }
+                Thread.sleep(TimeUnit.NANOSECONDS.toMillis(slice), (slice % 1_000_000).toInt())
+            }
+            signaled?.let { done.copyInto(it) }
+            return count
+        }
+
+        private const val POLL_SLICE_NANOS = 1_000_000L
+
         /**
          * An invalid signal time. Represents either the signal time for a SyncFence that isn't
          * valid (that is, [isValid] is `false`), or if an error occurred while attempting to
@@ -61,6 +61,12 @@ internal class SyncFenceV19(private var fd: Int) : AutoCloseable, SyncFenceImpl
         }
     }
 
+    /**
+     * Returns a duplicate of the file descriptor owned by the caller, or -1 if the fence is
+     * invalid. Used to hand the fence to native code without it calling back into Java.
+     */
+    internal fun dupeFd(): Int = dupeFileDescriptor()
+
     // Accessed through JNI to obtain the dup'ed file descriptor in a thread safe manner
     @JniVisible
     private fun dupeFileDescriptor(): Int = fenceLock.withLock {
@@ -146,5 +152,103 @@ internal class SyncFenceV19(private var fd: Int) : AutoCloseable, SyncFenceImpl
         init {
             System.loadLibrary("graphics-core")
         }
+
+        /**
+         * Waits for any or all of the provided fences to signal with a single poll over all of
+         * their file descriptors. Invalid fences are treated as fences that have already
+         * signaled.
+         *
+         * @param fences Fences to wait on
+         * @param waitForAll `true` to wait for all the fences, `false` to wait for any of them
+         * @param timeoutNanos Timeout duration in nanoseconds, negative values wait indefinitely
+         * @param signaled Optional array of at least [fences] size that receives, for each fence,
+         * whether it signaled
+         * @return The number of fences that signaled, or -1 if the fences cannot be polled.
+         * Fences in an error state are reported as not signaled
+         */
+        internal fun awaitMany(
+            fences: Array<SyncFenceV19>,
+            waitForAll: Boolean,
+            timeoutNanos: Long,
+            signaled: BooleanArray?
+        ): Int {
+            val timeout = if (timeoutNanos < 0) {
+                -1
+            } else {
+                TimeUnit.NANOSECONDS.toMillis(timeoutNanos).toInt()
+            }
+            // Wait on duplicates so that fences closed concurrently do not affect the poll,
+            // nWaitMany closes them
+            val fds = IntArray(fences.size) { i -> fences[i].dupeFileDescriptor() }
+            return nWaitMany(fds, waitForAll, timeout, signaled)
+        }
+
+        /**
+         * Creates a fence that signals once all the provided fences have signaled. Invalid fences
+         * are ignored, merging only invalid fences returns an invalid fence.
+         *
+         * @throws IllegalStateException if the fences cannot be merged
+         */
+        internal fun merge(fences: Array<SyncFenceV19>): SyncFenceV19 {
+            val fds = IntArray(fences.size) { i -> fences[i].dupeFileDescriptor() }
+            if (fds.all { fd -> fd == -1 }) {
+                return SyncFenceV19(-1)
+            }
+            // nMerge closes the duplicates
+            val fd = nMerge(fds)
+            if (fd == -1) {
+                throw IllegalStateException("Unable to merge fences")
+            }
+            return SyncFenceV19(fd)
+        }
+
+        /**
+         * Resolves the signal times of all the provided fences with a single native call, see
+         * [getSignalTimeNanos]. Invalid fences resolve to [SyncFenceCompat.SIGNAL_TIME_INVALID].
+         *
+         * @param fences Fences to query
+         * @param signalTimes Array of at least [fences] size that receives the signal times
+         */
+        @RequiresApi(Build.VERSION_CODES.O)
+        internal fun getSignalTimes(fences: Array<SyncFenceV19>, signalTimes: LongArray) {
+            // The raw file descriptors are queried with every fence locked, as in
+            // getSignalTimeNanos, so that none of them is closed during the query. The locks are
+            // only tried, so that concurrent calls locking the same fences in a different order
+            // cannot deadlock; the fences are then queried one at a time instead.
+            var locked = 0
+            try {
+                while (locked < fences.size && fences[locked].fenceLock.tryLock()) {
+                    locked++
+                }
+                if (locked == fences.size) {
+                    nGetSignalTimes(IntArray(fences.size) { i -> fences[i].fd }, signalTimes)
+                    return
+                }
+            } finally {
+                for (i in 0 until locked) {
+                    fences[i].fenceLock.unlock()
+                }
+            }
+            for (i in fences.indices) {
+                signalTimes[i] = fences[i].getSignalTimeNanos()
+            }
+        }
+
+        @JvmStatic
+        @JniVisible
+        private external fun nWaitMany(
+            fds: IntArray,
+            waitForAll: Boolean,
+            timeoutMillis: Int,
+            signaled: BooleanArray?
+        ): Int
+
+        @JvmStatic
+        @JniVisible
+        private external fun nMerge(fds: IntArray): Int
+
+        @JvmStatic
+        @JniVisible
+        private external fun nGetSignalTimes(fds: IntArray, signalTimes: LongArray)
     }
 }
@@ -0,0 +1,150 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package androidx.hardware
+
+import android.os.Build
+import androidx.annotation.RequiresApi
+import androidx.graphics.utils.JniVisible
+import java.util.concurrent.ConcurrentHashMap
+import java.util.concurrent.atomic.AtomicLong
+import java.util.concurrent.locks.ReentrantLock
+import kotlin.concurrent.withLock
+
+/**
+ * Notifies callbacks when fences signal, from a single native thread waiting on all the fences at
+ * once with epoll. This avoids parking one thread per fence in [SyncFenceCompat.await], for
+ * instance to recycle buffers once their release fence signals.
+ *
+ * Fences can be watched from any thread. Callbacks are invoked on the watcher thread, they should
+ * return quickly and hand longer work off to another thread. Fences that are still pending when the
+ * watcher is closed never invoke their callback. The watcher thread keeps this object reachable
+ * until [close] is called.
+ */
+@RequiresApi(Build.VERSION_CODES.KITKAT)
+@JniVisible
+internal class SyncFenceWatcher : AutoCloseable {
+
+    private val watcherLock = ReentrantLock()
+    private val callbacks = ConcurrentHashMap<Long, (Long) -> Unit>()
+    private val nextId = AtomicLong()
+    private var watcher: Long = nCreate()
+
+    init {
+        if (watcher == 0L) {
+            throw IllegalStateException("Unable to create fence watcher thread")
+        }
+    }
+
+    /**
+     * Invokes [callback] on the watcher thread with the time at which [fence] signaled, in the
+     * [CLOCK_MONOTONIC] time domain. The time is [SyncFenceCompat.SIGNAL_TIME_INVALID] if the fence
+     * signaled with an error. Invalid fences are treated as fences that have already signaled:
+     * [callback] is invoked immediately on the calling thread with
+     * [SyncFenceCompat.SIGNAL_TIME_INVALID].
+     *
+     * The watcher waits on its own duplicate of the fence's file descriptor, [fence] can be closed
+     * right after this call.
+     *
+     * @throws IllegalArgumentException if [fence] is a platform fence, whose file descriptor is
+     * not accessible to this library
+     * @throws IllegalStateException if the watcher is closed
+     */
+    fun watch(fence: SyncFenceCompat, callback: (signalTimeNanos: Long) -> Unit) {
+        val impl = fence.mImpl as? SyncFenceV19
+            ?: throw IllegalArgumentException("Only compat fences can be watched")
+        val watched = watcherLock.withLock {
+            // Checked before duplicating the file descriptor, which nWatch takes ownership of
+            check(watcher != 0L) { "SyncFenceWatcher is closed" }
+            val fd = impl.dupeFd()
+            if (fd == -1) {
+                return@withLock false
+            }
+
+            // Registered before the fence is handed to the watcher thread, which may dispatch it
+            // before nWatch returns
+            val id = nextId.incrementAndGet()
+            callbacks[id] = callback
+            if (!nWatch(watcher, fd, id)) {
+                callbacks.remove(id)
+                throw IllegalStateException("Unable to watch fence")
+            }
+            true
+        }
+        if (!watched) {
+            callback(SyncFenceCompat.SIGNAL_TIME_INVALID)
+        }
+    }
+
+    /**
+     * Number of fences that have not signaled yet
+     */
+    val pendingCount: Int
+        get() = watcherLock.withLock {
+            if (watcher != 0L) nPendingCount(watcher) else 0
+        }
+
+    /**
+     * Stops the watcher thread.
+     *
+     * @throws IllegalStateException if called from a callback, the watcher thread cannot stop
+     * itself
+     */
+    override fun close() {
+        // The watcher thread is joined outside of the lock, callbacks may be calling watch()
+        val handle = watcherLock.withLock {
+            val current = watcher
+            // Checked before the handle is cleared, which would otherwise leak the native
+            // watcher, its thread and the reference it holds to this object
+            check(current == 0L || !nIsWatcherThread(current)) {
+                "SyncFenceWatcher cannot be closed from a callback"
+            }
+            watcher = 0L
+            current
+        }
+        if (handle != 0L) {
+            nDestroy(handle)
+            callbacks.clear()
+        }
+    }
+
+    @JniVisible
+    private fun onFenceSignaled(id: Long, signalTime: Long) {
+        callbacks.remove(id)?.invoke(signalTime)
+    }
+
+    @JniVisible
+    private external fun nCreate(): Long
+
+    @JniVisible
+    private external fun nDestroy(watcher: Long)
+
+    @JniVisible
+    private external fun nWatch(watcher: Long, fd: Int, id: Long): Boolean
+
+    @JniVisible
+    private external fun nPendingCount(watcher: Long): Int
+
+    @JniVisible
+    private external fun nIsWatcherThread(watcher: Long): Boolean
+
+    companion object {
+
+        init {
+            System.loadLibrary("graphics-core")
+        }
+    }
+}
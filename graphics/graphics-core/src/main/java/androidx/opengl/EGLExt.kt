@@ -695,6 +695,34 @@ internal class EGLBindings {
         @JniVisible
         external fun nDestroyImageKHR(eglDisplayPtr: Long, eglImagePtr: Long): Boolean
 
+        @JvmStatic
+        @JniVisible
+        external fun nCreateImageCache(eglDisplayPtr: Long, capacity: Int): Long
+
+        @JvmStatic
+        @JniVisible
+        external fun nDestroyImageCache(cachePtr: Long)
+
+        @JvmStatic
+        @JniVisible
+        external fun nImageCacheGetTexture(cachePtr: Long, hardwareBuffer: HardwareBuffer): Int
+
+        @JvmStatic
+        @JniVisible
+        external fun nImageCacheEvict(cachePtr: Long, hardwareBuffer: HardwareBuffer): Boolean
+
+        @JvmStatic
+        @JniVisible
+        external fun nImageCacheClear(cachePtr: Long)
+
+        @JvmStatic
+        @JniVisible
+        external fun nImageCacheSize(cachePtr: Long): Int
+
+        @JvmStatic
+        @JniVisible
+        external fun nImageCacheCreatedCount(cachePtr: Long): Long
+
         @JvmStatic
         @JniVisible
         external fun nSupportsEglGetNativeClientBufferAndroid(): Boolean
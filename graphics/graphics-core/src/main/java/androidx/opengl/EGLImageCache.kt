@@ -0,0 +1,132 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package androidx.opengl
+
+import android.hardware.HardwareBuffer
+import android.opengl.EGLDisplay
+import android.os.Build
+import androidx.annotation.RequiresApi
+import androidx.opengl.EGLExt.Companion.obtainNativeHandle
+
+/**
+ * Caches the [EGLImageKHR] and the GL texture bound to it for each [HardwareBuffer]. This is for
+ * code that receives the same few buffers repeatedly without keeping a wrapper per buffer, such
+ * as a consumer sampling the buffers of another producer: it creates no EGLImage in steady state,
+ * instead of one per frame with [EGLExt.eglCreateImageFromHardwareBuffer].
+ *
+ * [androidx.graphics.opengl.FrameBufferPool] does not need it: each pooled
+ * [androidx.graphics.opengl.FrameBuffer] creates its EGLImage once and keeps it for the lifetime
+ * of its buffer. The library does not use this cache yet.
+ *
+ * The cache holds a reference to each cached buffer until it is evicted, either explicitly with
+ * [evict], or as the least recently used entry once more than [capacity] buffers are cached.
+ * Buffers that are retired should be evicted to release their memory.
+ *
+ * This class is not thread safe. All methods, including [close], must be called on the thread
+ * where the EGL context owning the textures is current.
+ *
+ * @param eglDisplay EGLDisplay connection the EGLImages are created on
+ * @param capacity Maximum number of buffers cached at once
+ */
+@RequiresApi(Build.VERSION_CODES.O)
+internal class EGLImageCache(
+    eglDisplay: EGLDisplay,
+    val capacity: Int = DEFAULT_CAPACITY
+) : AutoCloseable {
+
+    private var cache: Long
+
+    init {
+        require(capacity > 0) { "capacity must be positive" }
+        cache = EGLBindings.nCreateImageCache(eglDisplay.obtainNativeHandle(), capacity)
+        if (cache == 0L) {
+            throw UnsupportedOperationException(
+                "EGL_ANDROID_image_native_buffer and EGL_KHR_image_base are required"
+            )
+        }
+    }
+
+    /**
+     * Returns the GL_TEXTURE_2D texture backed by [hardwareBuffer], creating its EGLImage on first
+     * use. Returns 0 if the EGLImage cannot be created.
+     */
+    fun getTexture(hardwareBuffer: HardwareBuffer): Int {
+        checkOpen()
+        return EGLBindings.nImageCacheGetTexture(cache, hardwareBuffer)
+    }
+
+    /**
+     * Destroys the EGLImage and texture of [hardwareBuffer] and releases the cache's reference to
+     * it.
+     *
+     * @return `true` if the buffer was cached, `false` otherwise
+     */
+    fun evict(hardwareBuffer: HardwareBuffer): Boolean {
+        checkOpen()
+        return EGLBindings.nImageCacheEvict(cache, hardwareBuffer)
+    }
+
+    /**
+     * Evicts all the cached buffers
+     */
+    fun clear() {
+        checkOpen()
+        EGLBindings.nImageCacheClear(cache)
+    }
+
+    /**
+     * Number of buffers currently cached
+     */
+    val size: Int
+        get() {
+            checkOpen()
+            return EGLBindings.nImageCacheSize(cache)
+        }
+
+    /**
+     * Number of EGLImages created since the cache was created
+     */
+    val createdImageCount: Long
+        get() {
+            checkOpen()
+            return EGLBindings.nImageCacheCreatedCount(cache)
+        }
+
+    val isClosed: Boolean
+        get() = cache == 0L
+
+    /**
+     * Evicts all the cached buffers and releases the cache
+     */
+    override fun close() {
+        if (cache != 0L) {
+            EGLBindings.nDestroyImageCache(cache)
+            cache = 0L
+        }
+    }
+
+    private fun checkOpen() {
+        check(cache != 0L) { "EGLImageCache is closed" }
+    }
+
+    internal companion object {
+        /**
+         * Triple buffering cycles through 3 buffers
+         */
+        const val DEFAULT_CAPACITY = 3
+    }
+}
@@ -0,0 +1,154 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package androidx.graphics.path
+
+import android.graphics.Path
+import android.graphics.RectF
+import androidx.test.ext.junit.runners.AndroidJUnit4
+import androidx.test.filters.SmallTest
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertNotEquals
+import org.junit.Assert.assertSame
+import org.junit.Assert.assertTrue
+import org.junit.Test
+import org.junit.runner.RunWith
+
+@SmallTest
+@RunWith(AndroidJUnit4::class)
+class PathCacheTest {
+    private fun shape(offset: Float = 0.0f) = Path().apply {
+        moveTo(offset, 0.0f)
+        lineTo(100.0f, 0.0f)
+        cubicTo(150.0f, 0.0f, 150.0f, 100.0f, 100.0f, 100.0f)
+        close()
+        addCircle(50.0f, 50.0f, 25.0f, Path.Direction.CW)
+    }
+
+    @Test
+    fun contentHash() {
+        val cache = PathCache()
+        assertEquals(cache.contentHash(shape()), cache.contentHash(shape()))
+        assertNotEquals(cache.contentHash(shape()), cache.contentHash(shape(1.0f)))
+        assertNotEquals(cache.contentHash(Path()), cache.contentHash(shape()))
+    }
+
+    @Test
+    fun identicalPathsShareEntries() {
+        val cache = PathCache()
+        cache.getPolylines(shape())
+        val size = cache.size
+        assertTrue(size > 0)
+
+        // A new path object with the same content does not grow the cache
+        cache.getPolylines(shape())
+        assertEquals(size, cache.size)
+
+        cache.getPolylines(shape(1.0f))
+        assertTrue(cache.size > size)
+
+        cache.clear()
+        assertEquals(0, cache.size)
+    }
+
+    @Test
+    fun bounds() {
+        val cache = PathCache()
+        val bounds = RectF()
+        cache.getBounds(shape(), bounds)
+        // The cubic's control points extend to 150, the curve itself to 137.5
+        assertEquals(0.0f, bounds.left, 1e-3f)
+        assertEquals(137.5f, bounds.right, 1e-3f)
+        assertEquals(100.0f, bounds.bottom, 1e-3f)
+
+        cache.getBounds(Path(), bounds)
+        assertTrue(bounds.isEmpty)
+    }
+
+    @Test
+    fun quadratics() {
+        val cache = PathCache()
+        val path = shape()
+        val quadratics = cache.getQuadratics(path)
+
+        val iterator = path.iterator(PathIterator.ConicEvaluation.AsQuadratics)
+        var index = 0
+        for (segment in iterator) {
+            if (segment.type == PathSegment.Type.Done) break
+            assertEquals(segment.type.ordinal, quadratics.types[index].toInt())
+            assertTrue(segment.type != PathSegment.Type.Conic)
+            index++
+        }
+        assertEquals(index, quadratics.count)
+        assertEquals(0.0f, quadratics.points[0])
+    }
+
+    @Test
+    fun polylines() {
+        val cache = PathCache()
+        // Without conics, so that both sides convert the exact same segments
+        val path = Path().apply {
+            moveTo(0.0f, 0.0f)
+            lineTo(100.0f, 0.0f)
+            cubicTo(150.0f, 0.0f, 150.0f, 100.0f, 100.0f, 100.0f)
+            quadTo(50.0f, 150.0f, 0.0f, 100.0f)
+            close()
+        }
+        val polylines = cache.getPolylines(path)
+        val flattener = path.flatten()
+
+        assertEquals(flattener.pointCount, polylines.pointCount)
+        assertEquals(flattener.contourCount, polylines.contourCount)
+        for (i in 0 until polylines.contourCount) {
+            assertEquals(flattener.contourEnds[i], polylines.contourEnds[i])
+        }
+        for (i in 0 until polylines.pointCount * 2) {
+            assertEquals(flattener.points[i], polylines.points[i])
+        }
+    }
+
+    @Test
+    fun resultsOutliveTheCache() {
+        val cache = PathCache()
+        val quadratics = cache.getQuadratics(shape())
+        val polylines = cache.getPolylines(shape())
+        val count = quadratics.count
+        val types = quadratics.types.copyOf(count)
+        val points = polylines.points.copyOf(polylines.pointCount * 2)
+
+        // Results are owned copies: clearing the cache or converting other paths leaves
+        // them untouched
+        cache.clear()
+        cache.getPolylines(shape(1.0f))
+        assertEquals(count, quadratics.count)
+        assertTrue(types.contentEquals(quadratics.types.copyOf(count)))
+        assertTrue(points.contentEquals(polylines.points.copyOf(polylines.pointCount * 2)))
+
+        // Passing a result back reuses its arrays
+        val storage = polylines.points
+        assertSame(polylines, cache.getPolylines(shape(), result = polylines))
+        assertSame(storage, polylines.points)
+    }
+
+    @Test
+    fun eviction() {
+        val cache = PathCache(4096)
+        for (i in 0 until 64) {
+            cache.getPolylines(shape(i.toFloat()))
+        }
+        assertTrue(cache.size <= 4096)
+    }
+}
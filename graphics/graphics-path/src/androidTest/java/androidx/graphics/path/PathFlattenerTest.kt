@@ -0,0 +1,78 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package androidx.graphics.path
+
+import android.graphics.Path
+import androidx.test.ext.junit.runners.AndroidJUnit4
+import androidx.test.filters.SmallTest
+import kotlin.math.hypot
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertTrue
+import org.junit.Test
+import org.junit.runner.RunWith
+
+@SmallTest
+@RunWith(AndroidJUnit4::class)
+class PathFlattenerTest {
+    @Test
+    fun emptyPath() {
+        val flattener = Path().flatten()
+        assertEquals(0, flattener.pointCount)
+        assertEquals(0, flattener.contourCount)
+    }
+
+    @Test
+    fun lines() {
+        val path = Path().apply {
+            moveTo(1.0f, 1.0f)
+            lineTo(2.0f, 2.0f)
+            lineTo(3.0f, 1.0f)
+            close()
+            moveTo(10.0f, 10.0f)
+            lineTo(20.0f, 10.0f)
+        }
+
+        val flattener = path.flatten()
+        assertEquals(2, flattener.contourCount)
+        // The closed contour ends with its first point
+        assertEquals(4, flattener.contourEnds[0])
+        assertEquals(6, flattener.contourEnds[1])
+        assertEquals(6, flattener.pointCount)
+        assertEquals(1.0f, flattener.points[6])
+        assertEquals(1.0f, flattener.points[7])
+        assertEquals(20.0f, flattener.points[10])
+    }
+
+    @Test
+    fun circleWithinTolerance() {
+        val path = Path().apply { addCircle(0.0f, 0.0f, 100.0f, Path.Direction.CW) }
+
+        for (tolerance in floatArrayOf(1.0f, 0.25f, 0.05f)) {
+            // Start with storage that is too small to exercise the resize path
+            val flattener = PathFlattener(tolerance).flatten(path)
+            assertEquals(1, flattener.contourCount)
+
+            val points = flattener.points
+            for (i in 0 until flattener.pointCount - 1) {
+                val x = (points[i * 2] + points[i * 2 + 2]) * 0.5f
+                val y = (points[i * 2 + 1] + points[i * 2 + 3]) * 0.5f
+                // Account for the error of the conic to quadratic conversion, if any
+                assertTrue(100.0f - hypot(x, y) <= tolerance * 2.0f)
+            }
+        }
+    }
+}
@@ -263,6 +263,54 @@ class PathIteratorTest {
         }
     }
 
+    @Test
+    fun batchedNext() {
+        val path = Path().apply {
+            moveTo(1.0f, 1.0f)
+            lineTo(2.0f, 2.0f)
+            cubicTo(3.0f, 3.0f, 4.0f, 4.0f, 5.0f, 5.0f)
+            addRoundRect(RectF(12.0f, 12.0f, 36.0f, 36.0f), 8.0f, 8.0f, Path.Direction.CW)
+            close()
+        }
+
+        batchedNextImpl(path, PathIterator.ConicEvaluation.AsConic)
+        batchedNextImpl(path, PathIterator.ConicEvaluation.AsQuadratics)
+    }
+
+    private fun batchedNextImpl(path: Path, conicEvaluation: PathIterator.ConicEvaluation) {
+        val iterator = path.iterator(conicEvaluation)
+        val batchIterator = path.iterator(conicEvaluation)
+
+        val points = FloatArray(8)
+        // Use a batch size that does not divide the segment count to exercise partial batches
+        val types = Array(3) { PathSegment.Type.Done }
+        val batchPoints = FloatArray(2 + types.size * 8)
+
+        var segments = 0
+        while (true) {
+            val count = batchIterator.next(types, batchPoints, 2)
+            for (i in 0 until count) {
+                val type = iterator.next(points)
+                assertEquals(type, types[i])
+                val pointCount = when (type) {
+                    PathSegment.Type.Move -> 2
+                    PathSegment.Type.Line -> 4
+                    PathSegment.Type.Quadratic, PathSegment.Type.Conic -> 6
+                    PathSegment.Type.Cubic -> 8
+                    else -> 0
+                }
+                for (j in 0 until pointCount) {
+                    assertEquals(points[j], batchPoints[2 + i * 8 + j], 1e-6f)
+                }
+            }
+            segments += count
+            if (count < types.size) break
+        }
+
+        assertEquals(PathSegment.Type.Done, iterator.next(points))
+        assertEquals(path.iterator(conicEvaluation).calculateSize(), segments)
+    }
+
     @Test
     fun done() {
         val path = Path().apply {
@@ -407,6 +455,40 @@ class PathIteratorTest {
         }
     }
 
+    @Test
+    fun conicAsQuadraticsAtEndOfPath() {
+        // Path.addArc() ends the path with a conic, whose quadratics are still pending once
+        // all the verbs of the path have been read
+        val path = Path().apply {
+            addArc(RectF(0.0f, 0.0f, 100.0f, 100.0f), 0.0f, 90.0f)
+        }
+
+        val iterator = path.iterator(PathIterator.ConicEvaluation.AsQuadratics)
+        val size = iterator.calculateSize()
+
+        val types = mutableListOf<PathSegment.Type>()
+        var last: PathSegment? = null
+        while (iterator.hasNext()) {
+            val type = iterator.peek()
+            val segment = iterator.next()
+            assertEquals(type, segment.type)
+            types.add(segment.type)
+            last = segment
+        }
+        assertEquals(PathSegment.Type.Done, iterator.peek())
+        assertEquals(PathSegment.Type.Done, iterator.next().type)
+
+        assertEquals(size, types.size)
+        assertEquals(PathSegment.Type.Move, types.first())
+        assertTrue(types.size > 1)
+        for (type in types.drop(1)) assertEquals(PathSegment.Type.Quadratic, type)
+
+        // The last quadratic ends where the arc does
+        val end = last!!.points[2]
+        assertEquals(50.0f, end.x, 1e-3f)
+        assertEquals(100.0f, end.y, 1e-3f)
+    }
+
     @Test
     fun convertedConics() {
         val path1 = Path().apply {
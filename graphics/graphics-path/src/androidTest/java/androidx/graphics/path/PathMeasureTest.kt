@@ -0,0 +1,115 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package androidx.graphics.path
+
+import android.graphics.Path
+import android.graphics.RectF
+import androidx.test.ext.junit.runners.AndroidJUnit4
+import androidx.test.filters.SmallTest
+import kotlin.math.PI
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertFalse
+import org.junit.Assert.assertTrue
+import org.junit.Test
+import org.junit.runner.RunWith
+
+@SmallTest
+@RunWith(AndroidJUnit4::class)
+class PathMeasureTest {
+    @Test
+    fun emptyPath() {
+        val measure = Path().measure()
+        assertEquals(0, measure.contourCount)
+
+        val bounds = RectF(1.0f, 1.0f, 2.0f, 2.0f)
+        measure.getBounds(bounds)
+        assertTrue(bounds.isEmpty)
+    }
+
+    @Test(expected = IndexOutOfBoundsException::class)
+    fun invalidContour() {
+        Path().measure().getLength(0)
+    }
+
+    @Test
+    fun contours() {
+        val path = Path().apply {
+            moveTo(0.0f, 0.0f)
+            lineTo(100.0f, 0.0f)
+            lineTo(100.0f, 100.0f)
+            close()
+            moveTo(200.0f, 0.0f)
+            lineTo(200.0f, 50.0f)
+        }
+
+        val measure = path.measure()
+        assertEquals(2, measure.contourCount)
+        assertEquals(200.0f + 100.0f * 1.4142135f, measure.getLength(0), 1e-3f)
+        assertEquals(50.0f, measure.getLength(1), 1e-3f)
+        assertTrue(measure.isClosed(0))
+        assertFalse(measure.isClosed(1))
+
+        val bounds = RectF()
+        measure.getBounds(bounds)
+        assertEquals(RectF(0.0f, 0.0f, 200.0f, 100.0f), bounds)
+
+        val result = FloatArray(5)
+        assertTrue(measure.getPositionAndTangent(1, 25.0f, result, 1))
+        assertEquals(200.0f, result[1], 1e-3f)
+        assertEquals(25.0f, result[2], 1e-3f)
+        assertEquals(0.0f, result[3], 1e-3f)
+        assertEquals(1.0f, result[4], 1e-3f)
+    }
+
+    @Test
+    fun circle() {
+        val path = Path().apply { addCircle(0.0f, 0.0f, 100.0f, Path.Direction.CW) }
+        val measure = path.measure()
+
+        assertEquals(1, measure.contourCount)
+        assertEquals((2.0 * PI * 100.0).toFloat(), measure.getLength(0), 0.5f)
+
+        val bounds = RectF()
+        measure.getBounds(bounds)
+        assertEquals(-100.0f, bounds.left, 1e-3f)
+        assertEquals(100.0f, bounds.bottom, 1e-3f)
+    }
+
+    @Test
+    fun segment() {
+        val path = Path().apply {
+            moveTo(0.0f, 0.0f)
+            lineTo(100.0f, 0.0f)
+            lineTo(100.0f, 100.0f)
+        }
+        val measure = path.measure()
+
+        // Too small, the required size is returned and nothing is written
+        val small = FloatArray(2)
+        assertEquals(3, measure.getSegment(0, 50.0f, 150.0f, small))
+        assertEquals(0.0f, small[0])
+
+        val points = FloatArray(6)
+        assertEquals(3, measure.getSegment(0, 50.0f, 150.0f, points))
+        assertEquals(
+            listOf(50.0f, 0.0f, 100.0f, 0.0f, 100.0f, 50.0f),
+            points.toList()
+        )
+
+        assertEquals(0, measure.getSegment(0, 150.0f, 50.0f, points))
+    }
+}
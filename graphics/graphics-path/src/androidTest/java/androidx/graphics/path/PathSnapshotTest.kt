@@ -0,0 +1,86 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package androidx.graphics.path
+
+import android.graphics.Path
+import android.graphics.RectF
+import androidx.test.ext.junit.runners.AndroidJUnit4
+import androidx.test.filters.SmallTest
+import org.junit.Assert.assertEquals
+import org.junit.Test
+import org.junit.runner.RunWith
+
+@SmallTest
+@RunWith(AndroidJUnit4::class)
+class PathSnapshotTest {
+    @Test
+    fun emptySnapshot() {
+        val snapshot = Path().snapshot()
+        assertEquals(0, snapshot.verbCount)
+        assertEquals(0, snapshot.verbs.remaining())
+        assertEquals(0, snapshot.points.remaining())
+        assertEquals(0, snapshot.conicWeights.remaining())
+    }
+
+    @Test
+    fun snapshotMatchesIterator() {
+        val path = Path().apply {
+            moveTo(1.0f, 1.0f)
+            lineTo(2.0f, 2.0f)
+            cubicTo(3.0f, 3.0f, 4.0f, 4.0f, 5.0f, 5.0f)
+            quadTo(7.0f, 7.0f, 8.0f, 8.0f)
+            // addRoundRect() will generate conic curves on certain API levels
+            addRoundRect(RectF(12.0f, 12.0f, 36.0f, 36.0f), 8.0f, 8.0f, Path.Direction.CW)
+        }
+
+        val snapshot = PathSnapshot()
+        // Capture twice to check that storage reuse does not leak previous data
+        snapshot.capture(Path().apply { addCircle(4.0f, 4.0f, 2.0f, Path.Direction.CW) })
+        snapshot.capture(path)
+
+        val iterator = path.iterator(PathIterator.ConicEvaluation.AsConic)
+        val points = FloatArray(8)
+        var point = 0
+        var weight = 0
+
+        assertEquals(iterator.calculateSize(false), snapshot.verbCount)
+        for (i in 0 until snapshot.verbCount) {
+            val type = iterator.next(points)
+            assertEquals(type.ordinal, snapshot.verbs.get(i).toInt())
+
+            val start = if (type == PathSegment.Type.Move) 0 else 1
+            val end = when (type) {
+                PathSegment.Type.Move -> 1
+                PathSegment.Type.Line -> 2
+                PathSegment.Type.Quadratic, PathSegment.Type.Conic -> 3
+                PathSegment.Type.Cubic -> 4
+                else -> start
+            }
+            for (j in start until end) {
+                assertEquals(points[j * 2], snapshot.points.get(point * 2), 1e-6f)
+                assertEquals(points[j * 2 + 1], snapshot.points.get(point * 2 + 1), 1e-6f)
+                point++
+            }
+            if (type == PathSegment.Type.Conic) {
+                assertEquals(points[6], snapshot.conicWeights.get(weight++), 1e-6f)
+            }
+        }
+
+        assertEquals(point * 2, snapshot.points.remaining())
+        assertEquals(weight, snapshot.conicWeights.remaining())
+    }
+}
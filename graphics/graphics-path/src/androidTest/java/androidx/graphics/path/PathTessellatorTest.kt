@@ -0,0 +1,119 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package androidx.graphics.path
+
+import android.graphics.Paint
+import android.graphics.Path
+import android.opengl.GLES20
+import androidx.test.ext.junit.runners.AndroidJUnit4
+import androidx.test.filters.SmallTest
+import kotlin.math.PI
+import kotlin.math.abs
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertTrue
+import org.junit.Test
+import org.junit.runner.RunWith
+
+@SmallTest
+@RunWith(AndroidJUnit4::class)
+class PathTessellatorTest {
+    // Sum of the areas of all the triangles, overlapping triangles are counted twice
+    private fun PathTessellator.triangleArea(): Float {
+        assertEquals(GLES20.GL_UNSIGNED_SHORT, indexType)
+        val indices = indices.asShortBuffer()
+        var area = 0.0f
+        for (i in 0 until indexCount step 3) {
+            val a = indices.get(i).toInt() and 0xffff
+            val b = indices.get(i + 1).toInt() and 0xffff
+            val c = indices.get(i + 2).toInt() and 0xffff
+            val ax = vertices.get(a * 2)
+            val ay = vertices.get(a * 2 + 1)
+            val bx = vertices.get(b * 2) - ax
+            val by = vertices.get(b * 2 + 1) - ay
+            val cx = vertices.get(c * 2) - ax
+            val cy = vertices.get(c * 2 + 1) - ay
+            area += abs(bx * cy - cx * by) * 0.5f
+        }
+        return area
+    }
+
+    @Test
+    fun emptyPath() {
+        val tessellator = PathTessellator().fill(Path())
+        assertEquals(0, tessellator.vertexCount)
+        assertEquals(0, tessellator.indexCount)
+    }
+
+    @Test
+    fun fillRectangle() {
+        val path = Path().apply { addRect(0.0f, 0.0f, 100.0f, 50.0f, Path.Direction.CW) }
+        val tessellator = PathTessellator().fill(path)
+
+        assertEquals(4, tessellator.vertexCount)
+        assertEquals(6, tessellator.indexCount)
+        assertEquals(5000.0f, tessellator.triangleArea(), 1e-2f)
+    }
+
+    @Test
+    fun fillCircle() {
+        val path = Path().apply { addCircle(0.0f, 0.0f, 100.0f, Path.Direction.CW) }
+        val tessellator = PathTessellator().fill(path)
+
+        assertEquals((PI * 100.0 * 100.0).toFloat(), tessellator.triangleArea(), 200.0f)
+    }
+
+    @Test
+    fun strokeLine() {
+        val path = Path().apply {
+            moveTo(0.0f, 0.0f)
+            lineTo(100.0f, 0.0f)
+        }
+        val tessellator = PathTessellator()
+
+        tessellator.stroke(path, 10.0f)
+        assertEquals(1000.0f, tessellator.triangleArea(), 1e-2f)
+
+        tessellator.stroke(path, 10.0f, Paint.Cap.SQUARE)
+        assertEquals(1100.0f, tessellator.triangleArea(), 1e-2f)
+
+        tessellator.stroke(path, 10.0f, Paint.Cap.ROUND)
+        assertEquals((1000.0 + PI * 25.0).toFloat(), tessellator.triangleArea(), 10.0f)
+
+        tessellator.stroke(path, 0.0f)
+        assertEquals(0, tessellator.indexCount)
+    }
+
+    @Test
+    fun strokeJoins() {
+        val path = Path().apply { addRect(0.0f, 0.0f, 100.0f, 100.0f, Path.Direction.CW) }
+        val tessellator = PathTessellator()
+
+        // 4 quads plus 4 corners
+        tessellator.stroke(path, 10.0f, Paint.Cap.BUTT, Paint.Join.MITER)
+        assertEquals(4100.0f, tessellator.triangleArea(), 1e-1f)
+
+        tessellator.stroke(path, 10.0f, Paint.Cap.BUTT, Paint.Join.BEVEL)
+        assertEquals(4050.0f, tessellator.triangleArea(), 1e-1f)
+
+        // Right angles exceed a miter limit of 1
+        tessellator.stroke(path, 10.0f, Paint.Cap.BUTT, Paint.Join.MITER, 1.0f)
+        assertEquals(4050.0f, tessellator.triangleArea(), 1e-1f)
+
+        tessellator.stroke(path, 10.0f, Paint.Cap.BUTT, Paint.Join.ROUND)
+        assertTrue(tessellator.triangleArea() in 4050.0f..4100.0f)
+    }
+}
@@ -17,17 +17,23 @@
 
 #include "Conic.h"
 
+#include "Geometry.h"
 #include "scalar.h"
 
+#include "math/compiler.h"
 #include "math/vec2.h"
 
 #include <cmath>
 #include <cstring>
+#include <utility>
 
 using namespace filament::math;
 
 constexpr int kMaxConicToQuadCount = 5;
 
+// Number of conics stored in a ConicBatch
+constexpr int kBatchCapacity = 128;
+
 constexpr bool isFinite(const Point points[], int count) noexcept {
     return isFinite(&points[0].x, count << 1);
 }
@@ -39,14 +45,6 @@ constexpr bool isFinite(const Point& point) noexcept {
     return a == 0.0f;
 }
 
-constexpr Point toPoint(const float2& v) noexcept {
-    return { .x = v.x, .y = v.y };
-}
-
-constexpr float2 fromPoint(const Point& v) noexcept {
-    return float2{v.x, v.y};
-}
-
 int conicToQuadratics(
     const Point conicPoints[3], Point *quadraticPoints, int bufferSize,
     float weight, float tolerance
@@ -68,8 +66,14 @@ const Point* ConicConverter::toQuadratics(
         const Point points[3], float weight, float tolerance
 ) noexcept {
     Conic conic(points[0], points[1], points[2], weight);
+    return splitIntoQuadratics(points, weight, conic.computeQuadraticCount(tolerance));
+}
+
+const Point* ConicConverter::splitIntoQuadratics(
+        const Point points[3], float weight, int count
+) noexcept {
+    Conic conic(points[0], points[1], points[2], weight);
 
-    int count = conic.computeQuadraticCount(tolerance);
     mQuadraticCount = 1 << count;
 
     int newSize = 1 + 2 * mQuadraticCount;
@@ -91,7 +95,7 @@ int Conic::computeQuadraticCount(float tolerance) const noexcept {
     float x = k * (points[0].x - 2.0f * points[1].x + points[2].x);
     float y = k * (points[0].y - 2.0f * points[1].y + points[2].y);
 
-    float error = std::sqrtf(x * x + y * y);
+    float error = std::sqrt(x * x + y * y);
     int count = 0;
     for ( ; count < kMaxConicToQuadCount; count++) {
         if (error <= tolerance) break;
@@ -101,6 +105,37 @@ int Conic::computeQuadraticCount(float tolerance) const noexcept {
     return count;
 }
 
+// Replaces all the points but the extremities of the 2^count quadratics stored in dstPoints
+// with controlPoint if any of them is not finite. Returns the number of quadratics.
+static int ensureFinite(Point dstPoints[], int count, const Point& controlPoint) noexcept {
+    const int quadCount = 1 << count;
+    const int pointCount = 2 * quadCount + 1;
+
+    if (!isFinite(dstPoints, pointCount)) {
+        for (int i = 1; i < pointCount - 1; ++i) {
+            dstPoints[i] = controlPoint;
+        }
+    }
+
+    return quadCount;
+}
+
+// Returns the number of quadratics splitIntoQuadratics() produces for the given count,
+// without subdividing the conic
+int Conic::resolveQuadraticCount(int count) const noexcept {
+    if (count >= kMaxConicToQuadCount) {
+        Conic dst[2];
+        split(dst);
+
+        // Degenerate conics are replaced by 2 quadratics, see splitIntoQuadratics()
+        if (equals(dst[0].points[1], dst[0].points[2]) &&
+            equals(dst[1].points[0], dst[1].points[1])) {
+            return 2;
+        }
+    }
+    return 1 << count;
+}
+
 static Point* subdivide(const Conic& src, Point pts[], int level) {
     if (level == 0) {
         memcpy(pts, &src.points[1], 2 * sizeof(Point));
@@ -131,7 +166,7 @@ static Point* subdivide(const Conic& src, Point pts[], int level) {
 
 void Conic::split(Conic* __restrict__ dst) const noexcept {
     float2 scale{1.0f / (1.0f + weight)};
-    float newW = std::sqrtf(0.5f + weight * 0.5f);
+    float newW = std::sqrt(0.5f + weight * 0.5f);
 
     float2 p0 = fromPoint(points[0]);
     float2 p1 = fromPoint(points[1]);
@@ -176,14 +211,201 @@ int Conic::splitIntoQuadratics(Point dstPoints[], int count) const noexcept {
     subdivide(*this, dstPoints + 1, count);
 
     commonFinitePointCheck:
-    const int quadCount = 1 << count;
-    const int pointCount = 2 * quadCount + 1;
+    return ensureFinite(dstPoints, count, points[1]);
+}
 
-    if (!isFinite(dstPoints, pointCount)) {
-        for (int i = 1; i < pointCount - 1; ++i) {
-            dstPoints[i] = points[1];
+// Structure-of-arrays storage for the conics of one level of a batched subdivision
+struct ConicBatch {
+    float x0[kBatchCapacity];
+    float y0[kBatchCapacity];
+    float x1[kBatchCapacity];
+    float y1[kBatchCapacity];
+    float x2[kBatchCapacity];
+    float y2[kBatchCapacity];
+    float w[kBatchCapacity];
+};
+
+// Performs Conic::split() and the adjustments of subdivide() on the count conics of src.
+// The first halves are stored in dst[0, count) and the second halves in dst[count, 2 * count)
+// so that both loops below only perform contiguous loads and stores and can be vectorized.
+static void splitBatch(
+        const ConicBatch& __restrict__ src, ConicBatch& __restrict__ dst, int count
+) noexcept {
+    int nonFinite = 0;
+    for (int i = 0; i < count; i++) {
+        const float w = src.w[i];
+        const float scale = 1.0f / (1.0f + w);
+        const float wx1 = w * src.x1[i];
+        const float wy1 = w * src.y1[i];
+        const float mx = (src.x0[i] + (wx1 + wx1) + src.x2[i]) * scale * 0.5f;
+        const float my = (src.y0[i] + (wy1 + wy1) + src.y2[i]) * scale * 0.5f;
+        dst.x2[i] = mx;
+        dst.y2[i] = my;
+        nonFinite |= !isFinite(mx) | !isFinite(my);
+    }
+
+    if (MATH_UNLIKELY(nonFinite)) {
+        for (int i = 0; i < count; i++) {
+            if (isFinite(dst.x2[i]) && isFinite(dst.y2[i])) continue;
+            double w_2 = double(src.w[i]) * 2.0;
+            double scale_half = 1.0 / (1.0 + double(src.w[i])) * 0.5;
+            dst.x2[i] = float((src.x0[i] + w_2 * src.x1[i] + src.x2[i]) * scale_half);
+            dst.y2[i] = float((src.y0[i] + w_2 * src.y1[i] + src.y2[i]) * scale_half);
         }
     }
 
-    return quadCount;
+    for (int i = 0; i < count; i++) {
+        const float w = src.w[i];
+        const float scale = 1.0f / (1.0f + w);
+        const float x0 = src.x0[i];
+        const float y0 = src.y0[i];
+        const float wx1 = w * src.x1[i];
+        const float wy1 = w * src.y1[i];
+        const float x2 = src.x2[i];
+        const float y2 = src.y2[i];
+
+        float my = dst.y2[i];
+        float c0y = (y0 + wy1) * scale;
+        float c1y = (wy1 + y2) * scale;
+
+        const bool monotonic = between(y0, src.y1[i], y2);
+        const float closerY = tabs(my - y0) < tabs(my - y2) ? y0 : y2;
+        my = monotonic && !between(y0, my, y2) ? closerY : my;
+        c0y = monotonic && !between(y0, c0y, my) ? y0 : c0y;
+        c1y = monotonic && !between(my, c1y, y2) ? y2 : c1y;
+
+        const float mx = dst.x2[i];
+        const float newW = std::sqrt(0.5f + w * 0.5f);
+
+        dst.x0[i] = x0;
+        dst.y0[i] = y0;
+        dst.x1[i] = (x0 + wx1) * scale;
+        dst.y1[i] = c0y;
+        dst.y2[i] = my;
+        dst.w[i] = newW;
+
+        const int j = i + count;
+        dst.x0[j] = mx;
+        dst.y0[j] = my;
+        dst.x1[j] = (wx1 + x2) * scale;
+        dst.y1[j] = c1y;
+        dst.x2[j] = x2;
+        dst.y2[j] = y2;
+        dst.w[j] = newW;
+    }
+}
+
+constexpr int reverseBits(int value, int bitCount) noexcept {
+    int result = 0;
+    for (int i = 0; i < bitCount; i++) {
+        result = (result << 1) | ((value >> i) & 1);
+    }
+    return result;
+}
+
+// Conics waiting to be converted together, they all share the same subdivision level
+struct PendingConics {
+    int count = 0;
+    int indices[kBatchCapacity / 2];
+    Point* outputs[kBatchCapacity / 2];
+};
+
+// Subdivides all the pending conics level by level, breadth-first, instead of recursively
+// one conic at a time as subdivide() does
+static void convertPending(
+        const Point conicPoints[], const float weights[], PendingConics& pending, int level
+) noexcept {
+    const int count = pending.count;
+    if (count == 0) return;
+
+    ConicBatch batches[2];
+    ConicBatch* src = &batches[0];
+    ConicBatch* dst = &batches[1];
+
+    for (int i = 0; i < count; i++) {
+        const Point* points = conicPoints + pending.indices[i] * 3;
+        src->x0[i] = points[0].x;
+        src->y0[i] = points[0].y;
+        src->x1[i] = points[1].x;
+        src->y1[i] = points[1].y;
+        src->x2[i] = points[2].x;
+        src->y2[i] = points[2].y;
+        src->w[i] = weights[pending.indices[i]];
+    }
+
+    for (int i = 0; i < level; i++) {
+        splitBatch(*src, *dst, count << i);
+        std::swap(src, dst);
+    }
+
+    // splitBatch() stores all the first halves before the second halves; after n levels the
+    // quadratic q of conic i, in the order subdivide() would produce, is therefore stored at
+    // index i + count * reverseBits(q, n)
+    const int quadCount = 1 << level;
+    int offsets[1 << kMaxConicToQuadCount];
+    for (int q = 0; q < quadCount; q++) {
+        offsets[q] = count * reverseBits(q, level);
+    }
+
+    for (int i = 0; i < count; i++) {
+        const Point* points = conicPoints + pending.indices[i] * 3;
+        Point* out = pending.outputs[i];
+        out[0] = points[0];
+        for (int q = 0; q < quadCount; q++) {
+            const int index = i + offsets[q];
+            out[q * 2 + 1] = { .x = src->x1[index], .y = src->y1[index] };
+            out[q * 2 + 2] = { .x = src->x2[index], .y = src->y2[index] };
+        }
+        ensureFinite(out, level, points[1]);
+    }
+
+    pending.count = 0;
+}
+
+int conicToQuadratics(
+        const Point conicPoints[], const float weights[], int conicCount,
+        Point* quadraticPoints, int quadraticCounts[], int bufferSize, float tolerance
+) noexcept {
+    // Subdivision levels are temporarily stored in quadraticCounts
+    int pointCount = 0;
+    for (int i = 0; i < conicCount; i++) {
+        const Point* points = conicPoints + i * 3;
+        Conic conic(points[0], points[1], points[2], weights[i]);
+        quadraticCounts[i] = conic.computeQuadraticCount(tolerance);
+        pointCount += 1 + (2 << quadraticCounts[i]);
+    }
+
+    if (pointCount > bufferSize) {
+        // Buffer not large enough; return necessary size to resize and try again
+        return pointCount;
+    }
+
+    PendingConics pending[kMaxConicToQuadCount];
+
+    Point* dst = quadraticPoints;
+    for (int i = 0; i < conicCount; i++) {
+        const int level = quadraticCounts[i];
+        if (level == 0 || level >= kMaxConicToQuadCount) {
+            // Nothing to subdivide, or a rare level that requires special handling
+            const Point* points = conicPoints + i * 3;
+            Conic conic(points[0], points[1], points[2], weights[i]);
+            quadraticCounts[i] = conic.splitIntoQuadratics(dst, level);
+        } else {
+            PendingConics& batch = pending[level];
+            batch.indices[batch.count] = i;
+            batch.outputs[batch.count] = dst;
+            quadraticCounts[i] = 1 << level;
+            // A batch holds at most kBatchCapacity conics once fully subdivided
+            if (++batch.count == kBatchCapacity >> level) {
+                convertPending(conicPoints, weights, batch, level);
+            }
+        }
+        dst += 1 + 2 * quadraticCounts[i];
+    }
+
+    for (int level = 1; level < kMaxConicToQuadCount; level++) {
+        convertPending(conicPoints, weights, pending[level], level);
+    }
+
+    return int(dst - quadraticPoints);
 }
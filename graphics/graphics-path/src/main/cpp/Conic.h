@@ -28,14 +28,33 @@ int conicToQuadratics(
         float weight, float tolerance
 ) noexcept;
 
+// Converts conicCount conics at once. Each conic is described by 3 consecutive points in
+// conicPoints and its weight in weights. The quadratics of each conic are written back to
+// back in quadraticPoints, 1 + 2 * n points for n quadratics, and quadraticCounts[i] receives
+// the number of quadratics produced for conic i. Returns the number of points written. If
+// bufferSize (in points) is not large enough, nothing is written and the returned value is
+// the size required to convert all the conics. Each conic is split in as many quadratics as by
+// the single conic conversion, the points only match it up to floating point rounding.
+int conicToQuadratics(
+        const Point conicPoints[], const float weights[], int conicCount,
+        Point* quadraticPoints, int quadraticCounts[], int bufferSize, float tolerance
+) noexcept;
+
 class ConicConverter {
 public:
     ConicConverter() noexcept { }
 
     const Point* toQuadratics(const Point points[3], float weight, float tolerance = 0.25f) noexcept;
 
+    // Same as toQuadratics() but uses a count previously returned by
+    // Conic::computeQuadraticCount() for this conic and tolerance
+    const Point* splitIntoQuadratics(const Point points[3], float weight, int count) noexcept;
+
     int quadraticCount() const noexcept { return mQuadraticCount; }
 
+    // Discards the current quadratics but keeps their storage
+    void reset() noexcept { mQuadraticCount = 0; }
+
     const Point* quadratics() const noexcept {
         return mQuadraticCount > 0 ? mStorage.data() : nullptr;
     }
@@ -57,6 +76,7 @@ struct Conic {
 
     void split(Conic* __restrict__ dst) const noexcept;
     int computeQuadraticCount(float tolerance) const noexcept;
+    int resolveQuadraticCount(int count) const noexcept;
     int splitIntoQuadratics(Point dstPoints[], int count) const noexcept;
 
     Point points[3];
@@ -0,0 +1,134 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PATH_GEOMETRY_H
+#define PATH_GEOMETRY_H
+
+#include "Path.h"
+
+#include "math/vec2.h"
+
+#include <cfloat>
+#include <cmath>
+
+constexpr filament::math::float2 fromPoint(const Point& v) noexcept {
+    return filament::math::float2{v.x, v.y};
+}
+
+constexpr Point toPoint(const filament::math::float2& v) noexcept {
+    return { .x = v.x, .y = v.y };
+}
+
+struct Bounds {
+    float left = FLT_MAX;
+    float top = FLT_MAX;
+    float right = -FLT_MAX;
+    float bottom = -FLT_MAX;
+
+    bool isEmpty() const noexcept { return left > right || top > bottom; }
+
+    void add(const Point& p) noexcept {
+        left = std::fmin(left, p.x);
+        top = std::fmin(top, p.y);
+        right = std::fmax(right, p.x);
+        bottom = std::fmax(bottom, p.y);
+    }
+};
+
+// Upper bound of the number of line segments used to approximate a single curve
+constexpr int kMaxCurveSteps = 1024;
+
+// Number of line segments required to approximate a curve of the given degree within
+// tolerance, where secondDifference is the largest norm of P[i] - 2 * P[i + 1] + P[i + 2]
+// over the control points of the curve (Wang's formula)
+static inline int curveStepCount(int degree, float secondDifference, float tolerance) noexcept {
+    float k = float(degree * (degree - 1)) / 8.0f;
+    float steps = std::ceil(std::sqrt(k * secondDifference / tolerance));
+    // Also catches NaN and infinite values
+    if (!(steps >= 1.0f)) return 1;
+    return steps < float(kMaxCurveSteps) ? int(steps) : kMaxCurveSteps;
+}
+
+static inline int quadraticStepCount(const Point p[3], float tolerance) noexcept {
+    auto d = fromPoint(p[0]) - 2.0f * fromPoint(p[1]) + fromPoint(p[2]);
+    return curveStepCount(2, length(d), tolerance);
+}
+
+static inline int cubicStepCount(const Point p[4], float tolerance) noexcept {
+    auto d0 = fromPoint(p[0]) - 2.0f * fromPoint(p[1]) + fromPoint(p[2]);
+    auto d1 = fromPoint(p[1]) - 2.0f * fromPoint(p[2]) + fromPoint(p[3]);
+    return curveStepCount(3, std::fmax(length(d0), length(d1)), tolerance);
+}
+
+static inline Point evaluateQuadratic(const Point p[3], float t) noexcept {
+    float u = 1.0f - t;
+    return toPoint(
+            (u * u) * fromPoint(p[0]) + (2.0f * u * t) * fromPoint(p[1]) + (t * t) * fromPoint(p[2])
+    );
+}
+
+static inline Point evaluateCubic(const Point p[4], float t) noexcept {
+    float u = 1.0f - t;
+    return toPoint(
+            (u * u * u) * fromPoint(p[0]) + (3.0f * u * u * t) * fromPoint(p[1]) +
+            (3.0f * u * t * t) * fromPoint(p[2]) + (t * t * t) * fromPoint(p[3])
+    );
+}
+
+// Adds to bounds the points of the quadratic where its derivative is 0 on either axis
+static inline void addQuadraticExtrema(Bounds& bounds, const Point p[3]) noexcept {
+    const filament::math::float2 p0 = fromPoint(p[0]);
+    const filament::math::float2 p1 = fromPoint(p[1]);
+    const filament::math::float2 denominator = p0 - 2.0f * p1 + fromPoint(p[2]);
+    for (int axis = 0; axis < 2; axis++) {
+        if (denominator[axis] == 0.0f) continue;
+        float t = (p0[axis] - p1[axis]) / denominator[axis];
+        if (t > 0.0f && t < 1.0f) bounds.add(evaluateQuadratic(p, t));
+    }
+}
+
+// Adds to bounds the points of the cubic where its derivative is 0 on either axis
+static inline void addCubicExtrema(Bounds& bounds, const Point p[4]) noexcept {
+    const filament::math::float2 p0 = fromPoint(p[0]);
+    const filament::math::float2 p1 = fromPoint(p[1]);
+    const filament::math::float2 p2 = fromPoint(p[2]);
+    const filament::math::float2 p3 = fromPoint(p[3]);
+
+    // The derivative, divided by 3, is a * t^2 + b * t + c
+    const filament::math::float2 a = 3.0f * (p1 - p2) + p3 - p0;
+    const filament::math::float2 b = 2.0f * (p0 - 2.0f * p1 + p2);
+    const filament::math::float2 c = p1 - p0;
+
+    for (int axis = 0; axis < 2; axis++) {
+        float roots[2];
+        int rootCount = 0;
+        if (std::abs(a[axis]) < 1e-6f) {
+            if (b[axis] != 0.0f) roots[rootCount++] = -c[axis] / b[axis];
+        } else {
+            float discriminant = b[axis] * b[axis] - 4.0f * a[axis] * c[axis];
+            if (discriminant >= 0.0f) {
+                float q = std::sqrt(discriminant);
+                roots[rootCount++] = (-b[axis] + q) / (2.0f * a[axis]);
+                roots[rootCount++] = (-b[axis] - q) / (2.0f * a[axis]);
+            }
+        }
+        for (int i = 0; i < rootCount; i++) {
+            if (roots[i] > 0.0f && roots[i] < 1.0f) bounds.add(evaluateCubic(p, roots[i]));
+        }
+    }
+}
+
+#endif //PATH_GEOMETRY_H
@@ -17,8 +17,14 @@
 #ifndef PATH_PATH_H
 #define PATH_PATH_H
 
+#include <stddef.h>
 #include <stdint.h>
 
+// Bionic defines __unused in sys/cdefs.h, define it for host builds
+#ifndef __unused
+#define __unused __attribute__((__unused__))
+#endif
+
 // The following structures declare the minimum we need + a marker (generationId) to
 // validate the data during debugging. There may be more fields in the Skia structures
 // but we just ignore them for now. Some fields declared in older API levels (isFinite
@@ -54,11 +60,11 @@ struct PathRef21 {
              Point* points;
              Verb* verbs;
              int verbCount;
-    __unused int pointCount;
+             int pointCount;
     __unused size_t freeSpace;
              float* conicWeights;
     __unused int conicWeightsReserve;
-    __unused int conicWeightsCount;
+             int conicWeightsCount;
     __unused uint32_t generationId;
 };
 
@@ -72,11 +78,11 @@ struct PathRef24 {
              Point* points;
              Verb* verbs;
              int verbCount;
-    __unused int pointCount;
+             int pointCount;
     __unused size_t freeSpace;
              float* conicWeights;
     __unused int conicWeightsReserve;
-    __unused int conicWeightsCount;
+             int conicWeightsCount;
     __unused uint32_t generationId;
 };
 
@@ -89,11 +95,11 @@ struct PathRef26 {
              Point* points;
              Verb* verbs;
              int verbCount;
-    __unused int pointCount;
+             int pointCount;
     __unused size_t freeSpace;
              float* conicWeights;
     __unused int conicWeightsReserve;
-    __unused int conicWeightsCount;
+             int conicWeightsCount;
     __unused uint32_t generationId;
 };
 
@@ -105,13 +111,13 @@ struct PathRef30 {
     __unused float bottom;
              Point* points;
     __unused int pointReserve;
-    __unused int pointCount;
+             int pointCount;
              Verb* verbs;
     __unused int verbReserve;
              int verbCount;
              float* conicWeights;
     __unused int conicWeightsReserve;
-    __unused int conicWeightsCount;
+             int conicWeightsCount;
     __unused uint32_t generationId;
 };
 
@@ -119,4 +125,17 @@ struct Path {
     PathRef21* pathRef;
 };
 
+// Raw segment data read from one of the PathRef layouts above. When verbs are stored
+// backward (API < 30), verbs points one past the first verb and the verbs must be read
+// in decreasing address order.
+struct PathData {
+    Point* points;
+    Verb* verbs;
+    float* conicWeights;
+    int verbCount;
+    int pointCount;
+    int conicWeightCount;
+    bool forwardVerbs;
+};
+
 #endif //PATH_PATH_H
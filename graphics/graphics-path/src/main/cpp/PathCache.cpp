@@ -0,0 +1,306 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PathCache.h"
+
+#include "Conic.h"
+#include "PathFlattener.h"
+#include "PathHash.h"
+#include "PathIterator.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+static bool contentEquals(const PathCache::Entry& entry, const PathData& data) noexcept {
+    if (int(entry.verbs.size()) != data.verbCount ||
+            int(entry.points.size()) != data.pointCount ||
+            int(entry.conicWeights.size()) != data.conicWeightCount) {
+        return false;
+    }
+
+    if (data.forwardVerbs) {
+        if (memcmp(entry.verbs.data(), data.verbs, data.verbCount * sizeof(Verb)) != 0) {
+            return false;
+        }
+    } else {
+        for (int i = 0; i < data.verbCount; i++) {
+            if (entry.verbs[i] != data.verbs[-1 - i]) return false;
+        }
+    }
+
+    return memcmp(entry.points.data(), data.points, data.pointCount * sizeof(Point)) == 0 &&
+            memcmp(entry.conicWeights.data(), data.conicWeights,
+                    data.conicWeightCount * sizeof(float)) == 0;
+}
+
+static PathIterator createIterator(
+        PathCache::Entry* entry, float tolerance
+) noexcept {
+    return PathIterator(
+            entry->points.data(), entry->verbs.data(), entry->conicWeights.data(),
+            int(entry->verbs.size()), int(entry->conicWeights.size()),
+            PathIterator::VerbDirection::Forward,
+            PathIterator::ConicEvaluation::AsQuadratics, tolerance
+    );
+}
+
+template<typename T>
+static size_t storageSize(const std::vector<T>& v) noexcept {
+    return v.capacity() * sizeof(T);
+}
+
+PathCache::Entry* PathCache::get(const PathData& data) noexcept {
+    const uint64_t hash = hashPath(data);
+
+    auto found = mIndex.find(hash);
+    if (found != mIndex.end()) {
+        auto entry = found->second;
+        if (contentEquals(*entry, data)) {
+            mEntries.splice(mEntries.begin(), mEntries, entry);
+            return &*entry;
+        }
+        // Hash collision, the most recent path replaces the cached one
+        remove(entry);
+    }
+
+    mEntries.emplace_front();
+    Entry* entry = &mEntries.front();
+    entry->hash = hash;
+
+    entry->verbs.resize(data.verbCount);
+    if (data.forwardVerbs) {
+        memcpy(entry->verbs.data(), data.verbs, data.verbCount * sizeof(Verb));
+    } else {
+        for (int i = 0; i < data.verbCount; i++) {
+            entry->verbs[i] = data.verbs[-1 - i];
+        }
+    }
+    entry->points.assign(data.points, data.points + data.pointCount);
+    entry->conicWeights.assign(data.conicWeights, data.conicWeights + data.conicWeightCount);
+
+    mIndex[hash] = mEntries.begin();
+    updateSize(entry);
+    return entry;
+}
+
+const Bounds& PathCache::bounds(Entry* entry) noexcept {
+    if (entry->hasBounds) return entry->bounds;
+
+    Bounds bounds;
+    PathIterator iterator = createIterator(entry, 0.25f);
+    Point points[4];
+    while (iterator.hasNext()) {
+        switch (iterator.next(points)) {
+            case Verb::Move:
+                bounds.add(points[0]);
+                break;
+            case Verb::Line:
+                bounds.add(points[1]);
+                break;
+            case Verb::Quadratic:
+                bounds.add(points[2]);
+                addQuadraticExtrema(bounds, points);
+                break;
+            case Verb::Cubic:
+                bounds.add(points[3]);
+                addCubicExtrema(bounds, points);
+                break;
+            case Verb::Conic:
+            case Verb::Close:
+            case Verb::Done:
+                break;
+        }
+    }
+
+    entry->bounds = bounds;
+    entry->hasBounds = true;
+    return entry->bounds;
+}
+
+const PathCache::Quadratics& PathCache::quadratics(Entry* entry, float tolerance) noexcept {
+    Quadratics& quadratics = entry->quadratics;
+    if (quadratics.tolerance == tolerance) return quadratics;
+
+    // Gather the conics of the path to convert them all at once with the batched
+    // conicToQuadratics(), instead of one at a time as PathIterator does. Like PathIterator,
+    // stop at the first Done verb.
+    const Verb* verbs = entry->verbs.data();
+    const int verbCount = int(std::find(verbs, verbs + entry->verbs.size(), Verb::Done) - verbs);
+
+    mConicPoints.clear();
+    const Point* points = entry->points.data();
+    for (int v = 0; v < verbCount; v++) {
+        const Verb verb = verbs[v];
+        switch (verb) {
+            case Verb::Move:
+            case Verb::Line:
+                points += 1;
+                break;
+            case Verb::Conic:
+                mConicPoints.insert(mConicPoints.end(), points - 1, points + 2);
+                points += 2;
+                break;
+            case Verb::Quadratic:
+                points += 2;
+                break;
+            case Verb::Cubic:
+                points += 3;
+                break;
+            case Verb::Close:
+            case Verb::Done:
+                break;
+        }
+    }
+
+    const int conicCount = int(mConicPoints.size() / 3);
+    mQuadraticCounts.resize(conicCount);
+    int size = conicToQuadratics(
+            mConicPoints.data(), entry->conicWeights.data(), conicCount,
+            mConicQuadratics.data(), mQuadraticCounts.data(), int(mConicQuadratics.size()),
+            tolerance
+    );
+    if (size > int(mConicQuadratics.size())) {
+        mConicQuadratics.resize(size);
+        conicToQuadratics(
+                mConicPoints.data(), entry->conicWeights.data(), conicCount,
+                mConicQuadratics.data(), mQuadraticCounts.data(), size, tolerance
+        );
+    }
+
+    int count = verbCount - conicCount;
+    for (int quadraticCount : mQuadraticCounts) {
+        count += quadraticCount;
+    }
+    quadratics.verbs.resize(count);
+    quadratics.points.resize(count * 4);
+
+    // Same layout as PathIterator::next(Verb[], Point[], int)
+    Verb* dstVerbs = quadratics.verbs.data();
+    Point* dst = quadratics.points.data();
+    const Point* conicQuadratics = mConicQuadratics.data();
+    const int* quadraticCounts = mQuadraticCounts.data();
+    points = entry->points.data();
+    for (int v = 0; v < verbCount; v++) {
+        const Verb verb = verbs[v];
+        switch (verb) {
+            case Verb::Move:
+                dst[0] = points[0];
+                points += 1;
+                break;
+            case Verb::Line:
+                dst[0] = points[-1];
+                dst[1] = points[0];
+                points += 1;
+                break;
+            case Verb::Quadratic:
+                dst[0] = points[-1];
+                dst[1] = points[0];
+                dst[2] = points[1];
+                points += 2;
+                break;
+            case Verb::Conic: {
+                const int quadraticCount = *quadraticCounts++;
+                for (int i = 0; i < quadraticCount; i++) {
+                    *dstVerbs++ = Verb::Quadratic;
+                    dst[0] = conicQuadratics[i * 2];
+                    dst[1] = conicQuadratics[i * 2 + 1];
+                    dst[2] = conicQuadratics[i * 2 + 2];
+                    dst += 4;
+                }
+                conicQuadratics += 1 + 2 * quadraticCount;
+                points += 2;
+                continue;
+            }
+            case Verb::Cubic:
+                dst[0] = points[-1];
+                dst[1] = points[0];
+                dst[2] = points[1];
+                dst[3] = points[2];
+                points += 3;
+                break;
+            case Verb::Close:
+            case Verb::Done:
+                break;
+        }
+        *dstVerbs++ = verb;
+        dst += 4;
+    }
+    quadratics.tolerance = tolerance;
+
+    updateSize(entry);
+    return quadratics;
+}
+
+const PathCache::Polylines& PathCache::polylines(Entry* entry, float tolerance) noexcept {
+    Polylines& polylines = entry->polylines;
+    if (polylines.tolerance == tolerance) return polylines;
+
+    for (;;) {
+        PathIterator iterator = createIterator(entry, tolerance);
+        PathFlattener flattener(
+                polylines.points.data(), int(polylines.points.size()),
+                polylines.contourEnds.data(), int(polylines.contourEnds.size()),
+                tolerance
+        );
+        flattener.flatten(iterator);
+
+        polylines.pointCount = flattener.pointCount();
+        polylines.contourCount = flattener.contourCount();
+        if (flattener.isComplete()) break;
+
+        // Grow the storage to the size reported by the flattener and try again
+        polylines.points.resize(polylines.pointCount);
+        polylines.contourEnds.resize(polylines.contourCount);
+    }
+    polylines.tolerance = tolerance;
+
+    updateSize(entry);
+    return polylines;
+}
+
+void PathCache::clear() noexcept {
+    mIndex.clear();
+    mEntries.clear();
+    mSize = 0;
+}
+
+void PathCache::updateSize(Entry* entry) noexcept {
+    const size_t size = sizeof(Entry) +
+            storageSize(entry->verbs) +
+            storageSize(entry->points) +
+            storageSize(entry->conicWeights) +
+            storageSize(entry->quadratics.verbs) +
+            storageSize(entry->quadratics.points) +
+            storageSize(entry->polylines.points) +
+            storageSize(entry->polylines.contourEnds);
+    mSize = mSize - entry->size + size;
+    entry->size = size;
+    trimToSize();
+}
+
+void PathCache::trimToSize() noexcept {
+    // The most recently used entry is kept even if it is larger than the cache
+    while (mSize > mMaxSize && mEntries.size() > 1) {
+        remove(std::prev(mEntries.end()));
+    }
+}
+
+void PathCache::remove(EntryList::iterator entry) noexcept {
+    mSize -= entry->size;
+    mIndex.erase(entry->hash);
+    mEntries.erase(entry);
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PATH_PATH_CACHE_H
+#define PATH_PATH_CACHE_H
+
+#include "Geometry.h"
+#include "Path.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+// Content-addressed cache of geometry derived from paths. Entries are keyed by the
+// content hash of a path (see hashPath()) and keep a copy of the path data to reject
+// hash collisions, so identical paths rebuilt from scratch (every frame in Compose for
+// instance) share the same entry. Each kind of derived data is computed on first use and
+// recomputed only when requested with a different tolerance.
+//
+// The total size of the entries is bounded by maxSize, least recently used entries are
+// evicted first. Pointers to entries and to their data are only valid until the next call
+// to the cache. The cache is not thread safe.
+class PathCache {
+public:
+    struct Quadratics {
+        float tolerance = -1.0f;
+        // Conics converted to quadratics, with 4 points per verb (PathIterator layout)
+        std::vector<Verb> verbs;
+        std::vector<Point> points;
+    };
+
+    struct Polylines {
+        float tolerance = -1.0f;
+        // See PathFlattener
+        std::vector<Point> points;
+        std::vector<int> contourEnds;
+        int pointCount = 0;
+        int contourCount = 0;
+    };
+
+    struct Entry {
+        uint64_t hash;
+        // Copy of the path data, with verbs in forward order
+        std::vector<Verb> verbs;
+        std::vector<Point> points;
+        std::vector<float> conicWeights;
+
+        bool hasBounds = false;
+        Bounds bounds;
+        Quadratics quadratics;
+        Polylines polylines;
+        size_t size = 0;
+    };
+
+    explicit PathCache(size_t maxSize) noexcept : mMaxSize(maxSize) { }
+
+    PathCache(const PathCache&) = delete;
+    PathCache& operator=(const PathCache&) = delete;
+
+    // Returns the entry matching the content of the path, creating it if needed
+    Entry* get(const PathData& data) noexcept;
+
+    // Tight bounds of the path, computed from the extrema of its curves
+    const Bounds& bounds(Entry* entry) noexcept;
+    const Quadratics& quadratics(Entry* entry, float tolerance) noexcept;
+    const Polylines& polylines(Entry* entry, float tolerance) noexcept;
+
+    size_t size() const noexcept { return mSize; }
+    size_t maxSize() const noexcept { return mMaxSize; }
+
+    void clear() noexcept;
+
+private:
+    using EntryList = std::list<Entry>;
+
+    void updateSize(Entry* entry) noexcept;
+    void trimToSize() noexcept;
+    void remove(EntryList::iterator entry) noexcept;
+
+    const size_t mMaxSize;
+    size_t mSize = 0;
+    // Most recently used entry first
+    EntryList mEntries;
+    std::unordered_map<uint64_t, EntryList::iterator> mIndex;
+    // Scratch storage of quadratics(), kept to convert conics without allocating
+    std::vector<Point> mConicPoints;
+    std::vector<Point> mConicQuadratics;
+    std::vector<int> mQuadraticCounts;
+};
+
+#endif //PATH_PATH_CACHE_H
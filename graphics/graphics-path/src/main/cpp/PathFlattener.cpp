@@ -0,0 +1,113 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PathFlattener.h"
+
+#include "Geometry.h"
+#include "PathIterator.h"
+
+void PathFlattener::add(Verb verb, const Point points[4], float weight) noexcept {
+    switch (verb) {
+        case Verb::Move:
+            moveTo(points[0]);
+            break;
+        case Verb::Line:
+            lineTo(points[1]);
+            break;
+        case Verb::Quadratic:
+            quadraticTo(points);
+            break;
+        case Verb::Conic: {
+            const Point* quadratics = mConverter.toQuadratics(points, weight, mTolerance);
+            for (int i = 0; i < mConverter.quadraticCount(); i++) {
+                quadraticTo(quadratics + i * 2);
+            }
+            break;
+        }
+        case Verb::Cubic:
+            cubicTo(points);
+            break;
+        case Verb::Close:
+            close();
+            break;
+        case Verb::Done:
+            break;
+    }
+}
+
+void PathFlattener::flatten(PathIterator& iterator) noexcept {
+    Point points[4];
+    while (iterator.hasNext()) {
+        Verb verb = iterator.next(points);
+        add(verb, points, points[3].x);
+    }
+    finish();
+}
+
+void PathFlattener::finish() noexcept {
+    endContour(false);
+}
+
+void PathFlattener::endContour(bool closed) noexcept {
+    if (mPointCount > mContourStart) {
+        if (mContourCount < mContourCapacity) {
+            mContourEnds[mContourCount] = mPointCount;
+            if (mContourClosed) mContourClosed[mContourCount] = closed ? 1 : 0;
+        }
+        mContourCount++;
+    }
+    mContourStart = mPointCount;
+}
+
+void PathFlattener::moveTo(const Point& point) noexcept {
+    finish();
+    mFirstPoint = point;
+    lineTo(point);
+}
+
+void PathFlattener::lineTo(const Point& point) noexcept {
+    if (mPointCount < mPointCapacity) {
+        mPoints[mPointCount] = point;
+    }
+    mPointCount++;
+    mLastPoint = point;
+}
+
+void PathFlattener::quadraticTo(const Point points[3]) noexcept {
+    const int steps = quadraticStepCount(points, mTolerance);
+    const float dt = 1.0f / float(steps);
+    for (int i = 1; i < steps; i++) {
+        lineTo(evaluateQuadratic(points, float(i) * dt));
+    }
+    lineTo(points[2]);
+}
+
+void PathFlattener::cubicTo(const Point points[4]) noexcept {
+    const int steps = cubicStepCount(points, mTolerance);
+    const float dt = 1.0f / float(steps);
+    for (int i = 1; i < steps; i++) {
+        lineTo(evaluateCubic(points, float(i) * dt));
+    }
+    lineTo(points[3]);
+}
+
+void PathFlattener::close() noexcept {
+    if (mPointCount > mContourStart &&
+            (mLastPoint.x != mFirstPoint.x || mLastPoint.y != mFirstPoint.y)) {
+        lineTo(mFirstPoint);
+    }
+    endContour(true);
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PATH_PATH_FLATTENER_H
+#define PATH_PATH_FLATTENER_H
+
+#include "Conic.h"
+#include "Path.h"
+
+#include <stdint.h>
+
+class PathIterator;
+
+// Approximates path segments with polylines written into caller provided buffers. Each
+// contour is stored as a run of points and contourEnds[i] receives the index one past the
+// last point of contour i. Closed contours end with a copy of their first point.
+//
+// When a buffer is too small, the flattener keeps counting without writing so that
+// pointCount() and contourCount() return the sizes required to flatten the whole path.
+class PathFlattener {
+public:
+    PathFlattener(
+            Point points[], int pointCapacity,
+            int contourEnds[], int contourCapacity,
+            float tolerance = 0.25f
+    ) noexcept
+            : mPoints(points),
+              mContourEnds(contourEnds),
+              mPointCapacity(pointCapacity),
+              mContourCapacity(contourCapacity),
+              mTolerance(tolerance) {
+    }
+
+    // When set, closed[i] receives 1 if contour i was closed, 0 otherwise. The array
+    // must hold as many values as contourEnds
+    void setContourClosedFlags(uint8_t closed[]) noexcept { mContourClosed = closed; }
+
+    // Segment points follow the PathIterator layout
+    void add(Verb verb, const Point points[4], float weight = 0.0f) noexcept;
+
+    // Flattens all the remaining segments of iterator and finishes the last contour
+    void flatten(PathIterator& iterator) noexcept;
+
+    // Ends the current contour, if any
+    void finish() noexcept;
+
+    int pointCount() const noexcept { return mPointCount; }
+    int contourCount() const noexcept { return mContourCount; }
+
+    bool isComplete() const noexcept {
+        return mPointCount <= mPointCapacity && mContourCount <= mContourCapacity;
+    }
+
+private:
+    void moveTo(const Point& point) noexcept;
+    void lineTo(const Point& point) noexcept;
+    void quadraticTo(const Point points[3]) noexcept;
+    void cubicTo(const Point points[4]) noexcept;
+    void close() noexcept;
+    void endContour(bool closed) noexcept;
+
+    Point* mPoints;
+    int* mContourEnds;
+    uint8_t* mContourClosed = nullptr;
+    const int mPointCapacity;
+    const int mContourCapacity;
+    const float mTolerance;
+    int mPointCount = 0;
+    int mContourCount = 0;
+    int mContourStart = 0;
+    Point mFirstPoint{};
+    Point mLastPoint{};
+    ConicConverter mConverter;
+};
+
+#endif //PATH_PATH_FLATTENER_H
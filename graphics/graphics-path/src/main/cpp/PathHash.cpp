@@ -0,0 +1,85 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PathHash.h"
+
+#include <string.h>
+
+constexpr uint64_t kMultiplier0 = 0x9e3779b97f4a7c15ull;
+constexpr uint64_t kMultiplier1 = 0xbf58476d1ce4e5b9ull;
+
+// Mixes 8 bytes into the hash with two multiplications, which is enough to spread the
+// bits of a point's coordinates since the final avalanche takes care of the rest
+static inline uint64_t mix(uint64_t hash, uint64_t value) noexcept {
+    value *= kMultiplier0;
+    value ^= value >> 32;
+    return (hash ^ value) * kMultiplier1;
+}
+
+// Finalizer of MurmurHash3, makes every bit of the result depend on every input bit
+static inline uint64_t avalanche(uint64_t hash) noexcept {
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ull;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+uint64_t hashPath(const PathData& data) noexcept {
+    uint64_t hash = mix(uint64_t(data.verbCount), uint64_t(data.pointCount));
+    hash = mix(hash, uint64_t(data.conicWeightCount));
+
+    // Pack 8 verbs per word
+    const int verbCount = data.verbCount;
+    int i = 0;
+    if (data.forwardVerbs) {
+        for (; i + 8 <= verbCount; i += 8) {
+            uint64_t word;
+            memcpy(&word, data.verbs + i, sizeof(word));
+            hash = mix(hash, word);
+        }
+    }
+    uint64_t word = 0;
+    int shift = 0;
+    for (; i < verbCount; i++) {
+        const Verb verb = data.forwardVerbs ? data.verbs[i] : data.verbs[-1 - i];
+        word |= uint64_t(verb) << shift;
+        shift += 8;
+        if (shift == 64) {
+            hash = mix(hash, word);
+            word = 0;
+            shift = 0;
+        }
+    }
+    if (shift > 0) hash = mix(hash, word);
+
+    // Each point is exactly one word
+    static_assert(sizeof(Point) == sizeof(uint64_t), "Points must be 8 bytes");
+    for (int j = 0; j < data.pointCount; j++) {
+        uint64_t point;
+        memcpy(&point, data.points + j, sizeof(point));
+        hash = mix(hash, point);
+    }
+
+    for (int j = 0; j < data.conicWeightCount; j++) {
+        uint32_t weight;
+        memcpy(&weight, data.conicWeights + j, sizeof(weight));
+        hash = mix(hash, weight);
+    }
+
+    return avalanche(hash);
+}
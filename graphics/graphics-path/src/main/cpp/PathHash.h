@@ -0,0 +1,30 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PATH_PATH_HASH_H
+#define PATH_PATH_HASH_H
+
+#include "Path.h"
+
+#include <stdint.h>
+
+// Computes a 64-bit hash of the content of a path: its verbs, in forward order whatever
+// the PathRef layout, its points and its conic weights. Points and weights are hashed
+// bitwise, so 0.0f and -0.0f produce different hashes. Two paths with equal hashes are
+// very likely, but not guaranteed, to be identical.
+uint64_t hashPath(const PathData& data) noexcept;
+
+#endif //PATH_PATH_HASH_H
@@ -16,15 +16,53 @@
 
 #include "PathIterator.h"
 
+void PathIterator::reset(
+        Point* points,
+        Verb* verbs,
+        float* conicWeights,
+        int count,
+        int conicWeightCount,
+        VerbDirection direction,
+        ConicEvaluation conicEvaluation,
+        float tolerance
+) noexcept {
+    mPoints = points;
+    mVerbs = verbs;
+    mConicWeights = conicWeights;
+    mFirstPoint = points;
+    mFirstVerb = verbs;
+    mFirstConicWeight = conicWeights;
+    mIndex = count;
+    mCount = count;
+    mConicWeightCount = conicWeightCount;
+    mDirection = direction;
+    mConicEvaluation = conicEvaluation;
+    mTolerance = tolerance;
+    mConverter.reset();
+    mConicCurrentQuadratic = 0;
+    mConicIndex = 0;
+    mConvertedCount = -1;
+    mConicCounts.clear();
+}
+
 int PathIterator::count() noexcept {
     if (mConicEvaluation == ConicEvaluation::AsConic) {
         return mCount;
     }
 
+    if (mConvertedCount >= 0) {
+        return mConvertedCount;
+    }
+
+    // Always count from the beginning of the path, even if the iteration already started
     int count = 0;
-    const Verb* verbs = mVerbs;
-    const Point* points = mPoints;
-    const float* conicWeights = mConicWeights;
+    const Verb* verbs = mFirstVerb;
+    const Point* points = mFirstPoint;
+    const float* conicWeights = mFirstConicWeight;
+
+    // Sized once per path; the capacity is kept by reset() for pooled iterators
+    mConicCounts.clear();
+    mConicCounts.reserve(mConicWeightCount);
 
     for (int i = 0; i < mCount; i++) {
         Verb verb = *(mDirection == VerbDirection::Forward ? verbs++ : --verbs);
@@ -38,12 +76,15 @@ int PathIterator::count() noexcept {
                 points += 2;
                 count++;
                 break;
-            case Verb::Conic:
-                mConverter.toQuadratics(points - 1, *conicWeights, mTolerance);
+            case Verb::Conic: {
+                Conic conic(points[-1], points[0], points[1], *conicWeights);
+                int conicCount = conic.computeQuadraticCount(mTolerance);
+                mConicCounts.push_back(uint8_t(conicCount));
                 conicWeights++;
                 points += 2;
-                count += mConverter.quadraticCount();
+                count += conic.resolveQuadraticCount(conicCount);
                 break;
+            }
             case Verb::Cubic:
                 points += 3;
                 count++;
@@ -55,16 +96,13 @@ int PathIterator::count() noexcept {
         }
     }
 
+    mConvertedCount = count;
     return count;
 }
 
 Verb PathIterator::next(Point points[4]) noexcept {
-    if (mIndex <= 0) {
-        return Verb::Done;
-    }
-
     convertConicToQuadratic:
-    if (mConicCurrentQuadratic != mConverter.quadraticCount()) {
+    if (hasPendingQuadratics()) {
         const Point* quadraticPoints = mConverter.quadratics();
         int index = mConicCurrentQuadratic * 2;
         points[0] = quadraticPoints[index];
@@ -74,6 +112,10 @@ Verb PathIterator::next(Point points[4]) noexcept {
         return Verb::Quadratic;
     }
 
+    if (mIndex <= 0) {
+        return Verb::Done;
+    }
+
     mIndex--;
 
     Verb verb = *(mDirection == VerbDirection::Forward ? mVerbs++ : --mVerbs);
@@ -103,7 +145,15 @@ Verb PathIterator::next(Point points[4]) noexcept {
             mPoints += 2;
 
             if (mConicEvaluation == ConicEvaluation::AsQuadratics) {
-                mConverter.toQuadratics(points, points[3].x, mTolerance);
+                if (mConicIndex < int(mConicCounts.size())) {
+                    // count() already computed how to subdivide this conic
+                    mConverter.splitIntoQuadratics(
+                            points, points[3].x, mConicCounts[mConicIndex]
+                    );
+                } else {
+                    mConverter.toQuadratics(points, points[3].x, mTolerance);
+                }
+                mConicIndex++;
                 mConicCurrentQuadratic = 0;
                 goto convertConicToQuadratic;
             }
@@ -123,3 +173,14 @@ Verb PathIterator::next(Point points[4]) noexcept {
 
     return verb;
 }
+
+int PathIterator::next(Verb verbs[], Point points[], int count) noexcept {
+    int index = 0;
+    while (index < count) {
+        Verb verb = next(points);
+        if (verb == Verb::Done) break;
+        verbs[index++] = verb;
+        points += 4;
+    }
+    return index;
+}
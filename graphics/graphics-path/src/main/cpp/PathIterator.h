@@ -20,6 +20,10 @@
 #include "Path.h"
 #include "Conic.h"
 
+#include <stdint.h>
+
+#include <vector>
+
 class PathIterator {
 public:
     enum class VerbDirection : uint8_t  {
@@ -37,44 +41,78 @@ public:
             Verb* verbs,
             float* conicWeights,
             int count,
+            int conicWeightCount,
             VerbDirection direction,
             ConicEvaluation conicEvaluation,
             float tolerance = 0.25f
-    ) noexcept
-            : mPoints(points),
-              mVerbs(verbs),
-              mConicWeights(conicWeights),
-              mIndex(count),
-              mCount(count),
-              mDirection(direction),
-              mConicEvaluation(conicEvaluation),
-              mTolerance(tolerance) {
+    ) noexcept {
+        reset(points, verbs, conicWeights, count, conicWeightCount, direction, conicEvaluation,
+                tolerance);
     }
 
+    // Restarts the iteration over a new path. The storage used to convert conics is kept,
+    // which lets pooled iterators be reused without allocating.
+    void reset(
+            Point* points,
+            Verb* verbs,
+            float* conicWeights,
+            int count,
+            int conicWeightCount,
+            VerbDirection direction,
+            ConicEvaluation conicEvaluation,
+            float tolerance = 0.25f
+    ) noexcept;
+
     int rawCount() const noexcept { return mCount; }
 
+    // Returns the number of verbs in the path once conics are converted, if needed. The
+    // subdivision count of each conic is computed once and reused by later calls to next()
+    // so that conics are never subdivided to only count their quadratics.
     int count() noexcept;
 
-    bool hasNext() const noexcept { return mIndex > 0; }
+    // The quadratics of the last conic of a path are still pending once all verbs are read
+    bool hasNext() const noexcept { return mIndex > 0 || hasPendingQuadratics(); }
 
     Verb peek() const noexcept {
-        auto verbs = mDirection == VerbDirection::Forward ? mVerbs : mVerbs - 1;
-        return mIndex > 0 ? *verbs : Verb::Done;
+        if (hasPendingQuadratics()) return Verb::Quadratic;
+        if (mIndex <= 0) return Verb::Done;
+        Verb verb = *(mDirection == VerbDirection::Forward ? mVerbs : mVerbs - 1);
+        // next() returns the first quadratic of a converted conic
+        if (verb == Verb::Conic && mConicEvaluation == ConicEvaluation::AsQuadratics) {
+            return Verb::Quadratic;
+        }
+        return verb;
     }
 
     Verb next(Point points[4]) noexcept;
 
+    // Fills verbs with up to count verbs and points with 4 points per verb, so that the
+    // points of verbs[i] start at points[i * 4]. Returns the number of verbs written, which
+    // is less than count only when the iteration is finished. Done is never written.
+    int next(Verb verbs[], Point points[], int count) noexcept;
+
 private:
+    bool hasPendingQuadratics() const noexcept {
+        return mConicCurrentQuadratic != mConverter.quadraticCount();
+    }
+
     const Point* mPoints;
     const Verb* mVerbs;
     const float* mConicWeights;
+    const Point* mFirstPoint;
+    const Verb* mFirstVerb;
+    const float* mFirstConicWeight;
     int mIndex;
-    const int mCount;
-    const VerbDirection mDirection;
-    const ConicEvaluation mConicEvaluation;
-    const float mTolerance;
+    int mCount;
+    int mConicWeightCount;
+    VerbDirection mDirection;
+    ConicEvaluation mConicEvaluation;
+    float mTolerance;
     ConicConverter mConverter;
-    int mConicCurrentQuadratic = 0;
+    int mConicCurrentQuadratic;
+    int mConicIndex;
+    int mConvertedCount;
+    std::vector<uint8_t> mConicCounts;
 };
 
 #endif //PATH_PATH_ITERATOR_H
@@ -0,0 +1,64 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PathIteratorPool.h"
+
+PathIteratorPool::~PathIteratorPool() noexcept {
+    for (int i = 0; i < mFreeCount; i++) {
+        delete mFree[i];
+    }
+}
+
+PathIterator* PathIteratorPool::acquire(
+        Point* points,
+        Verb* verbs,
+        float* conicWeights,
+        int count,
+        int conicWeightCount,
+        PathIterator::VerbDirection direction,
+        PathIterator::ConicEvaluation conicEvaluation,
+        float tolerance
+) noexcept {
+    PathIterator* iterator = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        if (mFreeCount > 0) iterator = mFree[--mFreeCount];
+    }
+
+    if (iterator == nullptr) {
+        return new PathIterator(
+                points, verbs, conicWeights, count, conicWeightCount, direction, conicEvaluation,
+                tolerance
+        );
+    }
+
+    iterator->reset(
+            points, verbs, conicWeights, count, conicWeightCount, direction, conicEvaluation,
+            tolerance
+    );
+    return iterator;
+}
+
+void PathIteratorPool::release(PathIterator* iterator) noexcept {
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        if (mFreeCount < kCapacity) {
+            mFree[mFreeCount++] = iterator;
+            return;
+        }
+    }
+    delete iterator;
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PATH_PATH_ITERATOR_POOL_H
+#define PATH_PATH_ITERATOR_POOL_H
+
+#include "PathIterator.h"
+
+#include <mutex>
+
+// Free list of released iterators. Iterating over many short paths (glyph outlines, icons)
+// creates and destroys iterators at a high rate; reusing them avoids allocating both the
+// iterator and its conic conversion storage every time. Iterators can be released from
+// any thread (typically the finalizer thread), so the free list is guarded by a mutex.
+class PathIteratorPool {
+public:
+    // Maximum number of released iterators kept for reuse, extra iterators are deleted
+    static constexpr int kCapacity = 32;
+
+    PathIteratorPool() noexcept { }
+    ~PathIteratorPool() noexcept;
+
+    PathIteratorPool(const PathIteratorPool&) = delete;
+    PathIteratorPool& operator=(const PathIteratorPool&) = delete;
+
+    PathIterator* acquire(
+            Point* points,
+            Verb* verbs,
+            float* conicWeights,
+            int count,
+            int conicWeightCount,
+            PathIterator::VerbDirection direction,
+            PathIterator::ConicEvaluation conicEvaluation,
+            float tolerance
+    ) noexcept;
+
+    void release(PathIterator* iterator) noexcept;
+
+private:
+    std::mutex mLock;
+    PathIterator* mFree[kCapacity];
+    int mFreeCount = 0;
+};
+
+#endif //PATH_PATH_ITERATOR_POOL_H
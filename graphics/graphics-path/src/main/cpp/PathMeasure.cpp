@@ -0,0 +1,136 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PathMeasure.h"
+
+#include <algorithm>
+
+using namespace filament::math;
+
+void PathMeasure::addSegment(
+        PathFlattener& flattener, Verb verb, const Point points[4], float weight,
+        float tolerance
+) noexcept {
+    switch (verb) {
+        case Verb::Move:
+            mBounds.add(points[0]);
+            break;
+        case Verb::Line:
+            mBounds.add(points[1]);
+            break;
+        case Verb::Quadratic:
+            mBounds.add(points[2]);
+            addQuadraticExtrema(mBounds, points);
+            break;
+        case Verb::Conic: {
+            const Point* quadratics = mConverter.toQuadratics(points, weight, tolerance);
+            for (int i = 0; i < mConverter.quadraticCount(); i++) {
+                mBounds.add(quadratics[i * 2 + 2]);
+                addQuadraticExtrema(mBounds, quadratics + i * 2);
+            }
+            break;
+        }
+        case Verb::Cubic:
+            mBounds.add(points[3]);
+            addCubicExtrema(mBounds, points);
+            break;
+        case Verb::Close:
+        case Verb::Done:
+            break;
+    }
+    flattener.add(verb, points, weight);
+}
+
+void PathMeasure::computeLengths() noexcept {
+    mDistances.resize(mPointCount);
+    mLengths.resize(mContourCount);
+
+    for (int contour = 0; contour < mContourCount; contour++) {
+        const int start = contourStart(contour);
+        const int end = mContourEnds[contour];
+
+        float distance = 0.0f;
+        mDistances[start] = 0.0f;
+        for (int i = start + 1; i < end; i++) {
+            distance += norm(fromPoint(mPoints[i]) - fromPoint(mPoints[i - 1]));
+            mDistances[i] = distance;
+        }
+        mLengths[contour] = distance;
+    }
+}
+
+Point PathMeasure::pointAt(int contour, float distance, int* index) const noexcept {
+    const int start = contourStart(contour);
+    const int end = mContourEnds[contour];
+    const float* distances = mDistances.data();
+
+    // First point strictly past distance, the point at distance lies on the line before it
+    int next = int(std::upper_bound(distances + start + 1, distances + end, distance) - distances);
+    if (next >= end) next = end - 1;
+    // Skip zero length lines, which do not define a direction
+    while (next > start + 1 && distances[next - 1] == distances[next]) next--;
+    *index = next;
+
+    const float2 p0 = fromPoint(mPoints[next - 1]);
+    const float2 p1 = fromPoint(mPoints[next]);
+    const float segmentLength = distances[next] - distances[next - 1];
+    const float t = segmentLength > 0.0f ? (distance - distances[next - 1]) / segmentLength : 0.0f;
+    return toPoint(p0 + (p1 - p0) * std::clamp(t, 0.0f, 1.0f));
+}
+
+bool PathMeasure::getPosTan(
+        int contour, float distance, Point* position, Point* tangent
+) const noexcept {
+    const float contourLength = mLengths[contour];
+    if (contourLength <= 0.0f) {
+        *position = mPoints[contourStart(contour)];
+        *tangent = { .x = 0.0f, .y = 0.0f };
+        return false;
+    }
+
+    int index;
+    *position = pointAt(contour, std::clamp(distance, 0.0f, contourLength), &index);
+    const float2 direction = fromPoint(mPoints[index]) - fromPoint(mPoints[index - 1]);
+    const float directionLength = norm(direction);
+    *tangent = directionLength > 0.0f ?
+            toPoint(direction / directionLength) : Point{ .x = 0.0f, .y = 0.0f };
+    return true;
+}
+
+int PathMeasure::getSegment(
+        int contour, float start, float end, Point points[], int capacity
+) const noexcept {
+    const float contourLength = mLengths[contour];
+    start = std::clamp(start, 0.0f, contourLength);
+    end = std::clamp(end, 0.0f, contourLength);
+    if (start > end || contourLength <= 0.0f) return 0;
+
+    int startIndex;
+    int endIndex;
+    const Point first = pointAt(contour, start, &startIndex);
+    const Point last = pointAt(contour, end, &endIndex);
+
+    // The first point, all the points strictly between start and end, and the last point
+    const int count = 2 + std::max(0, endIndex - startIndex);
+    if (count > capacity) return count;
+
+    points[0] = first;
+    for (int i = startIndex; i < endIndex; i++) {
+        points[1 + i - startIndex] = mPoints[i];
+    }
+    points[count - 1] = last;
+    return count;
+}
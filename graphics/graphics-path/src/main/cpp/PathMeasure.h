@@ -0,0 +1,113 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PATH_PATH_MEASURE_H
+#define PATH_PATH_MEASURE_H
+
+#include "Conic.h"
+#include "Geometry.h"
+#include "PathFlattener.h"
+
+#include <stdint.h>
+
+#include <vector>
+
+// Measures the contours of a path. The path is flattened once by setPath(), which caches
+// the cumulative arc length at every point of the resulting polylines; queries then only
+// perform a binary search in that table. Storage is reused across calls to setPath().
+class PathMeasure {
+public:
+    PathMeasure() noexcept { }
+
+    // Measures the segments produced by source, a callable invoked with a callable
+    // add(Verb verb, const Point points[4], float weight) that must be called once per
+    // segment, in iteration order. source may be invoked more than once.
+    template<typename Source>
+    void setPath(Source&& source, float tolerance) noexcept {
+        for (;;) {
+            mBounds = { };
+            PathFlattener flattener(
+                    mPoints.data(), int(mPoints.size()),
+                    mContourEnds.data(), int(mContourEnds.size()),
+                    tolerance
+            );
+            flattener.setContourClosedFlags(mContourClosed.data());
+
+            source([&](Verb verb, const Point points[4], float weight) {
+                addSegment(flattener, verb, points, weight, tolerance);
+            });
+            flattener.finish();
+
+            if (flattener.isComplete()) {
+                mPointCount = flattener.pointCount();
+                mContourCount = flattener.contourCount();
+                break;
+            }
+
+            // Grow the storage to the size reported by the flattener and try again
+            mPoints.resize(flattener.pointCount());
+            mContourEnds.resize(flattener.contourCount());
+            mContourClosed.resize(flattener.contourCount());
+        }
+        computeLengths();
+    }
+
+    int contourCount() const noexcept { return mContourCount; }
+
+    // Tight bounds of the path, computed from the extrema of its curves
+    const Bounds& bounds() const noexcept { return mBounds; }
+
+    float length(int contour) const noexcept { return mLengths[contour]; }
+
+    bool isClosed(int contour) const noexcept { return mContourClosed[contour] != 0; }
+
+    // Computes the position and unit tangent at the given distance along the contour.
+    // distance is clamped to [0, length(contour)]. Returns false if the contour has a
+    // length of 0, in which case position is set to the contour's first point.
+    bool getPosTan(int contour, float distance, Point* position, Point* tangent) const noexcept;
+
+    // Writes the polyline between the distances start and end along the contour into
+    // points and returns the number of points of that polyline. Nothing is written if
+    // the polyline is larger than capacity.
+    int getSegment(int contour, float start, float end, Point points[], int capacity)
+            const noexcept;
+
+private:
+    void addSegment(
+            PathFlattener& flattener, Verb verb, const Point points[4], float weight,
+            float tolerance
+    ) noexcept;
+    void computeLengths() noexcept;
+
+    int contourStart(int contour) const noexcept {
+        return contour > 0 ? mContourEnds[contour - 1] : 0;
+    }
+
+    Point pointAt(int contour, float distance, int* index) const noexcept;
+
+    std::vector<Point> mPoints;
+    std::vector<int> mContourEnds;
+    std::vector<uint8_t> mContourClosed;
+    // Cumulative arc length at each point, restarting from 0 for every contour
+    std::vector<float> mDistances;
+    std::vector<float> mLengths;
+    int mPointCount = 0;
+    int mContourCount = 0;
+    Bounds mBounds;
+    ConicConverter mConverter;
+};
+
+#endif //PATH_PATH_MEASURE_H
@@ -0,0 +1,41 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PathSnapshot.h"
+
+void PathSnapshot::capture(const PathData& data) noexcept {
+    mPoints = data.points;
+    mConicWeights = data.conicWeights;
+    mPointCount = data.pointCount;
+    mVerbCount = data.verbCount;
+    mConicWeightCount = data.conicWeightCount;
+
+    if (data.forwardVerbs) {
+        mVerbs = data.verbs;
+        return;
+    }
+
+    if (mStorage.size() < size_t(mVerbCount)) {
+        mStorage.resize(mVerbCount);
+    }
+
+    const Verb* src = data.verbs;
+    Verb* dst = mStorage.data();
+    for (int i = 0; i < mVerbCount; i++) {
+        dst[i] = *--src;
+    }
+    mVerbs = dst;
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PATH_PATH_SNAPSHOT_H
+#define PATH_PATH_SNAPSHOT_H
+
+#include "Path.h"
+
+#include <vector>
+
+// Exposes the raw arrays of a path with verbs in forward order. Points and conic weights
+// always alias the path's own storage. Verbs alias it as well when the PathRef stores them
+// forward, otherwise they are copied in reverse order into storage owned by the snapshot
+// and reused across captures. A snapshot is only valid until the captured path is modified.
+class PathSnapshot {
+public:
+    PathSnapshot() noexcept { }
+
+    void capture(const PathData& data) noexcept;
+
+    const Point* points() const noexcept { return mPoints; }
+    const Verb* verbs() const noexcept { return mVerbs; }
+    const float* conicWeights() const noexcept { return mConicWeights; }
+
+    int pointCount() const noexcept { return mPointCount; }
+    int verbCount() const noexcept { return mVerbCount; }
+    int conicWeightCount() const noexcept { return mConicWeightCount; }
+
+private:
+    const Point* mPoints = nullptr;
+    const Verb* mVerbs = nullptr;
+    const float* mConicWeights = nullptr;
+    int mPointCount = 0;
+    int mVerbCount = 0;
+    int mConicWeightCount = 0;
+    std::vector<Verb> mStorage;
+};
+
+#endif //PATH_PATH_SNAPSHOT_H
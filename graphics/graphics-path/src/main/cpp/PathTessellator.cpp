@@ -0,0 +1,268 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PathTessellator.h"
+
+#include "Geometry.h"
+
+#include <cmath>
+
+using namespace filament::math;
+
+constexpr float kPi = 3.14159265358979323846f;
+
+static inline float cross(float2 a, float2 b) noexcept {
+    return a.x * b.y - a.y * b.x;
+}
+
+// Vector rotated by 90 degrees, from the x axis towards the y axis
+static inline float2 perpendicular(float2 v) noexcept {
+    return { -v.y, v.x };
+}
+
+static inline uint32_t addVertex(std::vector<Point>& vertices, float2 p) noexcept {
+    vertices.push_back(toPoint(p));
+    return uint32_t(vertices.size() - 1);
+}
+
+static inline void addTriangle(
+        std::vector<uint32_t>& indices, uint32_t a, uint32_t b, uint32_t c
+) noexcept {
+    indices.push_back(a);
+    indices.push_back(b);
+    indices.push_back(c);
+}
+
+// Number of line segments required to approximate an arc within tolerance
+static int arcStepCount(float angle, float radius, float tolerance) noexcept {
+    if (radius <= tolerance) return 1;
+    const float step = 2.0f * std::acos(1.0f - tolerance / radius);
+    const float steps = std::ceil(std::abs(angle) / step);
+    if (!(steps >= 1.0f)) return 1;
+    return steps < float(kMaxCurveSteps) ? int(steps) : kMaxCurveSteps;
+}
+
+// Adds a triangle fan covering the arc of the given angle around center, starting at
+// center + start
+static void addArc(
+        std::vector<Point>& vertices, std::vector<uint32_t>& indices,
+        float2 center, float2 start, float angle, float tolerance
+) noexcept {
+    const int steps = arcStepCount(angle, length(start), tolerance);
+    const float c = std::cos(angle / float(steps));
+    const float s = std::sin(angle / float(steps));
+
+    const uint32_t centerIndex = addVertex(vertices, center);
+    float2 v = start;
+    uint32_t previous = addVertex(vertices, center + v);
+    for (int i = 0; i < steps; i++) {
+        v = float2{ v.x * c - v.y * s, v.x * s + v.y * c };
+        const uint32_t current = addVertex(vertices, center + v);
+        addTriangle(indices, centerIndex, previous, current);
+        previous = current;
+    }
+}
+
+static void addQuad(
+        std::vector<Point>& vertices, std::vector<uint32_t>& indices,
+        float2 a, float2 b, float2 c, float2 d
+) noexcept {
+    const uint32_t i0 = addVertex(vertices, a);
+    const uint32_t i1 = addVertex(vertices, b);
+    const uint32_t i2 = addVertex(vertices, c);
+    const uint32_t i3 = addVertex(vertices, d);
+    addTriangle(indices, i0, i1, i2);
+    addTriangle(indices, i2, i1, i3);
+}
+
+// Fills the gap between two consecutive segments of directions d0 and d1 meeting at p
+static void addJoin(
+        std::vector<Point>& vertices, std::vector<uint32_t>& indices,
+        float2 p, float2 d0, float2 d1, float halfWidth,
+        const PathTessellator::StrokeStyle& style, float tolerance
+) noexcept {
+    const float turn = cross(d0, d1);
+    const float cosine = dot(d0, d1);
+    if (std::abs(turn) < 1e-6f && cosine > 0.0f) return;
+
+    // The gap is on the side opposite to the turn
+    const float side = turn > 0.0f ? -1.0f : 1.0f;
+    const float2 u0 = side * perpendicular(d0);
+    const float2 u1 = side * perpendicular(d1);
+
+    switch (style.join) {
+        case PathTessellator::Join::Miter: {
+            // Ratio between the miter length and the stroke width, 1 / sin(theta / 2) where
+            // theta is the angle between the segments
+            const float denominator = 1.0f + cosine;
+            if (denominator > 1e-6f && std::sqrt(2.0f / denominator) <= style.miterLimit) {
+                const float2 miter = p + (u0 + u1) * (halfWidth / denominator);
+                const uint32_t center = addVertex(vertices, p);
+                const uint32_t i0 = addVertex(vertices, p + u0 * halfWidth);
+                const uint32_t i1 = addVertex(vertices, miter);
+                const uint32_t i2 = addVertex(vertices, p + u1 * halfWidth);
+                addTriangle(indices, center, i0, i1);
+                addTriangle(indices, center, i1, i2);
+                return;
+            }
+            break;
+        }
+        case PathTessellator::Join::Round:
+            addArc(
+                    vertices, indices, p, u0 * halfWidth,
+                    std::atan2(cross(u0, u1), dot(u0, u1)), tolerance
+            );
+            return;
+        case PathTessellator::Join::Bevel:
+            break;
+    }
+
+    const uint32_t center = addVertex(vertices, p);
+    const uint32_t i0 = addVertex(vertices, p + u0 * halfWidth);
+    const uint32_t i1 = addVertex(vertices, p + u1 * halfWidth);
+    addTriangle(indices, center, i0, i1);
+}
+
+// Adds the cap at the extremity p of a contour, where d is the unit direction pointing
+// out of the contour
+static void addCap(
+        std::vector<Point>& vertices, std::vector<uint32_t>& indices,
+        float2 p, float2 d, float halfWidth,
+        const PathTessellator::StrokeStyle& style, float tolerance
+) noexcept {
+    const float2 n = perpendicular(d) * halfWidth;
+    switch (style.cap) {
+        case PathTessellator::Cap::Butt:
+            break;
+        case PathTessellator::Cap::Round:
+            addArc(vertices, indices, p, n, -kPi, tolerance);
+            break;
+        case PathTessellator::Cap::Square: {
+            const float2 e = d * halfWidth;
+            addQuad(vertices, indices, p + n, p - n, p + n + e, p - n + e);
+            break;
+        }
+    }
+}
+
+const void* PathTessellator::indices() const noexcept {
+    if (hasShortIndices()) return mShortIndices.data();
+    return mIndices.data();
+}
+
+void PathTessellator::fillPolylines() noexcept {
+    mVertices.clear();
+    mIndices.clear();
+
+    for (int contour = 0; contour < mContourCount; contour++) {
+        const int start = contour > 0 ? mContourEnds[contour - 1] : 0;
+        int end = mContourEnds[contour];
+
+        // Every contour is implicitly closed, drop the copy of the first point
+        if (end - start > 1 && mPoints[end - 1].x == mPoints[start].x &&
+                mPoints[end - 1].y == mPoints[start].y) {
+            end--;
+        }
+        if (end - start < 3) continue;
+
+        const uint32_t base = uint32_t(mVertices.size());
+        mVertices.insert(mVertices.end(), mPoints.begin() + start, mPoints.begin() + end);
+        for (int i = 1; i < end - start - 1; i++) {
+            addTriangle(mIndices, base, base + i, base + i + 1);
+        }
+    }
+}
+
+void PathTessellator::strokePolylines(const StrokeStyle& style, float tolerance) noexcept {
+    mVertices.clear();
+    mIndices.clear();
+    if (!(style.width > 0.0f)) return;
+
+    for (int contour = 0; contour < mContourCount; contour++) {
+        const int start = contour > 0 ? mContourEnds[contour - 1] : 0;
+        const int end = mContourEnds[contour];
+        strokeContour(
+                mPoints.data() + start, end - start, mContourClosed[contour] != 0,
+                style, tolerance
+        );
+    }
+}
+
+void PathTessellator::strokeContour(
+        const Point* points, int count, bool closed,
+        const StrokeStyle& style, float tolerance
+) noexcept {
+    const float halfWidth = style.width * 0.5f;
+
+    // Zero length lines do not define a direction, skip them
+    const Point* previous = points;
+    int first = -1;
+    float2 firstDirection;
+    float2 direction;
+    for (int i = 1; i < count; i++) {
+        const float2 p0 = fromPoint(*previous);
+        const float2 p1 = fromPoint(points[i]);
+        const float2 delta = p1 - p0;
+        const float distance = length(delta);
+        if (!(distance > 0.0f)) continue;
+
+        const float2 d = delta / distance;
+        const float2 n = perpendicular(d) * halfWidth;
+        addQuad(mVertices, mIndices, p0 + n, p0 - n, p1 + n, p1 - n);
+
+        if (first < 0) {
+            first = i;
+            firstDirection = d;
+        } else {
+            addJoin(mVertices, mIndices, p0, direction, d, halfWidth, style, tolerance);
+        }
+        direction = d;
+        previous = points + i;
+    }
+
+    if (first < 0) {
+        // Zero length contour, only caps are visible, as a dot centered on the contour
+        if (closed || count < 2) return;
+        const float2 p = fromPoint(points[0]);
+        if (style.cap == Cap::Round) {
+            addArc(mVertices, mIndices, p, float2{ halfWidth, 0.0f }, 2.0f * kPi, tolerance);
+        } else if (style.cap == Cap::Square) {
+            const float2 x = { halfWidth, 0.0f };
+            const float2 y = { 0.0f, halfWidth };
+            addQuad(mVertices, mIndices, p - x - y, p + x - y, p - x + y, p + x + y);
+        }
+        return;
+    }
+
+    if (closed) {
+        // The flattener already added the closing line, join it with the first line
+        const float2 p = fromPoint(points[first - 1]);
+        addJoin(mVertices, mIndices, p, direction, firstDirection, halfWidth, style, tolerance);
+    } else {
+        addCap(mVertices, mIndices, fromPoint(points[first - 1]), -firstDirection,
+                halfWidth, style, tolerance);
+        addCap(mVertices, mIndices, fromPoint(*previous), direction,
+                halfWidth, style, tolerance);
+    }
+}
+
+void PathTessellator::finishIndices() noexcept {
+    if (!hasShortIndices()) return;
+    mShortIndices.resize(mIndices.size());
+    for (size_t i = 0; i < mIndices.size(); i++) {
+        mShortIndices[i] = uint16_t(mIndices[i]);
+    }
+}
@@ -0,0 +1,143 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PATH_PATH_TESSELLATOR_H
+#define PATH_PATH_TESSELLATOR_H
+
+#include "Path.h"
+#include "PathFlattener.h"
+
+#include <stdint.h>
+
+#include <vector>
+
+// Converts paths into triangles ready to be uploaded to the GPU: a vertex buffer of (x, y)
+// float pairs and an index buffer with 3 indices per triangle. Indices are 16-bit when
+// there are at most 65536 vertices, 32-bit otherwise. All the storage is reused across
+// calls, tessellating a path of similar size as the previous one does not allocate.
+//
+// Fills are tessellated as one triangle fan per contour. The triangles of a fan overlap
+// where a contour is concave, they are meant to be drawn in the stencil buffer with the
+// desired fill rule (increment/decrement for non-zero, invert for even-odd) before
+// covering the path's bounds. Convex contours can be drawn directly.
+//
+// Strokes are tessellated as one quad per line segment plus triangles for the joins and
+// caps. Triangles overlap at joins, translucent strokes should also go through the
+// stencil buffer to avoid blending the same pixel twice.
+class PathTessellator {
+public:
+    // Same order as android.graphics.Paint.Cap
+    enum class Cap : uint8_t {
+        Butt,
+        Round,
+        Square
+    };
+
+    // Same order as android.graphics.Paint.Join
+    enum class Join : uint8_t {
+        Miter,
+        Round,
+        Bevel
+    };
+
+    struct StrokeStyle {
+        float width = 1.0f;
+        Cap cap = Cap::Butt;
+        Join join = Join::Miter;
+        float miterLimit = 4.0f;
+    };
+
+    PathTessellator() noexcept { }
+
+    // Tessellates the fill of the segments produced by source, a callable invoked with a
+    // callable add(Verb verb, const Point points[4], float weight) that must be called
+    // once per segment, in iteration order. source may be invoked more than once.
+    template<typename Source>
+    void fill(Source&& source, float tolerance) noexcept {
+        flatten(source, tolerance);
+        fillPolylines();
+        finishIndices();
+    }
+
+    // Same as fill() but tessellates the stroke of the segments
+    template<typename Source>
+    void stroke(Source&& source, float tolerance, const StrokeStyle& style) noexcept {
+        flatten(source, tolerance);
+        strokePolylines(style, tolerance);
+        finishIndices();
+    }
+
+    const Point* vertices() const noexcept { return mVertices.data(); }
+    int vertexCount() const noexcept { return int(mVertices.size()); }
+
+    // Either uint16_t or uint32_t indices, see indexSize()
+    const void* indices() const noexcept;
+    int indexCount() const noexcept { return int(mIndices.size()); }
+    int indexSize() const noexcept { return hasShortIndices() ? 2 : 4; }
+
+private:
+    template<typename Source>
+    void flatten(Source&& source, float tolerance) noexcept {
+        for (;;) {
+            PathFlattener flattener(
+                    mPoints.data(), int(mPoints.size()),
+                    mContourEnds.data(), int(mContourEnds.size()),
+                    tolerance
+            );
+            flattener.setContourClosedFlags(mContourClosed.data());
+
+            source([&](Verb verb, const Point points[4], float weight) {
+                flattener.add(verb, points, weight);
+            });
+            flattener.finish();
+
+            if (flattener.isComplete()) {
+                mPointCount = flattener.pointCount();
+                mContourCount = flattener.contourCount();
+                break;
+            }
+
+            // Grow the storage to the size reported by the flattener and try again
+            mPoints.resize(flattener.pointCount());
+            mContourEnds.resize(flattener.contourCount());
+            mContourClosed.resize(flattener.contourCount());
+        }
+    }
+
+    bool hasShortIndices() const noexcept { return mVertices.size() <= 65536; }
+
+    void fillPolylines() noexcept;
+    void strokePolylines(const StrokeStyle& style, float tolerance) noexcept;
+    void strokeContour(
+            const Point* points, int count, bool closed,
+            const StrokeStyle& style, float tolerance
+    ) noexcept;
+    void finishIndices() noexcept;
+
+    // Polylines produced by the flattener
+    std::vector<Point> mPoints;
+    std::vector<int> mContourEnds;
+    std::vector<uint8_t> mContourClosed;
+    int mPointCount = 0;
+    int mContourCount = 0;
+
+    // Triangles
+    std::vector<Point> mVertices;
+    std::vector<uint32_t> mIndices;
+    std::vector<uint16_t> mShortIndices;
+};
+
+#endif //PATH_PATH_TESSELLATOR_H
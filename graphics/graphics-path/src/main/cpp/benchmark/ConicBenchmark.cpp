@@ -0,0 +1,122 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Host micro-benchmark comparing the scalar, one conic at a time conversion with the
+// batched conicToQuadratics(). Both must produce the same number of quadratics per conic, and
+// the same points within kPointTolerance: the two evaluate the same expressions in a different
+// order, so with -ffast-math and fused multiply-adds (as in device builds) the points differ in
+// their last bits. Build with the host configuration of CMakeLists.txt.
+
+#include "../Conic.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+constexpr int kConicCount = 4096;
+constexpr int kIterations = 200;
+// Largest difference allowed between a scalar and a batched coordinate, coordinates are < 1500
+constexpr float kPointTolerance = 1e-3f;
+
+int main() {
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> coordinates(0.0f, 1024.0f);
+    std::uniform_real_distribution<float> radii(2.0f, 128.0f);
+    std::uniform_real_distribution<float> weights(0.2f, 2.0f);
+
+    std::vector<Point> conics(kConicCount * 3);
+    std::vector<float> conicWeights(kConicCount);
+    for (int i = 0; i < kConicCount; i++) {
+        Point* conic = &conics[i * 3];
+        if (i % 4 != 0) {
+            // Rounded rect and oval corners: quarter circles with a weight of sqrt(2)/2
+            float r = radii(random);
+            Point corner = { .x = coordinates(random), .y = coordinates(random) };
+            conic[0] = { .x = corner.x, .y = corner.y + r };
+            conic[1] = corner;
+            conic[2] = { .x = corner.x + r, .y = corner.y };
+            conicWeights[i] = 0.70710677f;
+        } else {
+            Point origin = { .x = coordinates(random), .y = coordinates(random) };
+            for (int j = 0; j < 3; j++) {
+                conic[j] = { .x = origin.x + radii(random), .y = origin.y + radii(random) };
+            }
+            conicWeights[i] = weights(random);
+        }
+    }
+
+    for (float tolerance : { 0.25f, 0.01f }) {
+        std::vector<Point> scalarPoints(kConicCount * 65);
+        std::vector<Point> batchPoints(kConicCount * 65);
+        std::vector<int> counts(kConicCount);
+
+        int scalarSize = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int n = 0; n < kIterations; n++) {
+            Point* dst = scalarPoints.data();
+            for (int i = 0; i < kConicCount; i++) {
+                int count = conicToQuadratics(&conics[i * 3], dst, 32, conicWeights[i], tolerance);
+                dst += 1 + 2 * count;
+            }
+            scalarSize = int(dst - scalarPoints.data());
+        }
+        auto scalarTime = std::chrono::steady_clock::now() - start;
+
+        int batchSize = 0;
+        start = std::chrono::steady_clock::now();
+        for (int n = 0; n < kIterations; n++) {
+            batchSize = conicToQuadratics(
+                    conics.data(), conicWeights.data(), kConicCount,
+                    batchPoints.data(), counts.data(), int(batchPoints.size()), tolerance
+            );
+        }
+        auto batchTime = std::chrono::steady_clock::now() - start;
+
+        if (scalarSize != batchSize) {
+            printf("Size mismatch: scalar=%d batch=%d\n", scalarSize, batchSize);
+            return 1;
+        }
+        for (int i = 0; i < kConicCount; i++) {
+            Point quadratics[65];
+            int count = conicToQuadratics(
+                    &conics[i * 3], quadratics, 32, conicWeights[i], tolerance);
+            if (count != counts[i]) {
+                printf("Conic %d count mismatch: scalar=%d batch=%d\n", i, count, counts[i]);
+                return 1;
+            }
+        }
+        for (int i = 0; i < scalarSize; i++) {
+            const Point& a = scalarPoints[i];
+            const Point& b = batchPoints[i];
+            if (std::abs(a.x - b.x) > kPointTolerance || std::abs(a.y - b.y) > kPointTolerance) {
+                printf("Point %d mismatch: (%f, %f) != (%f, %f)\n", i, a.x, a.y, b.x, b.y);
+                return 1;
+            }
+        }
+
+        double conversions = double(kConicCount) * kIterations;
+        double scalarNs = std::chrono::duration<double, std::nano>(scalarTime).count();
+        double batchNs = std::chrono::duration<double, std::nano>(batchTime).count();
+        printf("tolerance %.2f, %d points per pass\n", tolerance, scalarSize);
+        printf("  scalar: %8.2f ns/conic\n", scalarNs / conversions);
+        printf("  batch:  %8.2f ns/conic (%.2fx)\n", batchNs / conversions, scalarNs / batchNs);
+    }
+
+    return 0;
+}
@@ -0,0 +1,302 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Host benchmark of the path iteration hot loops: PathIterator::next(), one segment at a
+// time and batched, PathIterator::count() and the batched conicToQuadratics(). Paths are
+// synthetic PathRef30 fixtures with different verb mixes. Each benchmark reports the time
+// per produced segment and the number of heap allocations per pass. Build with the host
+// configuration of CMakeLists.txt; an optional argument scales the number of passes.
+
+#include "../Conic.h"
+#include "../Path.h"
+#include "../PathIterator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <vector>
+
+static size_t sAllocationCount = 0;
+
+void* operator new(size_t size) {
+    sAllocationCount++;
+    void* p = malloc(size == 0 ? 1 : size);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
+constexpr int kSegmentCount = 8192;
+constexpr int kContourLength = 16;
+constexpr int kBatchSize = 64;
+
+enum class Mix {
+    LineHeavy,
+    CubicHeavy,
+    ConicHeavy
+};
+
+static const char* mixName(Mix mix) {
+    switch (mix) {
+        case Mix::LineHeavy: return "line-heavy";
+        case Mix::CubicHeavy: return "cubic-heavy";
+        case Mix::ConicHeavy: return "conic-heavy";
+    }
+    return "";
+}
+
+// Owns the arrays referenced by a PathRef30, laid out like the platform's: verbs stored
+// forward, points shared between consecutive segments
+struct Fixture {
+    std::vector<Point> points;
+    std::vector<Verb> verbs;
+    std::vector<float> conicWeights;
+    PathRef30 ref{};
+    Path path{};
+
+    Fixture(Mix mix, uint32_t seed) {
+        std::mt19937 random(seed);
+        std::uniform_real_distribution<float> coordinates(0.0f, 1024.0f);
+        std::uniform_real_distribution<float> offsets(-64.0f, 64.0f);
+        std::uniform_int_distribution<int> percent(0, 99);
+
+        auto near = [&](const Point& p) {
+            return Point{ .x = p.x + offsets(random), .y = p.y + offsets(random) };
+        };
+
+        Point last{};
+        for (int i = 0; i < kSegmentCount; i++) {
+            if (i % kContourLength == 0) {
+                if (i > 0) verbs.push_back(Verb::Close);
+                last = { .x = coordinates(random), .y = coordinates(random) };
+                verbs.push_back(Verb::Move);
+                points.push_back(last);
+                continue;
+            }
+
+            // Each mix is 80% of its dominant verb, the rest is split between the others
+            const int p = percent(random);
+            Verb verb = Verb::Done;
+            switch (mix) {
+                case Mix::LineHeavy:
+                    verb = p < 80 ? Verb::Line : p < 90 ? Verb::Cubic : Verb::Conic;
+                    break;
+                case Mix::CubicHeavy:
+                    verb = p < 80 ? Verb::Cubic : p < 90 ? Verb::Line : Verb::Conic;
+                    break;
+                case Mix::ConicHeavy:
+                    verb = p < 80 ? Verb::Conic : p < 90 ? Verb::Line : Verb::Cubic;
+                    break;
+            }
+
+            verbs.push_back(verb);
+            switch (verb) {
+                case Verb::Line:
+                    last = near(last);
+                    points.push_back(last);
+                    break;
+                case Verb::Conic: {
+                    // Quarter circles, as found in rounded rects and ovals
+                    const float r = std::abs(offsets(random)) + 2.0f;
+                    points.push_back({ .x = last.x + r, .y = last.y });
+                    last = { .x = last.x + r, .y = last.y + r };
+                    points.push_back(last);
+                    conicWeights.push_back(0.70710677f);
+                    break;
+                }
+                case Verb::Cubic:
+                    points.push_back(near(last));
+                    points.push_back(near(last));
+                    last = near(last);
+                    points.push_back(last);
+                    break;
+                default:
+                    break;
+            }
+        }
+        verbs.push_back(Verb::Close);
+
+        ref.points = points.data();
+        ref.pointCount = int(points.size());
+        ref.verbs = verbs.data();
+        ref.verbCount = int(verbs.size());
+        ref.conicWeights = conicWeights.data();
+        ref.conicWeightsCount = int(conicWeights.size());
+        path.pathRef = reinterpret_cast<PathRef21*>(&ref);
+    }
+
+    // Reads the fixture back through Path, as pathway.cpp does on API 30+
+    PathIterator iterator(PathIterator::ConicEvaluation conicEvaluation) const {
+        auto* r = reinterpret_cast<PathRef30*>(path.pathRef);
+        return PathIterator(
+                r->points, r->verbs, r->conicWeights, r->verbCount, r->conicWeightsCount,
+                PathIterator::VerbDirection::Forward, conicEvaluation
+        );
+    }
+
+    // Restarts a pooled iterator over the fixture, as PathIteratorPool::acquire() does
+    void reset(PathIterator& iterator, PathIterator::ConicEvaluation conicEvaluation) const {
+        auto* r = reinterpret_cast<PathRef30*>(path.pathRef);
+        iterator.reset(
+                r->points, r->verbs, r->conicWeights, r->verbCount, r->conicWeightsCount,
+                PathIterator::VerbDirection::Forward, conicEvaluation
+        );
+    }
+};
+
+struct Result {
+    double nsPerSegment;
+    double allocationsPerPass;
+};
+
+// Runs function passes times; function returns the number of segments it produced
+template<typename F>
+static Result measure(int passes, int* segments, F&& function) {
+    const size_t allocations = sAllocationCount;
+    const auto start = std::chrono::steady_clock::now();
+    long total = 0;
+    for (int i = 0; i < passes; i++) {
+        *segments = function();
+        total += *segments;
+    }
+    const auto time = std::chrono::steady_clock::now() - start;
+    return {
+        .nsPerSegment = std::chrono::duration<double, std::nano>(time).count() / double(total),
+        .allocationsPerPass = double(sAllocationCount - allocations) / double(passes)
+    };
+}
+
+static void report(const char* name, const Result& result) {
+    printf("  %-28s %8.2f ns/segment %8.1f allocations/pass\n",
+            name, result.nsPerSegment, result.allocationsPerPass);
+}
+
+int main(int argc, char* argv[]) {
+    const int scale = argc > 1 ? std::max(1, atoi(argv[1])) : 1; // NOLINT(cert-err34-c)
+    const int passes = 100 * scale;
+    int status = 0;
+
+    for (Mix mix : { Mix::LineHeavy, Mix::CubicHeavy, Mix::ConicHeavy }) {
+        const Fixture fixture(mix, 42);
+        printf("%s: %d verbs, %d points, %d conics\n", mixName(mix),
+                fixture.ref.verbCount, fixture.ref.pointCount, fixture.ref.conicWeightsCount);
+
+        int rawCount = 0;
+        report("next() as conics", measure(passes, &rawCount, [&]() {
+            PathIterator iterator = fixture.iterator(PathIterator::ConicEvaluation::AsConic);
+            Point points[4];
+            int count = 0;
+            while (iterator.next(points) != Verb::Done) count++;
+            return count;
+        }));
+
+        int iteratedCount = 0;
+        report("next() as quadratics", measure(passes, &iteratedCount, [&]() {
+            PathIterator iterator = fixture.iterator(PathIterator::ConicEvaluation::AsQuadratics);
+            Point points[4];
+            int count = 0;
+            while (iterator.next(points) != Verb::Done) count++;
+            return count;
+        }));
+
+        int batchCount = 0;
+        report("next() batched", measure(passes, &batchCount, [&]() {
+            PathIterator iterator = fixture.iterator(PathIterator::ConicEvaluation::AsQuadratics);
+            Verb verbs[kBatchSize];
+            Point points[kBatchSize * 4];
+            int count = 0;
+            int written;
+            do {
+                written = iterator.next(verbs, points, kBatchSize);
+                count += written;
+            } while (written == kBatchSize);
+            return count;
+        }));
+
+        int countedCount = 0;
+        report("count()", measure(passes, &countedCount, [&]() {
+            PathIterator iterator = fixture.iterator(PathIterator::ConicEvaluation::AsQuadratics);
+            return iterator.count();
+        }));
+
+        // A pooled iterator keeps the storage of the subdivision counts across reset()
+        PathIterator pooled = fixture.iterator(PathIterator::ConicEvaluation::AsQuadratics);
+        pooled.count();
+        int pooledCount = 0;
+        report("count() pooled", measure(passes, &pooledCount, [&]() {
+            fixture.reset(pooled, PathIterator::ConicEvaluation::AsQuadratics);
+            return pooled.count();
+        }));
+
+        // next() reuses the conic subdivisions computed by count()
+        int countedIteratedCount = 0;
+        report("count() then next()", measure(passes, &countedIteratedCount, [&]() {
+            PathIterator iterator = fixture.iterator(PathIterator::ConicEvaluation::AsQuadratics);
+            const int count = iterator.count();
+            Point points[4];
+            int iterated = 0;
+            while (iterator.next(points) != Verb::Done) iterated++;
+            return iterated == count ? iterated : -1;
+        }));
+
+        // Every conic of the fixture, as consecutive triplets of points
+        std::vector<Point> conics;
+        {
+            PathIterator iterator = fixture.iterator(PathIterator::ConicEvaluation::AsConic);
+            Point points[4];
+            Verb verb = Verb::Done;
+            while ((verb = iterator.next(points)) != Verb::Done) {
+                if (verb == Verb::Conic) conics.insert(conics.end(), points, points + 3);
+            }
+        }
+        const int conicCount = fixture.ref.conicWeightsCount;
+        std::vector<Point> quadratics(conicCount * 65);
+        std::vector<int> quadraticCounts(conicCount);
+        int convertedCount = 0;
+        report("conicToQuadratics() batched", measure(passes, &convertedCount, [&]() {
+            conicToQuadratics(
+                    conics.data(), fixture.conicWeights.data(), conicCount,
+                    quadratics.data(), quadraticCounts.data(), int(quadratics.size()), 0.25f
+            );
+            int count = 0;
+            for (int i = 0; i < conicCount; i++) count += quadraticCounts[i];
+            return count > 0 ? count : 1;
+        }));
+
+        if (rawCount != fixture.ref.verbCount ||
+                batchCount != iteratedCount ||
+                countedCount != iteratedCount ||
+                pooledCount != iteratedCount ||
+                countedIteratedCount != iteratedCount) {
+            printf("  Count mismatch: raw=%d iterated=%d batched=%d counted=%d/%d\n",
+                    rawCount, iteratedCount, batchCount, countedCount, countedIteratedCount);
+            status = 1;
+        }
+    }
+
+    return status;
+}
@@ -14,16 +14,26 @@
  * limitations under the License.
  */
 
+#include "PathCache.h"
+#include "PathFlattener.h"
+#include "PathHash.h"
 #include "PathIterator.h"
+#include "PathIteratorPool.h"
+#include "PathMeasure.h"
+#include "PathSnapshot.h"
+#include "PathTessellator.h"
 
 #include <jni.h>
 
 #include <sys/system_properties.h>
 
-#include <mutex>
-
 #define JNI_CLASS_NAME "androidx/graphics/path/PathIteratorPreApi34Impl"
 #define JNI_CLASS_NAME_CONVERTER "androidx/graphics/path/ConicConverter"
+#define JNI_CLASS_NAME_SNAPSHOT "androidx/graphics/path/PathSnapshot"
+#define JNI_CLASS_NAME_FLATTENER "androidx/graphics/path/PathFlattener"
+#define JNI_CLASS_NAME_MEASURE "androidx/graphics/path/PathMeasure"
+#define JNI_CLASS_NAME_CACHE "androidx/graphics/path/PathCache"
+#define JNI_CLASS_NAME_TESSELLATOR "androidx/graphics/path/PathTessellator"
 
 #if !defined(NDEBUG)
 #include <android/log.h>
@@ -36,69 +46,90 @@ struct {
     jfieldID nativePath;
 } sPath{};
 
-uint32_t sApiLevel = 0;
-std::once_flag sApiLevelOnceFlag;
-
 static uint32_t api_level() {
-    std::call_once(sApiLevelOnceFlag, []() {
-        char sdkVersion[PROP_VALUE_MAX];
-        __system_property_get("ro.build.version.sdk", sdkVersion);
-        sApiLevel = atoi(sdkVersion); // NOLINT(cert-err34-c)
-    });
-    return sApiLevel;
+    char sdkVersion[PROP_VALUE_MAX];
+    __system_property_get("ro.build.version.sdk", sdkVersion);
+    return atoi(sdkVersion); // NOLINT(cert-err34-c)
 }
 
-static jlong createPathIterator(JNIEnv* env, jobject,
-        jobject path_, jint conicEvaluation_, jfloat tolerance_) {
+template<typename T, bool ForwardVerbs>
+static PathData readPathRef(const Path* path) {
+    auto* ref = reinterpret_cast<T*>(path->pathRef);
+    return {
+        .points = ref->points,
+        .verbs = ref->verbs,
+        .conicWeights = ref->conicWeights,
+        .verbCount = ref->verbCount,
+        .pointCount = ref->pointCount,
+        .conicWeightCount = ref->conicWeightsCount,
+        .forwardVerbs = ForwardVerbs
+    };
+}
+
+using PathRefReader = PathData (*)(const Path*);
+
+// The PathRef layout only depends on the API level, the matching reader is resolved once
+// in JNI_OnLoad so that reading a path does not need to query or test the API level
+static PathRefReader sReadPathRef = nullptr;
 
+static PathRefReader resolvePathRefReader(uint32_t apiLevel) {
+    if (apiLevel >= 30) return readPathRef<PathRef30, true>;
+    if (apiLevel >= 26) return readPathRef<PathRef26, false>;
+    if (apiLevel >= 24) return readPathRef<PathRef24, false>;
+    return readPathRef<PathRef21, false>;
+}
+
+static PathData readPathData(JNIEnv* env, jobject path_) {
     auto nativePath = static_cast<intptr_t>(env->GetLongField(path_, sPath.nativePath));
-    auto* path = reinterpret_cast<Path*>(nativePath);
-
-    Point* points;
-    Verb* verbs;
-    float* conicWeights;
-    int count;
-    PathIterator::VerbDirection direction;
-
-    const uint32_t apiLevel = api_level();
-    if (apiLevel >= 30) {
-        auto* ref = reinterpret_cast<PathRef30*>(path->pathRef);
-        points = ref->points;
-        verbs = ref->verbs;
-        conicWeights = ref->conicWeights;
-        count = ref->verbCount;
-        direction = PathIterator::VerbDirection::Forward;
-    } else if (apiLevel >= 26) {
-        auto* ref = reinterpret_cast<PathRef26*>(path->pathRef);
-        points = ref->points;
-        verbs = ref->verbs;
-        conicWeights = ref->conicWeights;
-        count = ref->verbCount;
-        direction = PathIterator::VerbDirection::Backward;
-    } else if (apiLevel >= 24) {
-        auto* ref = reinterpret_cast<PathRef24*>(path->pathRef);
-        points = ref->points;
-        verbs = ref->verbs;
-        conicWeights = ref->conicWeights;
-        count = ref->verbCount;
-        direction = PathIterator::VerbDirection::Backward;
-    } else {
-        auto* ref = path->pathRef;
-        points = ref->points;
-        verbs = ref->verbs;
-        conicWeights = ref->conicWeights;
-        count = ref->verbCount;
-        direction = PathIterator::VerbDirection::Backward;
+    return sReadPathRef(reinterpret_cast<Path*>(nativePath));
+}
+
+static PathIteratorPool sPathIteratorPool;
+
+// Pins a primitive array with GetPrimitiveArrayCritical until the end of the scope, where it is
+// released with the given mode. Pinning can fail, in which case data() is null, an exception is
+// pending and the arrays pinned before must be released without being accessed. Pins of the same
+// scope are released in the reverse order of their acquisition.
+template<typename T>
+class CriticalArray {
+public:
+    CriticalArray(JNIEnv* env, jarray array, jint releaseMode) noexcept
+            : mEnv(env), mArray(array), mReleaseMode(releaseMode),
+              mData(static_cast<T*>(env->GetPrimitiveArrayCritical(array, nullptr))) { }
+
+    ~CriticalArray() noexcept {
+        if (mData != nullptr) mEnv->ReleasePrimitiveArrayCritical(mArray, mData, mReleaseMode);
     }
 
-    return jlong(new PathIterator(
-            points, verbs, conicWeights, count, direction,
-            PathIterator::ConicEvaluation(conicEvaluation_), tolerance_
+    CriticalArray(const CriticalArray&) = delete;
+    CriticalArray& operator=(const CriticalArray&) = delete;
+
+    T* data() const noexcept { return mData; }
+
+private:
+    JNIEnv* mEnv;
+    jarray mArray;
+    jint mReleaseMode;
+    T* mData;
+};
+
+static PathIterator::VerbDirection verbDirection(const PathData& data) {
+    return data.forwardVerbs ?
+            PathIterator::VerbDirection::Forward : PathIterator::VerbDirection::Backward;
+}
+
+static jlong createPathIterator(JNIEnv* env, jobject,
+        jobject path_, jint conicEvaluation_, jfloat tolerance_) {
+    PathData data = readPathData(env, path_);
+
+    return jlong(sPathIteratorPool.acquire(
+            data.points, data.verbs, data.conicWeights, data.verbCount, data.conicWeightCount,
+            verbDirection(data), PathIterator::ConicEvaluation(conicEvaluation_), tolerance_
     ));
 }
 
 static void destroyPathIterator(JNIEnv*, jobject, jlong pathIterator_) {
-    delete reinterpret_cast<PathIterator*>(pathIterator_);
+    sPathIteratorPool.release(reinterpret_cast<PathIterator*>(pathIterator_));
 }
 
 static jboolean pathIteratorHasNext(JNIEnv*, jobject, jlong pathIterator_) {
@@ -137,6 +168,24 @@ static jint pathIteratorNext(JNIEnv* env, jobject,
     return static_cast<jint>(verb);
 }
 
+static jint pathIteratorNextBatch(JNIEnv* env, jobject,
+                                  jlong pathIterator_, jbyteArray verbs_, jfloatArray points_,
+                                  jint offset_, jint count_) {
+    auto pathIterator = reinterpret_cast<PathIterator*>(pathIterator_);
+
+    // Both arrays are pinned for the whole batch; no JNI call happens while they are held
+    CriticalArray<jbyte> verbsData(env, verbs_, 0);
+    if (verbsData.data() == nullptr) return 0;
+    CriticalArray<jfloat> floatsData(env, points_, 0);
+    if (floatsData.data() == nullptr) return 0;
+
+    return pathIterator->next(
+            reinterpret_cast<Verb*>(verbsData.data()),
+            reinterpret_cast<Point*>(floatsData.data() + offset_),
+            count_
+    );
+}
+
 static jint pathIteratorPeek(JNIEnv*, jobject, jlong pathIterator_) {
     return static_cast<jint>(reinterpret_cast<PathIterator *>(pathIterator_)->peek());
 }
@@ -149,6 +198,424 @@ static jint pathIteratorSize(JNIEnv*, jobject, jlong pathIterator_) {
     return static_cast<jint>(reinterpret_cast<PathIterator *>(pathIterator_)->count());
 }
 
+static jlong createPathSnapshot(JNIEnv*, jobject) {
+    return jlong(new PathSnapshot());
+}
+
+static void destroyPathSnapshot(JNIEnv*, jobject, jlong pathSnapshot_) {
+    delete reinterpret_cast<PathSnapshot*>(pathSnapshot_);
+}
+
+static jint pathSnapshotCapture(JNIEnv* env, jobject, jlong pathSnapshot_, jobject path_) {
+    auto pathSnapshot = reinterpret_cast<PathSnapshot*>(pathSnapshot_);
+    pathSnapshot->capture(readPathData(env, path_));
+    return pathSnapshot->verbCount();
+}
+
+static jobject newDirectBuffer(JNIEnv* env, const void* data, size_t size) {
+    // Empty arrays may not be allocated, but direct buffers require a valid address
+    static uint8_t sEmpty;
+    return env->NewDirectByteBuffer(size > 0 ? const_cast<void*>(data) : &sEmpty, jlong(size));
+}
+
+static jobject pathSnapshotVerbs(JNIEnv* env, jobject, jlong pathSnapshot_) {
+    auto pathSnapshot = reinterpret_cast<PathSnapshot*>(pathSnapshot_);
+    return newDirectBuffer(env, pathSnapshot->verbs(), pathSnapshot->verbCount() * sizeof(Verb));
+}
+
+static jobject pathSnapshotPoints(JNIEnv* env, jobject, jlong pathSnapshot_) {
+    auto pathSnapshot = reinterpret_cast<PathSnapshot*>(pathSnapshot_);
+    return newDirectBuffer(env, pathSnapshot->points(), pathSnapshot->pointCount() * sizeof(Point));
+}
+
+static jobject pathSnapshotConicWeights(JNIEnv* env, jobject, jlong pathSnapshot_) {
+    auto pathSnapshot = reinterpret_cast<PathSnapshot*>(pathSnapshot_);
+    return newDirectBuffer(
+            env, pathSnapshot->conicWeights(), pathSnapshot->conicWeightCount() * sizeof(float)
+    );
+}
+
+static jlong packCounts(int pointCount, int contourCount) {
+    return (jlong(pointCount) << 32) | jlong(uint32_t(contourCount));
+}
+
+static jlong packFlattenerCounts(const PathFlattener& flattener) {
+    return packCounts(flattener.pointCount(), flattener.contourCount());
+}
+
+static jlong flattenPath(JNIEnv* env, jobject,
+                         jobject path_, jfloat tolerance_,
+                         jfloatArray points_, jintArray contourEnds_) {
+    PathData data = readPathData(env, path_);
+    PathIterator iterator(
+            data.points, data.verbs, data.conicWeights, data.verbCount, data.conicWeightCount,
+            verbDirection(data), PathIterator::ConicEvaluation::AsQuadratics, tolerance_
+    );
+
+    const jsize pointCapacity = env->GetArrayLength(points_) / 2;
+    const jsize contourCapacity = env->GetArrayLength(contourEnds_);
+
+    CriticalArray<jfloat> points(env, points_, 0);
+    if (points.data() == nullptr) return 0;
+    CriticalArray<jint> contourEnds(env, contourEnds_, 0);
+    if (contourEnds.data() == nullptr) return 0;
+
+    PathFlattener flattener(
+            reinterpret_cast<Point*>(points.data()), pointCapacity,
+            contourEnds.data(), contourCapacity, tolerance_
+    );
+    flattener.flatten(iterator);
+
+    return packFlattenerCounts(flattener);
+}
+
+static jlong flattenSegments(JNIEnv* env, jobject,
+                             jbyteArray verbs_, jfloatArray segments_, jint count_,
+                             jfloat tolerance_,
+                             jfloatArray points_, jintArray contourEnds_) {
+    const jsize pointCapacity = env->GetArrayLength(points_) / 2;
+    const jsize contourCapacity = env->GetArrayLength(contourEnds_);
+
+    CriticalArray<jbyte> verbs(env, verbs_, JNI_ABORT);
+    if (verbs.data() == nullptr) return 0;
+    CriticalArray<jfloat> segments(env, segments_, JNI_ABORT);
+    if (segments.data() == nullptr) return 0;
+    CriticalArray<jfloat> points(env, points_, 0);
+    if (points.data() == nullptr) return 0;
+    CriticalArray<jint> contourEnds(env, contourEnds_, 0);
+    if (contourEnds.data() == nullptr) return 0;
+
+    PathFlattener flattener(
+            reinterpret_cast<Point*>(points.data()), pointCapacity,
+            contourEnds.data(), contourCapacity, tolerance_
+    );
+    auto* segmentPoints = reinterpret_cast<const Point*>(segments.data());
+    for (int i = 0; i < count_; i++) {
+        const Point* segment = segmentPoints + i * 4;
+        flattener.add(Verb(verbs.data()[i]), segment, segment[3].x);
+    }
+    flattener.finish();
+
+    return packFlattenerCounts(flattener);
+}
+
+// Feeds the segments of a path, with conics converted to quadratics, to a native consumer
+// taking a source callable (see PathMeasure and PathTessellator)
+static auto pathSource(JNIEnv* env, jobject path_, jfloat tolerance_) {
+    PathData data = readPathData(env, path_);
+    return [data, tolerance_](auto add) {
+        PathIterator iterator(
+                data.points, data.verbs, data.conicWeights, data.verbCount,
+                data.conicWeightCount, verbDirection(data),
+                PathIterator::ConicEvaluation::AsQuadratics, tolerance_
+        );
+        Point points[4];
+        while (iterator.hasNext()) {
+            Verb verb = iterator.next(points);
+            add(verb, points, points[3].x);
+        }
+    };
+}
+
+// Same as pathSource() for segments gathered from the platform iterator in API 34+, must
+// only be invoked while segments and verbs are pinned
+static auto segmentSource(const jbyte* verbs, const jfloat* segments, jint count_) {
+    return [verbs, segments, count_](auto add) {
+        auto* segmentPoints = reinterpret_cast<const Point*>(segments);
+        for (int i = 0; i < count_; i++) {
+            const Point* segment = segmentPoints + i * 4;
+            add(Verb(verbs[i]), segment, segment[3].x);
+        }
+    };
+}
+
+static jlong createPathMeasure(JNIEnv*, jobject) {
+    return jlong(new PathMeasure());
+}
+
+static void destroyPathMeasure(JNIEnv*, jobject, jlong pathMeasure_) {
+    delete reinterpret_cast<PathMeasure*>(pathMeasure_);
+}
+
+static jint pathMeasureSetPath(JNIEnv* env, jobject,
+                               jlong pathMeasure_, jobject path_, jfloat tolerance_) {
+    auto pathMeasure = reinterpret_cast<PathMeasure*>(pathMeasure_);
+    pathMeasure->setPath(pathSource(env, path_, tolerance_), tolerance_);
+
+    return pathMeasure->contourCount();
+}
+
+static jint pathMeasureSetSegments(JNIEnv* env, jobject,
+                                   jlong pathMeasure_, jbyteArray verbs_, jfloatArray segments_,
+                                   jint count_, jfloat tolerance_) {
+    auto pathMeasure = reinterpret_cast<PathMeasure*>(pathMeasure_);
+
+    {
+        CriticalArray<jbyte> verbs(env, verbs_, JNI_ABORT);
+        if (verbs.data() == nullptr) return 0;
+        CriticalArray<jfloat> segments(env, segments_, JNI_ABORT);
+        if (segments.data() == nullptr) return 0;
+
+        pathMeasure->setPath(segmentSource(verbs.data(), segments.data(), count_), tolerance_);
+    }
+
+    return pathMeasure->contourCount();
+}
+
+static jfloat pathMeasureLength(JNIEnv*, jobject, jlong pathMeasure_, jint contour_) {
+    return reinterpret_cast<PathMeasure*>(pathMeasure_)->length(contour_);
+}
+
+static jboolean pathMeasureIsClosed(JNIEnv*, jobject, jlong pathMeasure_, jint contour_) {
+    return reinterpret_cast<PathMeasure*>(pathMeasure_)->isClosed(contour_);
+}
+
+static void pathMeasureBounds(JNIEnv* env, jobject, jlong pathMeasure_, jfloatArray bounds_) {
+    const Bounds& bounds = reinterpret_cast<PathMeasure*>(pathMeasure_)->bounds();
+    if (bounds.isEmpty()) {
+        const jfloat empty[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        env->SetFloatArrayRegion(bounds_, 0, 4, empty);
+    } else {
+        env->SetFloatArrayRegion(bounds_, 0, 4, &bounds.left);
+    }
+}
+
+static jboolean pathMeasurePosTan(JNIEnv* env, jobject,
+                                  jlong pathMeasure_, jint contour_, jfloat distance_,
+                                  jfloatArray result_, jint offset_) {
+    Point posTan[2];
+    bool result = reinterpret_cast<PathMeasure*>(pathMeasure_)->getPosTan(
+            contour_, distance_, &posTan[0], &posTan[1]
+    );
+    env->SetFloatArrayRegion(result_, offset_, 4, reinterpret_cast<jfloat*>(posTan));
+    return result;
+}
+
+static jint pathMeasureSegment(JNIEnv* env, jobject,
+                               jlong pathMeasure_, jint contour_, jfloat start_, jfloat end_,
+                               jfloatArray points_) {
+    const jsize capacity = env->GetArrayLength(points_) / 2;
+    CriticalArray<jfloat> points(env, points_, 0);
+    if (points.data() == nullptr) return 0;
+
+    return reinterpret_cast<PathMeasure*>(pathMeasure_)->getSegment(
+            contour_, start_, end_, reinterpret_cast<Point*>(points.data()), capacity
+    );
+}
+
+// Pins the raw path data rebuilt from the platform iterator in API 34+ (see PathSnapshot)
+// and passes it to function as a forward PathData. Returns 0 if the data cannot be pinned.
+template<typename F>
+static jlong withPathData(JNIEnv* env,
+                          jbyteArray verbs_, jint verbCount_,
+                          jfloatArray points_, jint pointCount_,
+                          jfloatArray conicWeights_, jint conicWeightCount_,
+                          F&& function) {
+    CriticalArray<jbyte> verbs(env, verbs_, JNI_ABORT);
+    if (verbs.data() == nullptr) return 0;
+    CriticalArray<jfloat> points(env, points_, JNI_ABORT);
+    if (points.data() == nullptr) return 0;
+    CriticalArray<jfloat> weights(env, conicWeights_, JNI_ABORT);
+    if (weights.data() == nullptr) return 0;
+
+    return function(PathData {
+        .points = reinterpret_cast<Point*>(points.data()),
+        .verbs = reinterpret_cast<Verb*>(verbs.data()),
+        .conicWeights = weights.data(),
+        .verbCount = verbCount_,
+        .pointCount = pointCount_,
+        .conicWeightCount = conicWeightCount_,
+        .forwardVerbs = true
+    });
+}
+
+static jlong createPathCache(JNIEnv*, jobject, jint maxSize_) {
+    return jlong(new PathCache(size_t(maxSize_)));
+}
+
+static void destroyPathCache(JNIEnv*, jobject, jlong pathCache_) {
+    delete reinterpret_cast<PathCache*>(pathCache_);
+}
+
+static jlong pathCacheHash(JNIEnv* env, jobject, jobject path_) {
+    return jlong(hashPath(readPathData(env, path_)));
+}
+
+static jlong pathCacheHashData(JNIEnv* env, jobject,
+                               jbyteArray verbs_, jint verbCount_,
+                               jfloatArray points_, jint pointCount_,
+                               jfloatArray conicWeights_, jint conicWeightCount_) {
+    return withPathData(env,
+            verbs_, verbCount_, points_, pointCount_, conicWeights_, conicWeightCount_,
+            [](const PathData& data) { return jlong(hashPath(data)); }
+    );
+}
+
+static jlong pathCacheGet(JNIEnv* env, jobject, jlong pathCache_, jobject path_) {
+    auto pathCache = reinterpret_cast<PathCache*>(pathCache_);
+    return jlong(pathCache->get(readPathData(env, path_)));
+}
+
+static jlong pathCacheGetData(JNIEnv* env, jobject, jlong pathCache_,
+                              jbyteArray verbs_, jint verbCount_,
+                              jfloatArray points_, jint pointCount_,
+                              jfloatArray conicWeights_, jint conicWeightCount_) {
+    auto pathCache = reinterpret_cast<PathCache*>(pathCache_);
+    return withPathData(env,
+            verbs_, verbCount_, points_, pointCount_, conicWeights_, conicWeightCount_,
+            [pathCache](const PathData& data) { return jlong(pathCache->get(data)); }
+    );
+}
+
+static void pathCacheBounds(JNIEnv* env, jobject,
+                            jlong pathCache_, jlong entry_, jfloatArray bounds_) {
+    auto pathCache = reinterpret_cast<PathCache*>(pathCache_);
+    const Bounds& bounds = pathCache->bounds(reinterpret_cast<PathCache::Entry*>(entry_));
+    if (bounds.isEmpty()) {
+        const jfloat empty[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        env->SetFloatArrayRegion(bounds_, 0, 4, empty);
+    } else {
+        env->SetFloatArrayRegion(bounds_, 0, 4, &bounds.left);
+    }
+}
+
+// The quadratics and polylines of a cache entry are copied to the Java arrays, and only if
+// the arrays can hold all of them: the storage of an entry does not outlive the next call
+// to the cache. The returned counts let the caller grow the arrays and try again.
+static jint pathCacheQuadratics(JNIEnv* env, jobject,
+                                jlong pathCache_, jlong entry_, jfloat tolerance_,
+                                jbyteArray types_, jfloatArray points_) {
+    auto pathCache = reinterpret_cast<PathCache*>(pathCache_);
+    auto entry = reinterpret_cast<PathCache::Entry*>(entry_);
+    const PathCache::Quadratics& quadratics = pathCache->quadratics(entry, tolerance_);
+
+    const auto count = jsize(quadratics.verbs.size());
+    if (count <= env->GetArrayLength(types_) && count * 8 <= env->GetArrayLength(points_)) {
+        env->SetByteArrayRegion(
+                types_, 0, count, reinterpret_cast<const jbyte*>(quadratics.verbs.data())
+        );
+        env->SetFloatArrayRegion(points_, 0, count * 8, &quadratics.points.data()->x);
+    }
+    return count;
+}
+
+static jlong pathCachePolylines(JNIEnv* env, jobject,
+                                jlong pathCache_, jlong entry_, jfloat tolerance_,
+                                jfloatArray points_, jintArray contourEnds_) {
+    auto pathCache = reinterpret_cast<PathCache*>(pathCache_);
+    auto entry = reinterpret_cast<PathCache::Entry*>(entry_);
+    const PathCache::Polylines& polylines = pathCache->polylines(entry, tolerance_);
+
+    const int pointCount = polylines.pointCount;
+    const int contourCount = polylines.contourCount;
+    if (pointCount * 2 <= env->GetArrayLength(points_) &&
+            contourCount <= env->GetArrayLength(contourEnds_)) {
+        env->SetFloatArrayRegion(points_, 0, pointCount * 2, &polylines.points.data()->x);
+        env->SetIntArrayRegion(contourEnds_, 0, contourCount, polylines.contourEnds.data());
+    }
+    return packCounts(pointCount, contourCount);
+}
+
+static jint pathCacheSize(JNIEnv*, jobject, jlong pathCache_) {
+    return jint(reinterpret_cast<PathCache*>(pathCache_)->size());
+}
+
+static void pathCacheClear(JNIEnv*, jobject, jlong pathCache_) {
+    reinterpret_cast<PathCache*>(pathCache_)->clear();
+}
+
+static PathTessellator::StrokeStyle strokeStyle(
+        jfloat width_, jint cap_, jint join_, jfloat miterLimit_) {
+    return {
+        .width = width_,
+        .cap = PathTessellator::Cap(cap_),
+        .join = PathTessellator::Join(join_),
+        .miterLimit = miterLimit_
+    };
+}
+
+static jlong packTessellatorCounts(const PathTessellator& tessellator) {
+    return packCounts(tessellator.vertexCount(), tessellator.indexCount());
+}
+
+static jlong createPathTessellator(JNIEnv*, jobject) {
+    return jlong(new PathTessellator());
+}
+
+static void destroyPathTessellator(JNIEnv*, jobject, jlong pathTessellator_) {
+    delete reinterpret_cast<PathTessellator*>(pathTessellator_);
+}
+
+static jlong pathTessellatorFill(JNIEnv* env, jobject,
+                                 jlong pathTessellator_, jobject path_, jfloat tolerance_) {
+    auto pathTessellator = reinterpret_cast<PathTessellator*>(pathTessellator_);
+    pathTessellator->fill(pathSource(env, path_, tolerance_), tolerance_);
+    return packTessellatorCounts(*pathTessellator);
+}
+
+static jlong pathTessellatorFillSegments(JNIEnv* env, jobject,
+                                         jlong pathTessellator_,
+                                         jbyteArray verbs_, jfloatArray segments_, jint count_,
+                                         jfloat tolerance_) {
+    auto pathTessellator = reinterpret_cast<PathTessellator*>(pathTessellator_);
+
+    CriticalArray<jbyte> verbs(env, verbs_, JNI_ABORT);
+    if (verbs.data() == nullptr) return 0;
+    CriticalArray<jfloat> segments(env, segments_, JNI_ABORT);
+    if (segments.data() == nullptr) return 0;
+
+    pathTessellator->fill(segmentSource(verbs.data(), segments.data(), count_), tolerance_);
+
+    return packTessellatorCounts(*pathTessellator);
+}
+
+static jlong pathTessellatorStroke(JNIEnv* env, jobject,
+                                   jlong pathTessellator_, jobject path_, jfloat tolerance_,
+                                   jfloat width_, jint cap_, jint join_, jfloat miterLimit_) {
+    auto pathTessellator = reinterpret_cast<PathTessellator*>(pathTessellator_);
+    pathTessellator->stroke(
+            pathSource(env, path_, tolerance_), tolerance_,
+            strokeStyle(width_, cap_, join_, miterLimit_)
+    );
+    return packTessellatorCounts(*pathTessellator);
+}
+
+static jlong pathTessellatorStrokeSegments(JNIEnv* env, jobject,
+                                           jlong pathTessellator_,
+                                           jbyteArray verbs_, jfloatArray segments_, jint count_,
+                                           jfloat tolerance_,
+                                           jfloat width_, jint cap_, jint join_,
+                                           jfloat miterLimit_) {
+    auto pathTessellator = reinterpret_cast<PathTessellator*>(pathTessellator_);
+
+    CriticalArray<jbyte> verbs(env, verbs_, JNI_ABORT);
+    if (verbs.data() == nullptr) return 0;
+    CriticalArray<jfloat> segments(env, segments_, JNI_ABORT);
+    if (segments.data() == nullptr) return 0;
+
+    pathTessellator->stroke(
+            segmentSource(verbs.data(), segments.data(), count_), tolerance_,
+            strokeStyle(width_, cap_, join_, miterLimit_)
+    );
+
+    return packTessellatorCounts(*pathTessellator);
+}
+
+static jobject pathTessellatorVertices(JNIEnv* env, jobject, jlong pathTessellator_) {
+    auto pathTessellator = reinterpret_cast<PathTessellator*>(pathTessellator_);
+    return newDirectBuffer(
+            env, pathTessellator->vertices(), pathTessellator->vertexCount() * sizeof(Point)
+    );
+}
+
+static jobject pathTessellatorIndices(JNIEnv* env, jobject, jlong pathTessellator_) {
+    auto pathTessellator = reinterpret_cast<PathTessellator*>(pathTessellator_);
+    return newDirectBuffer(
+            env, pathTessellator->indices(),
+            pathTessellator->indexCount() * pathTessellator->indexSize()
+    );
+}
+
 JNIEXPORT jint JNI_OnLoad(JavaVM* vm, void*) {
     JNIEnv* env;
     if (vm->GetEnv(reinterpret_cast<void**>(&env), JNI_VERSION_1_6) != JNI_OK) {
@@ -161,6 +628,8 @@ JNIEXPORT jint JNI_OnLoad(JavaVM* vm, void*) {
     sPath.nativePath = env->GetFieldID(sPath.jniClass, "mNativePath", "J");
     if (sPath.nativePath == nullptr) return JNI_ERR;
 
+    sReadPathRef = resolvePathRefReader(api_level());
+
     {
         jclass pathsClass = env->FindClass(JNI_CLASS_NAME);
         if (pathsClass == nullptr) return JNI_ERR;
@@ -186,6 +655,11 @@ JNIEXPORT jint JNI_OnLoad(JavaVM* vm, void*) {
                     (char*) "(J[FI)I",
                     reinterpret_cast<void*>(pathIteratorNext)
                 },
+                {
+                    (char*) "internalPathIteratorNextBatch",
+                    (char*) "(J[B[FII)I",
+                    reinterpret_cast<void*>(pathIteratorNextBatch)
+                },
                 {
                     (char*) "internalPathIteratorPeek",
                     (char*) "(J)I",
@@ -226,6 +700,246 @@ JNIEXPORT jint JNI_OnLoad(JavaVM* vm, void*) {
         if (result != JNI_OK) return result;
 
         env->DeleteLocalRef(converterClass);
+
+        jclass snapshotClass = env->FindClass(JNI_CLASS_NAME_SNAPSHOT);
+        if (snapshotClass == nullptr) return JNI_ERR;
+        static const JNINativeMethod methods3[] = {
+                {
+                    (char*) "createInternalPathSnapshot",
+                    (char*) "()J",
+                    reinterpret_cast<void*>(createPathSnapshot)
+                },
+                {
+                    (char*) "destroyInternalPathSnapshot",
+                    (char*) "(J)V",
+                    reinterpret_cast<void*>(destroyPathSnapshot)
+                },
+                {
+                    (char*) "internalPathSnapshotCapture",
+                    (char*) "(JLandroid/graphics/Path;)I",
+                    reinterpret_cast<void*>(pathSnapshotCapture)
+                },
+                {
+                    (char*) "internalPathSnapshotVerbs",
+                    (char*) "(J)Ljava/nio/ByteBuffer;",
+                    reinterpret_cast<void*>(pathSnapshotVerbs)
+                },
+                {
+                    (char*) "internalPathSnapshotPoints",
+                    (char*) "(J)Ljava/nio/ByteBuffer;",
+                    reinterpret_cast<void*>(pathSnapshotPoints)
+                },
+                {
+                    (char*) "internalPathSnapshotConicWeights",
+                    (char*) "(J)Ljava/nio/ByteBuffer;",
+                    reinterpret_cast<void*>(pathSnapshotConicWeights)
+                },
+        };
+
+        result = env->RegisterNatives(
+                snapshotClass, methods3, sizeof(methods3) / sizeof(JNINativeMethod)
+        );
+        if (result != JNI_OK) return result;
+
+        env->DeleteLocalRef(snapshotClass);
+
+        jclass flattenerClass = env->FindClass(JNI_CLASS_NAME_FLATTENER);
+        if (flattenerClass == nullptr) return JNI_ERR;
+        static const JNINativeMethod methods4[] = {
+                {
+                    (char*) "internalFlattenPath",
+                    (char*) "(Landroid/graphics/Path;F[F[I)J",
+                    reinterpret_cast<void*>(flattenPath)
+                },
+                {
+                    (char*) "internalFlattenSegments",
+                    (char*) "([B[FIF[F[I)J",
+                    reinterpret_cast<void*>(flattenSegments)
+                },
+        };
+
+        result = env->RegisterNatives(
+                flattenerClass, methods4, sizeof(methods4) / sizeof(JNINativeMethod)
+        );
+        if (result != JNI_OK) return result;
+
+        env->DeleteLocalRef(flattenerClass);
+
+        jclass measureClass = env->FindClass(JNI_CLASS_NAME_MEASURE);
+        if (measureClass == nullptr) return JNI_ERR;
+        static const JNINativeMethod methods5[] = {
+                {
+                    (char*) "createInternalPathMeasure",
+                    (char*) "()J",
+                    reinterpret_cast<void*>(createPathMeasure)
+                },
+                {
+                    (char*) "destroyInternalPathMeasure",
+                    (char*) "(J)V",
+                    reinterpret_cast<void*>(destroyPathMeasure)
+                },
+                {
+                    (char*) "internalPathMeasureSetPath",
+                    (char*) "(JLandroid/graphics/Path;F)I",
+                    reinterpret_cast<void*>(pathMeasureSetPath)
+                },
+                {
+                    (char*) "internalPathMeasureSetSegments",
+                    (char*) "(J[B[FIF)I",
+                    reinterpret_cast<void*>(pathMeasureSetSegments)
+                },
+                {
+                    (char*) "internalPathMeasureLength",
+                    (char*) "(JI)F",
+                    reinterpret_cast<void*>(pathMeasureLength)
+                },
+                {
+                    (char*) "internalPathMeasureIsClosed",
+                    (char*) "(JI)Z",
+                    reinterpret_cast<void*>(pathMeasureIsClosed)
+                },
+                {
+                    (char*) "internalPathMeasureBounds",
+                    (char*) "(J[F)V",
+                    reinterpret_cast<void*>(pathMeasureBounds)
+                },
+                {
+                    (char*) "internalPathMeasurePosTan",
+                    (char*) "(JIF[FI)Z",
+                    reinterpret_cast<void*>(pathMeasurePosTan)
+                },
+                {
+                    (char*) "internalPathMeasureSegment",
+                    (char*) "(JIFF[F)I",
+                    reinterpret_cast<void*>(pathMeasureSegment)
+                },
+        };
+
+        result = env->RegisterNatives(
+                measureClass, methods5, sizeof(methods5) / sizeof(JNINativeMethod)
+        );
+        if (result != JNI_OK) return result;
+
+        env->DeleteLocalRef(measureClass);
+
+        jclass cacheClass = env->FindClass(JNI_CLASS_NAME_CACHE);
+        if (cacheClass == nullptr) return JNI_ERR;
+        static const JNINativeMethod methods6[] = {
+                {
+                    (char*) "createInternalPathCache",
+                    (char*) "(I)J",
+                    reinterpret_cast<void*>(createPathCache)
+                },
+                {
+                    (char*) "destroyInternalPathCache",
+                    (char*) "(J)V",
+                    reinterpret_cast<void*>(destroyPathCache)
+                },
+                {
+                    (char*) "internalPathCacheHash",
+                    (char*) "(Landroid/graphics/Path;)J",
+                    reinterpret_cast<void*>(pathCacheHash)
+                },
+                {
+                    (char*) "internalPathCacheHashData",
+                    (char*) "([BI[FI[FI)J",
+                    reinterpret_cast<void*>(pathCacheHashData)
+                },
+                {
+                    (char*) "internalPathCacheGet",
+                    (char*) "(JLandroid/graphics/Path;)J",
+                    reinterpret_cast<void*>(pathCacheGet)
+                },
+                {
+                    (char*) "internalPathCacheGetData",
+                    (char*) "(J[BI[FI[FI)J",
+                    reinterpret_cast<void*>(pathCacheGetData)
+                },
+                {
+                    (char*) "internalPathCacheBounds",
+                    (char*) "(JJ[F)V",
+                    reinterpret_cast<void*>(pathCacheBounds)
+                },
+                {
+                    (char*) "internalPathCacheQuadratics",
+                    (char*) "(JJF[B[F)I",
+                    reinterpret_cast<void*>(pathCacheQuadratics)
+                },
+                {
+                    (char*) "internalPathCachePolylines",
+                    (char*) "(JJF[F[I)J",
+                    reinterpret_cast<void*>(pathCachePolylines)
+                },
+                {
+                    (char*) "internalPathCacheSize",
+                    (char*) "(J)I",
+                    reinterpret_cast<void*>(pathCacheSize)
+                },
+                {
+                    (char*) "internalPathCacheClear",
+                    (char*) "(J)V",
+                    reinterpret_cast<void*>(pathCacheClear)
+                },
+        };
+
+        result = env->RegisterNatives(
+                cacheClass, methods6, sizeof(methods6) / sizeof(JNINativeMethod)
+        );
+        if (result != JNI_OK) return result;
+
+        env->DeleteLocalRef(cacheClass);
+
+        jclass tessellatorClass = env->FindClass(JNI_CLASS_NAME_TESSELLATOR);
+        if (tessellatorClass == nullptr) return JNI_ERR;
+        static const JNINativeMethod methods7[] = {
+                {
+                    (char*) "createInternalPathTessellator",
+                    (char*) "()J",
+                    reinterpret_cast<void*>(createPathTessellator)
+                },
+                {
+                    (char*) "destroyInternalPathTessellator",
+                    (char*) "(J)V",
+                    reinterpret_cast<void*>(destroyPathTessellator)
+                },
+                {
+                    (char*) "internalPathTessellatorFill",
+                    (char*) "(JLandroid/graphics/Path;F)J",
+                    reinterpret_cast<void*>(pathTessellatorFill)
+                },
+                {
+                    (char*) "internalPathTessellatorFillSegments",
+                    (char*) "(J[B[FIF)J",
+                    reinterpret_cast<void*>(pathTessellatorFillSegments)
+                },
+                {
+                    (char*) "internalPathTessellatorStroke",
+                    (char*) "(JLandroid/graphics/Path;FFIIF)J",
+                    reinterpret_cast<void*>(pathTessellatorStroke)
+                },
+                {
+                    (char*) "internalPathTessellatorStrokeSegments",
+                    (char*) "(J[B[FIFFIIF)J",
+                    reinterpret_cast<void*>(pathTessellatorStrokeSegments)
+                },
+                {
+                    (char*) "internalPathTessellatorVertices",
+                    (char*) "(J)Ljava/nio/ByteBuffer;",
+                    reinterpret_cast<void*>(pathTessellatorVertices)
+                },
+                {
+                    (char*) "internalPathTessellatorIndices",
+                    (char*) "(J)Ljava/nio/ByteBuffer;",
+                    reinterpret_cast<void*>(pathTessellatorIndices)
+                },
+        };
+
+        result = env->RegisterNatives(
+                tessellatorClass, methods7, sizeof(methods7) / sizeof(JNINativeMethod)
+        );
+        if (result != JNI_OK) return result;
+
+        env->DeleteLocalRef(tessellatorClass);
     }
 
     return JNI_VERSION_1_6;
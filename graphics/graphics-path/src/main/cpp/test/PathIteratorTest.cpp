@@ -0,0 +1,223 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Host test of PathIterator and PathIteratorPool: conversion of a conic ending the path, parity
+// between count() and the iterated verbs, and reuse of pooled iterators across paths. Build
+// with the host configuration of CMakeLists.txt and run with ctest.
+
+#include "../Conic.h"
+#include "../PathIterator.h"
+#include "../PathIteratorPool.h"
+
+#include <cstdio>
+#include <vector>
+
+static int sFailureCount = 0;
+
+#define EXPECT(condition)                                                                   \
+    do {                                                                                    \
+        if (!(condition)) {                                                                 \
+            fprintf(stderr, "%s:%d: expected %s\n", __FILE__, __LINE__, #condition);        \
+            sFailureCount++;                                                                \
+        }                                                                                   \
+    } while (0)
+
+// Owns the arrays of a path with forward verbs, as on API 30+
+struct TestPath {
+    std::vector<Point> points;
+    std::vector<Verb> verbs;
+    std::vector<float> conicWeights;
+
+    TestPath& moveTo(float x, float y) {
+        verbs.push_back(Verb::Move);
+        points.push_back({ .x = x, .y = y });
+        return *this;
+    }
+
+    TestPath& lineTo(float x, float y) {
+        verbs.push_back(Verb::Line);
+        points.push_back({ .x = x, .y = y });
+        return *this;
+    }
+
+    TestPath& conicTo(float x1, float y1, float x2, float y2, float weight) {
+        verbs.push_back(Verb::Conic);
+        points.push_back({ .x = x1, .y = y1 });
+        points.push_back({ .x = x2, .y = y2 });
+        conicWeights.push_back(weight);
+        return *this;
+    }
+
+    TestPath& close() {
+        verbs.push_back(Verb::Close);
+        return *this;
+    }
+
+    PathIterator* acquire(PathIteratorPool& pool, PathIterator::ConicEvaluation evaluation) {
+        return pool.acquire(
+                points.data(), verbs.data(), conicWeights.data(), int(verbs.size()),
+                int(conicWeights.size()), PathIterator::VerbDirection::Forward, evaluation, 0.25f
+        );
+    }
+
+    PathIterator iterator(PathIterator::ConicEvaluation evaluation) {
+        return PathIterator(
+                points.data(), verbs.data(), conicWeights.data(), int(verbs.size()),
+                int(conicWeights.size()), PathIterator::VerbDirection::Forward, evaluation, 0.25f
+        );
+    }
+};
+
+struct Segment {
+    Verb verb;
+    Point points[4];
+};
+
+// Iterates until Done, checking that peek() announces each verb
+static std::vector<Segment> iterate(PathIterator& iterator) {
+    std::vector<Segment> segments;
+    while (iterator.hasNext()) {
+        const Verb peeked = iterator.peek();
+        Segment segment{};
+        segment.verb = iterator.next(segment.points);
+        EXPECT(segment.verb == peeked);
+        EXPECT(segment.verb != Verb::Done);
+        segments.push_back(segment);
+    }
+    EXPECT(iterator.peek() == Verb::Done);
+    Point points[4];
+    EXPECT(iterator.next(points) == Verb::Done);
+    return segments;
+}
+
+static bool sameSegments(const std::vector<Segment>& a, const std::vector<Segment>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].verb != b[i].verb) return false;
+        for (int p = 0; p < 3; p++) {
+            if (a[i].points[p].x != b[i].points[p].x) return false;
+            if (a[i].points[p].y != b[i].points[p].y) return false;
+        }
+    }
+    return true;
+}
+
+// A quarter circle ending the path, as built by Path.addArc()
+static TestPath arcPath() {
+    TestPath path;
+    path.moveTo(100.0f, 50.0f).conicTo(100.0f, 100.0f, 50.0f, 100.0f, 0.70710677f);
+    return path;
+}
+
+static void testConicAtEndOfPath() {
+    TestPath path = arcPath();
+    Point quadratics[65];
+    const int quadraticCount = conicToQuadratics(
+            &path.points[0], quadratics, 32, path.conicWeights[0], 0.25f);
+    EXPECT(quadraticCount > 1);
+
+    for (bool countFirst : { false, true }) {
+        PathIterator iterator = path.iterator(PathIterator::ConicEvaluation::AsQuadratics);
+        const int count = countFirst ? iterator.count() : 0;
+        const std::vector<Segment> segments = iterate(iterator);
+
+        EXPECT(int(segments.size()) == 1 + quadraticCount);
+        EXPECT(iterator.count() == int(segments.size()));
+        if (countFirst) EXPECT(count == int(segments.size()));
+        EXPECT(segments[0].verb == Verb::Move);
+        for (size_t i = 1; i < segments.size(); i++) {
+            EXPECT(segments[i].verb == Verb::Quadratic);
+        }
+
+        // The trailing quadratics end where the conic does
+        const Segment& last = segments.back();
+        EXPECT(last.points[2].x == 50.0f && last.points[2].y == 100.0f);
+    }
+
+    // The batched next() produces the same quadratics
+    PathIterator iterator = path.iterator(PathIterator::ConicEvaluation::AsQuadratics);
+    Verb verbs[4];
+    Point points[16];
+    int written = 0;
+    int total = 0;
+    do {
+        written = iterator.next(verbs, points, 4);
+        total += written;
+    } while (written == 4);
+    EXPECT(total == 1 + quadraticCount);
+    EXPECT(!iterator.hasNext());
+
+    // As a conic, the path has its 2 raw verbs
+    PathIterator conics = path.iterator(PathIterator::ConicEvaluation::AsConic);
+    EXPECT(iterate(conics).size() == 2);
+    EXPECT(conics.count() == 2);
+}
+
+static void testPoolReuse() {
+    PathIteratorPool pool;
+    TestPath a = arcPath();
+    TestPath b;
+    b.moveTo(0.0f, 0.0f).lineTo(10.0f, 0.0f).lineTo(10.0f, 10.0f).close();
+
+    PathIterator expectedA = a.iterator(PathIterator::ConicEvaluation::AsQuadratics);
+    const std::vector<Segment> segmentsA = iterate(expectedA);
+    PathIterator expectedB = b.iterator(PathIterator::ConicEvaluation::AsQuadratics);
+    const std::vector<Segment> segmentsB = iterate(expectedB);
+
+    // Path A fully iterated, then released
+    PathIterator* iterator = a.acquire(pool, PathIterator::ConicEvaluation::AsQuadratics);
+    EXPECT(iterator->count() == int(segmentsA.size()));
+    EXPECT(sameSegments(iterate(*iterator), segmentsA));
+    pool.release(iterator);
+
+    PathIterator* reused = b.acquire(pool, PathIterator::ConicEvaluation::AsQuadratics);
+    EXPECT(reused == iterator);
+    EXPECT(reused->count() == int(segmentsB.size()));
+    EXPECT(sameSegments(iterate(*reused), segmentsB));
+    pool.release(reused);
+
+    // Path A released with quadratics of its conic still pending
+    iterator = a.acquire(pool, PathIterator::ConicEvaluation::AsQuadratics);
+    iterator->count();
+    Point points[4];
+    EXPECT(iterator->next(points) == Verb::Move);
+    EXPECT(iterator->next(points) == Verb::Quadratic);
+    EXPECT(iterator->hasNext());
+    pool.release(iterator);
+
+    reused = b.acquire(pool, PathIterator::ConicEvaluation::AsQuadratics);
+    EXPECT(reused == iterator);
+    EXPECT(reused->peek() == Verb::Move);
+    EXPECT(sameSegments(iterate(*reused), segmentsB));
+    EXPECT(reused->count() == int(segmentsB.size()));
+    pool.release(reused);
+
+    // And back to path A, whose conic counts must be recomputed
+    reused = a.acquire(pool, PathIterator::ConicEvaluation::AsQuadratics);
+    EXPECT(sameSegments(iterate(*reused), segmentsA));
+    EXPECT(reused->count() == int(segmentsA.size()));
+    pool.release(reused);
+}
+
+int main() {
+    testConicAtEndOfPath();
+    testPoolReuse();
+    if (sFailureCount > 0) {
+        printf("%d failures\n", sFailureCount);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,268 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package androidx.graphics.path
+
+import android.graphics.Path
+import android.graphics.RectF
+import android.os.Build
+
+/**
+ * A path cache stores geometry derived from paths, keyed by the content of the paths rather
+ * than by their identity: two distinct [Path] objects with the same verbs, points and conic
+ * weights share the same cache entry. This lets callers that rebuild identical paths often
+ * (every frame for instance) skip re-deriving their geometry.
+ *
+ * Each call computes a 64-bit [content hash][contentHash] of the path in native code, then
+ * returns the requested data from the cache, computing it first if needed. The memory used
+ * by the cache is bounded by [maxSize]; least recently used paths are evicted first.
+ *
+ * The results of [getQuadratics] and [getPolylines] are copied into arrays owned by the
+ * returned objects, which can be passed back to later calls to reuse their storage. A path
+ * cache is not thread safe.
+ *
+ * @param maxSize Maximum size of the cache, in bytes. Default is 1 MiB.
+ */
+@Suppress("NotCloseable")
+class PathCache(val maxSize: Int = 1024 * 1024) {
+    private companion object {
+        init {
+            System.loadLibrary("androidx.graphics.path")
+        }
+    }
+
+    @Suppress("KotlinJniMissingFunction")
+    private external fun createInternalPathCache(maxSize: Int): Long
+
+    @Suppress("KotlinJniMissingFunction")
+    private external fun destroyInternalPathCache(internalPathCache: Long)
+
+    @Suppress("KotlinJniMissingFunction")
+    private external fun internalPathCacheHash(path: Path): Long
+
+    @Suppress("KotlinJniMissingFunction")
+    private external fun internalPathCacheHashData(
+        verbs: ByteArray,
+        verbCount: Int,
+        points: FloatArray,
+        pointCount: Int,
+        conicWeights: FloatArray,
+        conicWeightCount: Int
+    ): Long
+
+    @Suppress("KotlinJniMissingFunction")
+    private external fun internalPathCacheGet(internalPathCache: Long, path: Path): Long
+
+    @Suppress("KotlinJniMissingFunction")
+    private external fun internalPathCacheGetData(
+        internalPathCache: Long,
+        verbs: ByteArray,
+        verbCount: Int,
+        points: FloatArray,
+        pointCount: Int,
+        conicWeights: FloatArray,
+        conicWeightCount: Int
+    ): Long
+
+    @Suppress("KotlinJniMissingFunction")
+    private external fun internalPathCacheBounds(
+        internalPathCache: Long,
+        entry: Long,
+        bounds: FloatArray
+    )
+
+    @Suppress("KotlinJniMissingFunction")
+    private external fun internalPathCacheQuadratics(
+        internalPathCache: Long,
+        entry: Long,
+        tolerance: Float,
+        types: ByteArray,
+        points: FloatArray
+    ): Int
+
+    @Suppress("KotlinJniMissingFunction")
+    private external fun internalPathCachePolylines(
+        internalPathCache: Long,
+        entry: Long,
+        tolerance: Float,
+        points: FloatArray,
+        contourEnds: IntArray
+    ): Long
+
+    @Suppress("KotlinJniMissingFunction")
+    private external fun internalPathCacheSize(internalPathCache: Long): Int
+
+    @Suppress("KotlinJniMissingFunction")
+    private external fun internalPathCacheClear(internalPathCache: Long)
+
+    private val internalPathCache = createInternalPathCache(maxSize)
+
+    // The raw path data is rebuilt from the platform iterator in API 34+
+    private val snapshot = if (Build.VERSION.SDK_INT >= 34) PathSnapshot() else null
+
+    private val bounds = FloatArray(4)
+
+    /**
+     * Quadratic expansion of a path: the segments of the path with every conic converted
+     * to quadratics. [types] contains [count] bytes, each the ordinal of a [PathSegment.Type],
+     * and [points] contains 8 floats per segment, following the layout of [PathIterator.next].
+     * The arrays are grown when needed and may be larger than required, only the data of
+     * the first [count] segments is meaningful.
+     */
+    class Quadratics {
+        var count = 0
+            internal set
+
+        var types = ByteArray(16)
+            internal set
+
+        var points = FloatArray(16 * 8)
+            internal set
+    }
+
+    /**
+     * Polylines approximating a path, using the layout described in [PathFlattener].
+     * [points] contains [pointCount] pairs of floats and [contourEnds] contains
+     * [contourCount] indices. The arrays are grown when needed and may be larger than
+     * required.
+     */
+    class Polylines {
+        var pointCount = 0
+            internal set
+
+        var points = FloatArray(256)
+            internal set
+
+        var contourCount = 0
+            internal set
+
+        var contourEnds = IntArray(8)
+            internal set
+    }
+
+    /**
+     * Current size of the cache, in bytes.
+     */
+    val size: Int
+        get() = internalPathCacheSize(internalPathCache)
+
+    /**
+     * Returns the 64-bit hash of the content of [path], as used to key this cache. Two paths
+     * with the same hash are very likely, but not guaranteed, to be identical; the cache
+     * itself compares the content of paths with equal hashes.
+     */
+    fun contentHash(path: Path): Long {
+        val snapshot = snapshot ?: return internalPathCacheHash(path)
+        snapshot.capture(path)
+        return internalPathCacheHashData(
+            snapshot.verbs.array(), snapshot.verbCount,
+            snapshot.points.array(), snapshot.points.limit() / 2,
+            snapshot.conicWeights.array(), snapshot.conicWeights.limit()
+        )
+    }
+
+    /**
+     * Stores the tight bounds of [path] in [result]. The bounds are computed from the
+     * extrema of the curves rather than from their control points. The bounds are empty
+     * if the path is empty.
+     */
+    fun getBounds(path: Path, result: RectF) {
+        internalPathCacheBounds(internalPathCache, getEntry(path), bounds)
+        result.set(bounds[0], bounds[1], bounds[2], bounds[3])
+    }
+
+    /**
+     * Copies the segments of [path], with every conic converted to quadratics using the
+     * specified [tolerance], into [result] and returns it. Passing the same [result] to
+     * subsequent calls reuses its arrays whenever they are large enough.
+     */
+    fun getQuadratics(
+        path: Path,
+        tolerance: Float = 0.25f,
+        result: Quadratics = Quadratics()
+    ): Quadratics {
+        val entry = getEntry(path)
+        while (true) {
+            val count = internalPathCacheQuadratics(
+                internalPathCache, entry, tolerance, result.types, result.points
+            )
+            result.count = count
+
+            val fits = count <= result.types.size && count * 8 <= result.points.size
+            if (fits) break
+
+            // The native cache reports the size required to hold the whole result
+            if (count > result.types.size) result.types = ByteArray(count)
+            if (count * 8 > result.points.size) result.points = FloatArray(count * 8)
+        }
+        return result
+    }
+
+    /**
+     * Copies the polylines approximating [path] with the specified [tolerance] into [result]
+     * and returns it. See [PathFlattener] for more information. Passing the same [result] to
+     * subsequent calls reuses its arrays whenever they are large enough.
+     */
+    fun getPolylines(
+        path: Path,
+        tolerance: Float = 0.25f,
+        result: Polylines = Polylines()
+    ): Polylines {
+        val entry = getEntry(path)
+        while (true) {
+            val counts = internalPathCachePolylines(
+                internalPathCache, entry, tolerance, result.points, result.contourEnds
+            )
+            result.pointCount = (counts ushr 32).toInt()
+            result.contourCount = counts.toInt()
+
+            val fits = result.pointCount * 2 <= result.points.size &&
+                result.contourCount <= result.contourEnds.size
+            if (fits) break
+
+            // The native cache reports the sizes required to hold the whole result
+            if (result.pointCount * 2 > result.points.size) {
+                result.points = FloatArray(result.pointCount * 2)
+            }
+            if (result.contourCount > result.contourEnds.size) {
+                result.contourEnds = IntArray(result.contourCount)
+            }
+        }
+        return result
+    }
+
+    /**
+     * Removes all the entries of this cache.
+     */
+    fun clear() {
+        internalPathCacheClear(internalPathCache)
+    }
+
+    private fun getEntry(path: Path): Long {
+        val snapshot = snapshot ?: return internalPathCacheGet(internalPathCache, path)
+        snapshot.capture(path)
+        return internalPathCacheGetData(
+            internalPathCache,
+            snapshot.verbs.array(), snapshot.verbCount,
+            snapshot.points.array(), snapshot.points.limit() / 2,
+            snapshot.conicWeights.array(), snapshot.conicWeights.limit()
+        )
+    }
+
+    protected fun finalize() {
+        destroyInternalPathCache(internalPathCache)
+    }
+}
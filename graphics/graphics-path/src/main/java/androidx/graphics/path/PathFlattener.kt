@@ -0,0 +1,127 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+@file:JvmName("PathFlattenerUtilities")
+package androidx.graphics.path
+
+import android.graphics.Path
+import android.os.Build
+
+/**
+ * A path flattener approximates all the curves of a [Path] with line segments, in native
+ * code. The maximum distance between a curve and its approximation is controlled by
+ * [tolerance]; the number of line segments used for each curve is derived from the curve's
+ * geometry and [tolerance].
+ *
+ * The result of [flatten] is a series of polylines, one per contour, stored back to back
+ * in [points]. The storage is reused by subsequent calls to [flatten] whenever it is large
+ * enough, which makes flattening paths repeatedly allocation-free.
+ *
+ * @param tolerance Maximum distance between the curves and the line segments that
+ *                  approximate them. Default is 0.25f (sub-pixel).
+ */
+class PathFlattener(val tolerance: Float = 0.25f) {
+    private companion object {
+        init {
+            System.loadLibrary("androidx.graphics.path")
+        }
+    }
+
+    @Suppress("KotlinJniMissingFunction")
+    private external fun internalFlattenPath(
+        path: Path,
+        tolerance: Float,
+        points: FloatArray,
+        contourEnds: IntArray
+    ): Long
+
+    @Suppress("KotlinJniMissingFunction")
+    private external fun internalFlattenSegments(
+        verbs: ByteArray,
+        segments: FloatArray,
+        count: Int,
+        tolerance: Float,
+        points: FloatArray,
+        contourEnds: IntArray
+    ): Long
+
+    /**
+     * Points of all the polylines, stored as pairs of floats (x, y). Only the first
+     * [pointCount] points are meaningful.
+     */
+    var points = FloatArray(256)
+        private set
+
+    /**
+     * Number of points stored in [points].
+     */
+    var pointCount = 0
+        private set
+
+    /**
+     * For each contour, index of the point that follows the last point of the contour in
+     * [points]. Contour `i` spans points `contourEnds[i - 1]` (or 0) to `contourEnds[i]`
+     * excluded. Closed contours end with a copy of their first point. Only the first
+     * [contourCount] values are meaningful.
+     */
+    var contourEnds = IntArray(8)
+        private set
+
+    /**
+     * Number of contours stored in [contourEnds].
+     */
+    var contourCount = 0
+        private set
+
+    // Segments gathered from the platform iterator in API 34+, reused across calls
+    private val segments = PathSegmentBuffer()
+
+    /**
+     * Flattens [path] and returns this flattener, whose [points] and [contourEnds] hold
+     * the result.
+     */
+    fun flatten(path: Path): PathFlattener {
+        val segmentCount =
+            if (Build.VERSION.SDK_INT >= 34) segments.gather(path, tolerance) else 0
+
+        while (true) {
+            val counts = if (Build.VERSION.SDK_INT >= 34) {
+                internalFlattenSegments(
+                    segments.verbs, segments.points, segmentCount, tolerance, points, contourEnds
+                )
+            } else {
+                internalFlattenPath(path, tolerance, points, contourEnds)
+            }
+
+            pointCount = (counts ushr 32).toInt()
+            contourCount = counts.toInt()
+
+            val fits = pointCount * 2 <= points.size && contourCount <= contourEnds.size
+            if (fits) break
+
+            // The native flattener reports the sizes required to hold the whole path
+            if (pointCount * 2 > points.size) points = FloatArray(pointCount * 2)
+            if (contourCount > contourEnds.size) contourEnds = IntArray(contourCount)
+        }
+
+        return this
+    }
+}
+
+/**
+ * Flattens this [path][android.graphics.Path] with the given [tolerance]. See
+ * [PathFlattener] for more information.
+ */
+fun Path.flatten(tolerance: Float = 0.25f) = PathFlattener(tolerance).flatten(this)
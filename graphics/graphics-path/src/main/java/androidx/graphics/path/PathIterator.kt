@@ -107,6 +107,38 @@ class PathIterator constructor(
     fun next(points: FloatArray, offset: Int = 0): PathSegment.Type =
         implementation.next(points, offset)
 
+    /**
+     * Fills [types] and [points] with up to [count] consecutive segments of the iteration and
+     * returns the number of segments written. The returned value is smaller than [count] only
+     * when the iteration is finished, in which case [Done][PathSegment.Type.Done] is not
+     * written. The points of the segment stored in `types[i]` start at index
+     * `offset + i * 8` in [points] and follow the layout described in [next].
+     *
+     * When the path is iterated in native code, the whole batch is produced with a single
+     * JNI call. This method does not allocate any memory once its internal storage is large
+     * enough to hold [count] segments.
+     *
+     * @param types An array large enough to hold [count] segment types
+     * @param points A [FloatArray] large enough to hold `count * 8` floats starting at [offset]
+     * @param offset Offset in [points] where to store the first segment
+     * @param count The maximum number of segments to return, [types] size by default
+     */
+    @JvmOverloads
+    fun next(
+        @Suppress("ArrayReturn") types: Array<PathSegment.Type>,
+        points: FloatArray,
+        offset: Int = 0,
+        count: Int = types.size
+    ): Int {
+        require(count >= 0 && count <= types.size) {
+            "count ($count) must be in the range 0..${types.size}"
+        }
+        require(offset >= 0 && offset + count * 8 <= points.size) {
+            "points cannot hold $count segments at offset $offset"
+        }
+        return implementation.next(types, points, offset, count)
+    }
+
     /**
      * Returns the next [path segment][PathSegment] in the iteration, or [DoneSegment] if
      * the iteration is finished. To save on allocations, use the alternative [next] function, which
@@ -55,6 +55,25 @@ internal abstract class PathIteratorImpl(
     abstract fun peek(): PathSegment.Type
     abstract fun next(points: FloatArray, offset: Int = 0): PathSegment.Type
 
+    /**
+     * Batched variant of [next]. Implementations that can produce several segments at once
+     * should override this function, the default implementation iterates one segment at a time.
+     */
+    open fun next(
+        types: Array<PathSegment.Type>,
+        points: FloatArray,
+        offset: Int,
+        count: Int
+    ): Int {
+        var index = 0
+        while (index < count) {
+            val type = next(points, offset + index * 8)
+            if (type == PathSegment.Type.Done) break
+            types[index++] = type
+        }
+        return index
+    }
+
     fun next(): PathSegment {
         val type = next(pointsData, 0)
         if (type == PathSegment.Type.Done) return DoneSegment
@@ -131,6 +150,12 @@ internal class PathIteratorApi34Impl(
      */
     var conicConverter = ConicConverter()
 
+    /**
+     * Converts the conics counted by calculateSize(), which must not disturb the quadratics
+     * [conicConverter] has pending for next().
+     */
+    private val sizeConicConverter by lazy(LazyThreadSafetyMode.NONE) { ConicConverter() }
+
     /**
      * The platform does not expose a calculateSize() method, so we implement our own. In the
      * simplest case, this is done by simply iterating through all segments until done. However, if
@@ -147,7 +172,7 @@ internal class PathIteratorApi34Impl(
         while (tempIterator.hasNext()) {
             val type = tempIterator.next(tempFloats, 0)
             if (type == PlatformPathIterator.VERB_CONIC && convertConics) {
-                with(conicConverter) {
+                with(sizeConicConverter) {
                     convert(tempFloats, tempFloats[6], tolerance)
                     numVerbs += quadraticCount
                 }
@@ -181,9 +206,24 @@ internal class PathIteratorApi34Impl(
         }
     }
 
-    override fun hasNext(): Boolean = platformIterator.hasNext()
+    override fun hasNext(): Boolean =
+        conicConverter.currentQuadratic < conicConverter.quadraticCount ||
+            platformIterator.hasNext()
 
-    override fun peek() = platformToAndroidXSegmentType(platformIterator.peek())
+    override fun peek(): PathSegment.Type {
+        if (conicConverter.currentQuadratic < conicConverter.quadraticCount) {
+            return PathSegment.Type.Quadratic
+        }
+        val type = platformToAndroidXSegmentType(platformIterator.peek())
+        // next() returns the first quadratic of a converted conic
+        return if (
+            type == PathSegment.Type.Conic && conicEvaluation == ConicEvaluation.AsQuadratics
+        ) {
+            PathSegment.Type.Quadratic
+        } else {
+            type
+        }
+    }
 }
 
 /**
@@ -237,6 +277,15 @@ internal class PathIteratorPreApi34Impl(
         offset: Int
     ): Int
 
+    @Suppress("KotlinJniMissingFunction")
+    private external fun internalPathIteratorNextBatch(
+        internalPathIterator: Long,
+        verbs: ByteArray,
+        points: FloatArray,
+        offset: Int,
+        count: Int
+    ): Int
+
     @Suppress("KotlinJniMissingFunction")
     private external fun internalPathIteratorPeek(internalPathIterator: Long): Int
 
@@ -286,6 +335,31 @@ internal class PathIteratorPreApi34Impl(
     override fun next(points: FloatArray, offset: Int) =
         PathSegmentTypes[internalPathIteratorNext(internalPathIterator, points, offset)]
 
+    /**
+     * Verbs produced by the batched [next], grown on demand and reused across calls.
+     */
+    private var verbsData = ByteArray(0)
+
+    /**
+     * Produces up to [count] segments with a single native call. The native iterator writes
+     * raw verbs in [verbsData] which are then mapped to [PathSegment.Type] values.
+     */
+    override fun next(
+        types: Array<PathSegment.Type>,
+        points: FloatArray,
+        offset: Int,
+        count: Int
+    ): Int {
+        if (verbsData.size < count) verbsData = ByteArray(count)
+        val written = internalPathIteratorNextBatch(
+            internalPathIterator, verbsData, points, offset, count
+        )
+        for (i in 0 until written) {
+            types[i] = PathSegmentTypes[verbsData[i].toInt()]
+        }
+        return written
+    }
+
     protected fun finalize() {
         destroyInternalPathIterator(internalPathIterator)
     }
@@ -0,0 +1,205 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+@file:JvmName("PathMeasureUtilities")
+package androidx.graphics.path
+
+import android.graphics.Path
+import android.graphics.RectF
+import android.os.Build
+
+/**
+ * A path measure computes the length of the contours of a [Path] and lets callers query
+ * positions, tangents and sub-segments along those contours.
+ *
+ * Unlike [android.graphics.PathMeasure], all the contours of the path are measured at once
+ * when calling [setPath], in native code: the curves are flattened with the given
+ * [tolerance] and the cumulative arc length of every resulting point is cached. Subsequent
+ * queries only perform a binary search in that table and can address any contour directly.
+ * The native storage is reused by subsequent calls to [setPath].
+ *
+ * @param tolerance Maximum distance between the curves and the line segments used to
+ *                  measure them. Default is 0.25f (sub-pixel).
+ */
+@Suppress("NotCloseable")
+class PathMeasure(val tolerance: Float = 0.25f) {
+    private companion object {
+        init {
+            System.loadLibrary("androidx.graphics.path")
+        }
+    }
+
+    @Suppress("KotlinJniMissingFunction")
+    private external fun createInternalPathMeasure(): Long
+
+    @Suppress("KotlinJniMissingFunction")
+    private external fun destroyInternalPathMeasure(internalPathMeasure: Long)
+
+    @Suppress("KotlinJniMissingFunction")
+    private external fun internalPathMeasureSetPath(
+        internalPathMeasure: Long,
+        path: Path,
+        tolerance: Float
+    ): Int
+
+    @Suppress("KotlinJniMissingFunction")
+    private external fun internalPathMeasureSetSegments(
+        internalPathMeasure: Long,
+        verbs: ByteArray,
+        segments: FloatArray,
+        count: Int,
+        tolerance: Float
+    ): Int
+
+    @Suppress("KotlinJniMissingFunction")
+    private external fun internalPathMeasureLength(internalPathMeasure: Long, contour: Int): Float
+
+    @Suppress("KotlinJniMissingFunction")
+    private external fun internalPathMeasureIsClosed(
+        internalPathMeasure: Long,
+        contour: Int
+    ): Boolean
+
+    @Suppress("KotlinJniMissingFunction")
+    private external fun internalPathMeasureBounds(internalPathMeasure: Long, bounds: FloatArray)
+
+    @Suppress("KotlinJniMissingFunction")
+    private external fun internalPathMeasurePosTan(
+        internalPathMeasure: Long,
+        contour: Int,
+        distance: Float,
+        result: FloatArray,
+        offset: Int
+    ): Boolean
+
+    @Suppress("KotlinJniMissingFunction")
+    private external fun internalPathMeasureSegment(
+        internalPathMeasure: Long,
+        contour: Int,
+        start: Float,
+        end: Float,
+        points: FloatArray
+    ): Int
+
+    private val internalPathMeasure = createInternalPathMeasure()
+
+    // Segments gathered from the platform iterator in API 34+, reused across calls
+    private val segments = PathSegmentBuffer()
+
+    private val bounds = FloatArray(4)
+
+    /**
+     * Number of contours in the path passed to the last call to [setPath].
+     */
+    var contourCount = 0
+        private set
+
+    /**
+     * Measures all the contours of [path] and returns this path measure. The path can be
+     * modified afterwards without affecting the results of this path measure.
+     */
+    fun setPath(path: Path): PathMeasure {
+        contourCount = if (Build.VERSION.SDK_INT >= 34) {
+            val count = segments.gather(path, tolerance)
+            internalPathMeasureSetSegments(
+                internalPathMeasure, segments.verbs, segments.points, count, tolerance
+            )
+        } else {
+            internalPathMeasureSetPath(internalPathMeasure, path, tolerance)
+        }
+        return this
+    }
+
+    /**
+     * Returns the length of the specified [contour].
+     */
+    fun getLength(contour: Int): Float {
+        checkContour(contour)
+        return internalPathMeasureLength(internalPathMeasure, contour)
+    }
+
+    /**
+     * Returns true if the specified [contour] is closed.
+     */
+    fun isClosed(contour: Int): Boolean {
+        checkContour(contour)
+        return internalPathMeasureIsClosed(internalPathMeasure, contour)
+    }
+
+    /**
+     * Stores the tight bounds of the measured path in [result]. Unlike
+     * [Path.computeBounds], the bounds are computed from the extrema of the curves rather
+     * than from their control points. The bounds are empty if the path is empty.
+     */
+    fun getBounds(result: RectF) {
+        internalPathMeasureBounds(internalPathMeasure, bounds)
+        result.set(bounds[0], bounds[1], bounds[2], bounds[3])
+    }
+
+    /**
+     * Computes the position and unit tangent at [distance] along the specified [contour]
+     * and stores them in [result], starting at [offset], as 4 floats: x, y, tangent x and
+     * tangent y. The distance is clamped to the length of the contour.
+     *
+     * Returns false if the contour has a length of 0, in which case the position is set to
+     * the first point of the contour and the tangent is not meaningful.
+     */
+    @JvmOverloads
+    fun getPositionAndTangent(
+        contour: Int,
+        distance: Float,
+        result: FloatArray,
+        offset: Int = 0
+    ): Boolean {
+        checkContour(contour)
+        require(offset >= 0 && offset + 4 <= result.size) {
+            "The result array must hold 4 floats starting at offset $offset"
+        }
+        return internalPathMeasurePosTan(internalPathMeasure, contour, distance, result, offset)
+    }
+
+    /**
+     * Writes the polyline between the distances [start] and [end] along the specified
+     * [contour] into [points], as pairs of floats (x, y), and returns the number of points
+     * of that polyline. The distances are clamped to the length of the contour.
+     *
+     * If [points] is too small to hold the polyline, nothing is written and the returned
+     * value is the number of points required: callers can resize [points] and try again.
+     * Returns 0 if [start] is greater than [end].
+     */
+    fun getSegment(contour: Int, start: Float, end: Float, points: FloatArray): Int {
+        checkContour(contour)
+        return internalPathMeasureSegment(internalPathMeasure, contour, start, end, points)
+    }
+
+    private fun checkContour(contour: Int) {
+        if (contour < 0 || contour >= contourCount) {
+            throw IndexOutOfBoundsException(
+                "Contour $contour is out of bounds, the path has $contourCount contours"
+            )
+        }
+    }
+
+    protected fun finalize() {
+        destroyInternalPathMeasure(internalPathMeasure)
+    }
+}
+
+/**
+ * Measures this [path][android.graphics.Path] with the given [tolerance]. See
+ * [PathMeasure] for more information.
+ */
+fun Path.measure(tolerance: Float = 0.25f) = PathMeasure(tolerance).setPath(this)
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package androidx.graphics.path
+
+import android.graphics.Path
+
+/**
+ * The native path data is not accessible in API 34+. This buffer gathers the segments of
+ * a path from the platform iterator, using batched iteration, so they can be handed to
+ * native code in a single call. The storage grows on demand and is reused across calls.
+ *
+ * [verbs] holds one byte per segment (the ordinal of its [PathSegment.Type]) and [points]
+ * holds 8 floats per segment, in the layout produced by [PathIterator.next].
+ */
+internal class PathSegmentBuffer {
+    private var types = Array(64) { PathSegment.Type.Done }
+
+    var verbs = ByteArray(64)
+        private set
+
+    var points = FloatArray(64 * 8)
+        private set
+
+    /**
+     * Gathers the segments of [path], converting conics to quadratics with the given
+     * [tolerance], and returns the number of segments stored in [verbs] and [points].
+     */
+    fun gather(path: Path, tolerance: Float): Int {
+        val iterator = PathIterator(path, PathIterator.ConicEvaluation.AsQuadratics, tolerance)
+        var count = 0
+        while (true) {
+            if (count == verbs.size) {
+                val size = count * 2
+                types = Array(size) { PathSegment.Type.Done }
+                verbs = verbs.copyOf(size)
+                points = points.copyOf(size * 8)
+            }
+
+            val available = verbs.size - count
+            val written = iterator.next(types, points, count * 8, available)
+            for (i in 0 until written) {
+                verbs[count + i] = types[i].ordinal.toByte()
+            }
+            count += written
+            if (written < available) break
+        }
+        return count
+    }
+}
@@ -0,0 +1,178 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+@file:JvmName("PathSnapshotUtilities")
+package androidx.graphics.path
+
+import android.graphics.Path
+import android.os.Build
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+import java.nio.FloatBuffer
+
+/**
+ * A path snapshot gives direct access to the raw data of a [Path]: its verbs, points and
+ * conic weights, without iterating over the path one segment at a time.
+ *
+ * - [verbs] contains one byte per verb, in forward order. Each byte is the ordinal of the
+ *   corresponding [PathSegment.Type].
+ * - [points] contains pairs of floats (x, y). Unlike [PathIterator], the points shared by
+ *   consecutive segments are stored only once: a [Move][PathSegment.Type.Move] or
+ *   [Line][PathSegment.Type.Line] adds 1 point, a [Quadratic][PathSegment.Type.Quadratic] or
+ *   [Conic][PathSegment.Type.Conic] adds 2 points, a [Cubic][PathSegment.Type.Cubic] adds
+ *   3 points and a [Close][PathSegment.Type.Close] does not add any point.
+ * - [conicWeights] contains one weight per [Conic][PathSegment.Type.Conic] verb.
+ *
+ * On API levels below 34, the buffers are direct buffers that alias the memory of the path:
+ * the snapshot does not copy any point. The snapshot is therefore only valid until the next
+ * modification of the path, or until the path is garbage collected. On API 34+, the raw data
+ * is rebuilt into storage owned by the snapshot. Call [capture] again to refresh the snapshot;
+ * a snapshot can be reused for any number of paths to avoid allocating new storage.
+ */
+@Suppress("NotCloseable")
+class PathSnapshot {
+    private companion object {
+        init {
+            System.loadLibrary("androidx.graphics.path")
+        }
+    }
+
+    @Suppress("KotlinJniMissingFunction")
+    private external fun createInternalPathSnapshot(): Long
+
+    @Suppress("KotlinJniMissingFunction")
+    private external fun destroyInternalPathSnapshot(internalPathSnapshot: Long)
+
+    @Suppress("KotlinJniMissingFunction")
+    private external fun internalPathSnapshotCapture(internalPathSnapshot: Long, path: Path): Int
+
+    @Suppress("KotlinJniMissingFunction")
+    private external fun internalPathSnapshotVerbs(internalPathSnapshot: Long): ByteBuffer
+
+    @Suppress("KotlinJniMissingFunction")
+    private external fun internalPathSnapshotPoints(internalPathSnapshot: Long): ByteBuffer
+
+    @Suppress("KotlinJniMissingFunction")
+    private external fun internalPathSnapshotConicWeights(internalPathSnapshot: Long): ByteBuffer
+
+    private val internalPathSnapshot =
+        if (Build.VERSION.SDK_INT >= 34) 0L else createInternalPathSnapshot()
+
+    /**
+     * Number of verbs in the captured path.
+     */
+    var verbCount: Int = 0
+        private set
+
+    /**
+     * Verbs of the captured path, one byte per verb in forward order.
+     */
+    var verbs: ByteBuffer = ByteBuffer.allocateDirect(0)
+        private set
+
+    /**
+     * Points of the captured path, stored as pairs of floats.
+     */
+    var points: FloatBuffer = FloatBuffer.allocate(0)
+        private set
+
+    /**
+     * Conic weights of the captured path, one per conic verb.
+     */
+    var conicWeights: FloatBuffer = FloatBuffer.allocate(0)
+        private set
+
+    /**
+     * Captures the current content of [path] and returns this snapshot. Any buffer obtained
+     * from a previous capture must not be used anymore.
+     */
+    fun capture(path: Path): PathSnapshot {
+        if (internalPathSnapshot != 0L) {
+            verbCount = internalPathSnapshotCapture(internalPathSnapshot, path)
+            verbs = internalPathSnapshotVerbs(internalPathSnapshot)
+            points = internalPathSnapshotPoints(internalPathSnapshot)
+                .order(ByteOrder.nativeOrder())
+                .asFloatBuffer()
+            conicWeights = internalPathSnapshotConicWeights(internalPathSnapshot)
+                .order(ByteOrder.nativeOrder())
+                .asFloatBuffer()
+        } else {
+            captureFromIterator(path)
+        }
+        return this
+    }
+
+    /**
+     * Storage used to rebuild the raw path data from the platform iterator in API 34+,
+     * grown on demand and reused across captures.
+     */
+    private var verbData = ByteArray(0)
+    private var pointData = FloatArray(0)
+    private var weightData = FloatArray(0)
+
+    /**
+     * The platform does not expose the raw path data in API 34+, so we rebuild it from
+     * the platform iterator into heap buffers owned by this snapshot.
+     */
+    private fun captureFromIterator(path: Path) {
+        val iterator = PathIterator(path, PathIterator.ConicEvaluation.AsConic)
+        val data = FloatArray(8)
+        var verbIndex = 0
+        var pointIndex = 0
+        var weightIndex = 0
+
+        while (iterator.hasNext()) {
+            val type = iterator.next(data)
+            if (type == PathSegment.Type.Done) break
+
+            if (verbIndex == verbData.size) verbData = verbData.copyOf(verbIndex * 2 + 16)
+            if (pointIndex + 6 > pointData.size) pointData = pointData.copyOf(pointIndex * 2 + 32)
+            verbData[verbIndex++] = type.ordinal.toByte()
+
+            // Skip the first point of curves, it is the last point of the previous segment
+            val start = if (type == PathSegment.Type.Move) 0 else 2
+            val end = when (type) {
+                PathSegment.Type.Move -> 2
+                PathSegment.Type.Line -> 4
+                PathSegment.Type.Quadratic, PathSegment.Type.Conic -> 6
+                PathSegment.Type.Cubic -> 8
+                else -> start
+            }
+            data.copyInto(pointData, pointIndex, start, end)
+            pointIndex += end - start
+
+            if (type == PathSegment.Type.Conic) {
+                if (weightIndex == weightData.size) {
+                    weightData = weightData.copyOf(weightIndex * 2 + 4)
+                }
+                weightData[weightIndex++] = data[6]
+            }
+        }
+
+        verbCount = verbIndex
+        verbs = ByteBuffer.wrap(verbData, 0, verbIndex)
+        points = FloatBuffer.wrap(pointData, 0, pointIndex)
+        conicWeights = FloatBuffer.wrap(weightData, 0, weightIndex)
+    }
+
+    protected fun finalize() {
+        if (internalPathSnapshot != 0L) destroyInternalPathSnapshot(internalPathSnapshot)
+    }
+}
+
+/**
+ * Returns a new [PathSnapshot] holding the raw data of this [path][android.graphics.Path].
+ */
+fun Path.snapshot() = PathSnapshot().capture(this)
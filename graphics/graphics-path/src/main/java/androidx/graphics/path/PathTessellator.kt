@@ -0,0 +1,207 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package androidx.graphics.path
+
+import android.graphics.Paint
+import android.graphics.Path
+import android.opengl.GLES20
+import android.os.Build
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+import java.nio.FloatBuffer
+
+/**
+ * A path tessellator converts the fill or the stroke of a [Path] into triangles that can
+ * be uploaded as-is to the GPU, in native code. Curves are first approximated with line
+ * segments using the given [tolerance].
+ *
+ * The result is made of a vertex buffer, [vertices], containing [vertexCount] pairs of
+ * floats (x, y), and of an index buffer, [indices], containing 3 indices per triangle.
+ * The indices are 16-bit values when there are at most 65536 vertices, 32-bit values
+ * otherwise: [indexType] is the matching OpenGL type to pass to `glDrawElements`. Both
+ * buffers are direct buffers pointing to native memory owned by the tessellator: they are
+ * reused by the next call to [fill] or [stroke] and are only valid until then.
+ *
+ * Fills are tessellated as one triangle fan per contour. Those triangles overlap where
+ * contours are concave or self-intersecting: they are meant to be drawn into the stencil
+ * buffer, using the desired fill rule, before covering the bounds of the path. Convex
+ * contours can be drawn directly. Strokes are tessellated as one quad per line segment,
+ * plus triangles for joins and caps, which also overlap at the joins.
+ *
+ * @param tolerance Maximum distance between the curves and the line segments that
+ *                  approximate them. Default is 0.25f (sub-pixel).
+ */
+@Suppress("NotCloseable")
+class PathTessellator(val tolerance: Float = 0.25f) {
+    private companion object {
+        init {
+            System.loadLibrary("androidx.graphics.path")
+        }
+    }
+
+    @Suppress("KotlinJniMissingFunction")
+    private external fun createInternalPathTessellator(): Long
+
+    @Suppress("KotlinJniMissingFunction")
+    private external fun destroyInternalPathTessellator(internalPathTessellator: Long)
+
+    @Suppress("KotlinJniMissingFunction")
+    private external fun internalPathTessellatorFill(
+        internalPathTessellator: Long,
+        path: Path,
+        tolerance: Float
+    ): Long
+
+    @Suppress("KotlinJniMissingFunction")
+    private external fun internalPathTessellatorFillSegments(
+        internalPathTessellator: Long,
+        verbs: ByteArray,
+        segments: FloatArray,
+        count: Int,
+        tolerance: Float
+    ): Long
+
+    @Suppress("KotlinJniMissingFunction")
+    private external fun internalPathTessellatorStroke(
+        internalPathTessellator: Long,
+        path: Path,
+        tolerance: Float,
+        width: Float,
+        cap: Int,
+        join: Int,
+        miterLimit: Float
+    ): Long
+
+    @Suppress("KotlinJniMissingFunction")
+    private external fun internalPathTessellatorStrokeSegments(
+        internalPathTessellator: Long,
+        verbs: ByteArray,
+        segments: FloatArray,
+        count: Int,
+        tolerance: Float,
+        width: Float,
+        cap: Int,
+        join: Int,
+        miterLimit: Float
+    ): Long
+
+    @Suppress("KotlinJniMissingFunction")
+    private external fun internalPathTessellatorVertices(internalPathTessellator: Long): ByteBuffer
+
+    @Suppress("KotlinJniMissingFunction")
+    private external fun internalPathTessellatorIndices(internalPathTessellator: Long): ByteBuffer
+
+    private val internalPathTessellator = createInternalPathTessellator()
+
+    // Segments gathered from the platform iterator in API 34+, reused across calls
+    private val segments = PathSegmentBuffer()
+
+    /**
+     * Vertices of the triangles, stored as pairs of floats (x, y).
+     */
+    var vertices: FloatBuffer = FloatBuffer.allocate(0)
+        private set
+
+    /**
+     * Number of vertices stored in [vertices].
+     */
+    var vertexCount = 0
+        private set
+
+    /**
+     * Indices of the triangles, 3 per triangle, stored as values of type [indexType].
+     */
+    var indices: ByteBuffer = ByteBuffer.allocateDirect(0)
+        private set
+
+    /**
+     * Number of indices stored in [indices].
+     */
+    var indexCount = 0
+        private set
+
+    /**
+     * OpenGL type of the values stored in [indices], either
+     * [GL_UNSIGNED_SHORT][GLES20.GL_UNSIGNED_SHORT] or [GL_UNSIGNED_INT][GLES20.GL_UNSIGNED_INT].
+     */
+    val indexType: Int
+        get() = if (vertexCount <= 65536) GLES20.GL_UNSIGNED_SHORT else GLES20.GL_UNSIGNED_INT
+
+    /**
+     * Tessellates the fill of [path] and returns this tessellator, whose [vertices] and
+     * [indices] hold the result.
+     */
+    fun fill(path: Path): PathTessellator {
+        val counts = if (Build.VERSION.SDK_INT >= 34) {
+            val count = segments.gather(path, tolerance)
+            internalPathTessellatorFillSegments(
+                internalPathTessellator, segments.verbs, segments.points, count, tolerance
+            )
+        } else {
+            internalPathTessellatorFill(internalPathTessellator, path, tolerance)
+        }
+        return update(counts)
+    }
+
+    /**
+     * Tessellates the stroke of [path] and returns this tessellator, whose [vertices] and
+     * [indices] hold the result.
+     *
+     * @param width Width of the stroke, nothing is tessellated if the width is <= 0.
+     * @param cap Shape of the extremities of open contours.
+     * @param join Shape of the corners between consecutive segments.
+     * @param miterLimit Maximum ratio between the length of a miter join and [width], miter
+     *                   joins above that limit are drawn as bevel joins.
+     */
+    @JvmOverloads
+    fun stroke(
+        path: Path,
+        width: Float,
+        cap: Paint.Cap = Paint.Cap.BUTT,
+        join: Paint.Join = Paint.Join.MITER,
+        miterLimit: Float = 4.0f
+    ): PathTessellator {
+        val counts = if (Build.VERSION.SDK_INT >= 34) {
+            val count = segments.gather(path, tolerance)
+            internalPathTessellatorStrokeSegments(
+                internalPathTessellator, segments.verbs, segments.points, count, tolerance,
+                width, cap.ordinal, join.ordinal, miterLimit
+            )
+        } else {
+            internalPathTessellatorStroke(
+                internalPathTessellator, path, tolerance,
+                width, cap.ordinal, join.ordinal, miterLimit
+            )
+        }
+        return update(counts)
+    }
+
+    private fun update(counts: Long): PathTessellator {
+        vertexCount = (counts ushr 32).toInt()
+        indexCount = counts.toInt()
+        vertices = internalPathTessellatorVertices(internalPathTessellator)
+            .order(ByteOrder.nativeOrder())
+            .asFloatBuffer()
+        indices = internalPathTessellatorIndices(internalPathTessellator)
+            .order(ByteOrder.nativeOrder())
+        return this
+    }
+
+    protected fun finalize() {
+        destroyInternalPathTessellator(internalPathTessellator)
+    }
+}